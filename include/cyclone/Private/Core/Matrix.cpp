@@ -86,24 +86,6 @@ void Matrix::SetIdentity()
     }
 }
 
-Matrix Matrix::operator*(const Matrix& m) const
-{
-    Matrix Result;
-
-    for (auto k = 0; k < 4; ++k)
-    {
-        for (auto i = 0; i < 4; ++i)
-        {
-            for (auto j = 0; j < 4; ++j)
-            {
-                Result.M[i][k] += M[i][j] * m.M[j][k];
-            }
-        }
-    }
-
-    return Result;
-}
-
 void Matrix::operator*=(const Matrix& m)
 {
     *this = *this * m;
@@ -129,7 +111,7 @@ void Matrix::operator+=(const Matrix& m)
     *this = *this + m;
 }
 
-Matrix Matrix::operator*(const float scale)
+Matrix Matrix::operator*(const real scale) const
 {
     Matrix Result;
 
@@ -144,7 +126,7 @@ Matrix Matrix::operator*(const float scale)
     return Result;
 }
 
-void Matrix::operator*=(const float scale)
+void Matrix::operator*=(const real scale)
 {
     *this = *this * scale;
 }
@@ -170,50 +152,10 @@ bool Matrix::operator!=(const Matrix& m) const
     return !(*this == m);
 }
 
-Vector3 Matrix::operator*(const Vector3& v) const
-{
-    Vector3 Result;
-
-    for (auto k = 0; k < 3; ++k)
-    {
-        for (auto i = 0; i < 4; ++i)
-        {
-            for (auto j = 0; j < 4; ++j)
-            {
-                Result[k] += v[k] * M[i][j];
-            }
-        }
-    }
-
-    return Result;
-}
-
-Vector3 Matrix::TransformVector(const Vector3& v) const
-{
-    return Vector3(v.x * M[0][0] + v.y * M[0][1] + v.z * M[0][2],
-                   v.x * M[1][0] + v.y * M[1][1] + v.z * M[1][2],
-                   v.x * M[2][0] + v.y * M[2][1] + v.z * M[2][2]);
-}
-
-Vector3 Matrix::InverseTransformVector(const Vector3& v) const
-{
-    return Vector3(v.x * M[0][0] + v.y * M[1][0] + v.z * M[2][0],
-                   v.x * M[0][1] + v.y * M[1][1] + v.z * M[2][1],
-                   v.x * M[0][2] + v.y * M[1][2] + v.z * M[2][2]);
-}
-
-Vector3 Matrix::TransformPosition(const Vector3& v) const
-{
-    return Vector3(v.x * M[0][0] + v.y * M[0][1] + v.z * M[0][2] + M[0][3],
-                   v.x * M[1][0] + v.y * M[1][1] + v.z * M[1][2] + M[1][3],
-                   v.x * M[2][0] + v.y * M[2][1] + v.z * M[2][2] + M[2][3]);
-}
-
 Vector3 Matrix::InverseTransformPosition(const Vector3& v) const
 {
-    return Vector3(v.x * M[0][0] + v.y * M[1][0] + v.z * M[2][0] + M[3][0],
-                   v.x * M[0][1] + v.y * M[1][1] + v.z * M[2][1] + M[3][1],
-                   v.x * M[0][2] + v.y * M[1][2] + v.z * M[2][2] + M[3][2]);
+    // Remove the translation, then apply the transpose of the rotation.
+    return InverseTransformVector(Vector3(v.x - M[0][3], v.y - M[1][3], v.z - M[2][3]));
 }
 
 Matrix Matrix::Transposed() const
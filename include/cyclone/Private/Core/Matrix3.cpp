@@ -0,0 +1,194 @@
+#include "Core/Matrix3.h"
+
+using namespace cyclone;
+
+Matrix3::Matrix3(const Vector3& InX, const Vector3& InY, const Vector3& InZ)
+{
+    M[0][0] = InX.x;
+
+    M[0][1] = InX.y;
+
+    M[0][2] = InX.z;
+
+    M[1][0] = InY.x;
+
+    M[1][1] = InY.y;
+
+    M[1][2] = InY.z;
+
+    M[2][0] = InZ.x;
+
+    M[2][1] = InZ.y;
+
+    M[2][2] = InZ.z;
+}
+
+Matrix3::Matrix3(const real x0, const real x1, const real x2, const real y0, const real y1, const real y2,
+                 const real z0, const real z1, const real z2)
+{
+    M[0][0] = x0;
+
+    M[0][1] = x1;
+
+    M[0][2] = x2;
+
+    M[1][0] = y0;
+
+    M[1][1] = y1;
+
+    M[1][2] = y2;
+
+    M[2][0] = z0;
+
+    M[2][1] = z1;
+
+    M[2][2] = z2;
+}
+
+void Matrix3::SetIdentity()
+{
+    for (auto i = 0; i < 3; ++i)
+    {
+        for (auto j = 0; j < 3; ++j)
+        {
+            M[i][j] = i == j ? 1.f : 0.f;
+        }
+    }
+}
+
+void Matrix3::SetSkewSymmetric(const Vector3& v)
+{
+    M[0][0] = M[1][1] = M[2][2] = 0.f;
+
+    M[0][1] = -v.z;
+
+    M[0][2] = v.y;
+
+    M[1][0] = v.z;
+
+    M[1][2] = -v.x;
+
+    M[2][0] = -v.y;
+
+    M[2][1] = v.x;
+}
+
+Matrix3 Matrix3::operator*(const Matrix3& m) const
+{
+    Matrix3 Result;
+
+    for (auto i = 0; i < 3; ++i)
+    {
+        for (auto k = 0; k < 3; ++k)
+        {
+            Result.M[i][k] = M[i][0] * m.M[0][k] + M[i][1] * m.M[1][k] + M[i][2] * m.M[2][k];
+        }
+    }
+
+    return Result;
+}
+
+void Matrix3::operator*=(const Matrix3& m)
+{
+    *this = *this * m;
+}
+
+Matrix3 Matrix3::operator+(const Matrix3& m) const
+{
+    Matrix3 Result;
+
+    for (auto i = 0; i < 3; ++i)
+    {
+        for (auto j = 0; j < 3; ++j)
+        {
+            Result.M[i][j] = M[i][j] + m.M[i][j];
+        }
+    }
+
+    return Result;
+}
+
+void Matrix3::operator+=(const Matrix3& m)
+{
+    *this = *this + m;
+}
+
+Matrix3 Matrix3::operator*(const real scale) const
+{
+    Matrix3 Result;
+
+    for (auto i = 0; i < 3; ++i)
+    {
+        for (auto j = 0; j < 3; ++j)
+        {
+            Result.M[i][j] = M[i][j] * scale;
+        }
+    }
+
+    return Result;
+}
+
+void Matrix3::operator*=(const real scale)
+{
+    *this = *this * scale;
+}
+
+bool Matrix3::operator==(const Matrix3& m) const
+{
+    for (auto i = 0; i < 3; ++i)
+    {
+        for (auto j = 0; j < 3; ++j)
+        {
+            if (M[i][j] != m.M[i][j])
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+bool Matrix3::operator!=(const Matrix3& m) const
+{
+    return !(*this == m);
+}
+
+Matrix3 Matrix3::Transposed() const
+{
+    return Matrix3(M[0][0], M[1][0], M[2][0],
+                   M[0][1], M[1][1], M[2][1],
+                   M[0][2], M[1][2], M[2][2]);
+}
+
+real Matrix3::Determinant() const
+{
+    return M[0][0] * (M[1][1] * M[2][2] - M[1][2] * M[2][1]) -
+        M[0][1] * (M[1][0] * M[2][2] - M[1][2] * M[2][0]) +
+        M[0][2] * (M[1][0] * M[2][1] - M[1][1] * M[2][0]);
+}
+
+Matrix3 Matrix3::Inverse() const
+{
+    const auto Det = Determinant();
+
+    if (Det == 0.f)
+    {
+        return Matrix3(1.f, 0.f, 0.f,
+                       0.f, 1.f, 0.f,
+                       0.f, 0.f, 1.f);
+    }
+
+    const auto RDet = 1.f / Det;
+
+    // The inverse is the transpose of the cofactors over the determinant.
+    return Matrix3((M[1][1] * M[2][2] - M[1][2] * M[2][1]) * RDet,
+                   (M[0][2] * M[2][1] - M[0][1] * M[2][2]) * RDet,
+                   (M[0][1] * M[1][2] - M[0][2] * M[1][1]) * RDet,
+                   (M[1][2] * M[2][0] - M[1][0] * M[2][2]) * RDet,
+                   (M[0][0] * M[2][2] - M[0][2] * M[2][0]) * RDet,
+                   (M[0][2] * M[1][0] - M[0][0] * M[1][2]) * RDet,
+                   (M[1][0] * M[2][1] - M[1][1] * M[2][0]) * RDet,
+                   (M[0][1] * M[2][0] - M[0][0] * M[2][1]) * RDet,
+                   (M[0][0] * M[1][1] - M[0][1] * M[1][0]) * RDet);
+}
@@ -0,0 +1,146 @@
+#include "Core/Matrix3x4.h"
+
+using namespace cyclone;
+
+Matrix3x4::Matrix3x4()
+{
+    SetIdentity();
+}
+
+Matrix3x4::Matrix3x4(const real x0, const real x1, const real x2, const real x3, const real y0, const real y1,
+                     const real y2, const real y3, const real z0, const real z1, const real z2, const real z3)
+{
+    M[0][0] = x0;
+
+    M[0][1] = x1;
+
+    M[0][2] = x2;
+
+    M[0][3] = x3;
+
+    M[1][0] = y0;
+
+    M[1][1] = y1;
+
+    M[1][2] = y2;
+
+    M[1][3] = y3;
+
+    M[2][0] = z0;
+
+    M[2][1] = z1;
+
+    M[2][2] = z2;
+
+    M[2][3] = z3;
+}
+
+Matrix3x4::Matrix3x4(const Matrix3& rotation, const Vector3& translation)
+{
+    for (auto i = 0; i < 3; ++i)
+    {
+        for (auto j = 0; j < 3; ++j)
+        {
+            M[i][j] = rotation.M[i][j];
+        }
+
+        M[i][3] = translation[i];
+    }
+}
+
+void Matrix3x4::SetIdentity()
+{
+    for (auto i = 0; i < 3; ++i)
+    {
+        for (auto j = 0; j < 4; ++j)
+        {
+            M[i][j] = i == j ? 1.f : 0.f;
+        }
+    }
+}
+
+Matrix3x4 Matrix3x4::operator*(const Matrix3x4& m) const
+{
+    const auto m0 = simd::Load(m.M[0]);
+
+    const auto m1 = simd::Load(m.M[1]);
+
+    const auto m2 = simd::Load(m.M[2]);
+
+    Matrix3x4 Result;
+
+    // Each row of the result is the rows of the other matrix weighted by
+    // the same row of this one, plus this translation, as the other
+    // matrix's implicit last row is (0, 0, 0, 1).
+    for (auto i = 0; i < 3; ++i)
+    {
+        auto row = simd::Mul(simd::Splat(M[i][0]), m0);
+
+        row = simd::Add(row, simd::Mul(simd::Splat(M[i][1]), m1));
+
+        row = simd::Add(row, simd::Mul(simd::Splat(M[i][2]), m2));
+
+        simd::Store(Result.M[i], row);
+
+        Result.M[i][3] += M[i][3];
+    }
+
+    return Result;
+}
+
+void Matrix3x4::operator*=(const Matrix3x4& m)
+{
+    *this = *this * m;
+}
+
+bool Matrix3x4::operator==(const Matrix3x4& m) const
+{
+    for (auto i = 0; i < 3; ++i)
+    {
+        for (auto j = 0; j < 4; ++j)
+        {
+            if (M[i][j] != m.M[i][j])
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+bool Matrix3x4::operator!=(const Matrix3x4& m) const
+{
+    return !(*this == m);
+}
+
+Matrix3 Matrix3x4::GetRotation() const
+{
+    return Matrix3(M[0][0], M[0][1], M[0][2],
+                   M[1][0], M[1][1], M[1][2],
+                   M[2][0], M[2][1], M[2][2]);
+}
+
+Vector3 Matrix3x4::GetTranslation() const
+{
+    return Vector3(M[0][3], M[1][3], M[2][3]);
+}
+
+real Matrix3x4::Determinant() const
+{
+    return GetRotation().Determinant();
+}
+
+Matrix3x4 Matrix3x4::Inverse() const
+{
+    if (Determinant() == 0.f)
+    {
+        return Matrix3x4();
+    }
+
+    // Undo the rotation, then the translation expressed in the rotated
+    // frame.
+    const auto rotation = GetRotation().Inverse();
+
+    return Matrix3x4(rotation, -rotation.TransformVector(GetTranslation()));
+}
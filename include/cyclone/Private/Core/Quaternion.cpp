@@ -139,7 +139,7 @@ Quaternion Quaternion::operator/(const real scale) const
     return Quaternion(i * reciprocal, j * reciprocal, k * reciprocal, a * reciprocal);
 }
 
-bool Quaternion::operator=(const Quaternion& q) const
+bool Quaternion::operator==(const Quaternion& q) const
 {
     return i == q.i && j == q.j && k == q.k && a == q.a;
 }
@@ -220,13 +220,13 @@ Vector3 Quaternion::Euler() const
         const auto r13 = 2 * (i * k + a * j);
 
         return Vector3(RadiansToDegrees(0.f),
-                       RadiansToDegrees(-(R_PI / 2) * r31 / fabs(r31)),
-                       RadiansToDegrees(atan2(-r12, -r31 * r13)));
+                       RadiansToDegrees(-(R_PI / 2) * r31 / real_abs(r31)),
+                       RadiansToDegrees(real_atan2(-r12, -r31 * r13)));
     }
 
-    return Vector3(RadiansToDegrees(atan2(r32, r33)),
-                   RadiansToDegrees(asin(-r31)),
-                   RadiansToDegrees(atan2(r21, r11)));
+    return Vector3(RadiansToDegrees(real_atan2(r32, r33)),
+                   RadiansToDegrees(real_asin(-r31)),
+                   RadiansToDegrees(real_atan2(r21, r11)));
 }
 
 void Quaternion::Normalize()
@@ -263,15 +263,6 @@ real Quaternion::SizeSquared() const
     return i * i + j * j + k * k + a * a;
 }
 
-Vector3 Quaternion::RotateVector(const Vector3& v) const
-{
-    const Vector3 q(i, j, k);
-
-    const auto t = 2.f * Vector3::CrossProduct(q, v);
-
-    return v + a * t + Vector3::CrossProduct(q, t);
-}
-
 Vector3 Quaternion::UnrotateVector(const Vector3& v) const
 {
     // Inverse
@@ -0,0 +1,56 @@
+#include "Core/TaskGraph.h"
+#include <cassert>
+#include "Core/ThreadPool.h"
+
+using namespace cyclone;
+
+TaskGraph::TaskGraph(): remainingSize(0)
+{
+}
+
+unsigned TaskGraph::AddTask(const Task& task, const std::initializer_list<unsigned> dependencies)
+{
+    const auto index = static_cast<unsigned>(nodes.size());
+
+    nodes.emplace_back();
+
+    auto& node = nodes.back();
+
+    node.task = task;
+
+    node.dependencyCount = static_cast<unsigned>(dependencies.size());
+
+    for (const auto dependency : dependencies)
+    {
+        assert(dependency < index);
+
+        nodes[dependency].successors.push_back(index);
+    }
+
+    return index;
+}
+
+void TaskGraph::Clear()
+{
+    nodes.clear();
+}
+
+unsigned TaskGraph::GetTaskCount() const
+{
+    return static_cast<unsigned>(nodes.size());
+}
+
+void TaskGraph::Run(ThreadPool* threadPool)
+{
+    if (threadPool != nullptr && threadPool->GetThreadCount() > 1)
+    {
+        threadPool->Run(*this);
+
+        return;
+    }
+
+    for (const auto& node : nodes)
+    {
+        node.task();
+    }
+}
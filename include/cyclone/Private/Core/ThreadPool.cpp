@@ -0,0 +1,323 @@
+#include "Core/ThreadPool.h"
+#include "Core/TaskGraph.h"
+
+using namespace cyclone;
+
+namespace
+{
+    /**
+    * The pool the calling thread works for, if any, and its queue.
+    */
+    thread_local const ThreadPool* workerPool = nullptr;
+
+    thread_local unsigned workerQueue = 0;
+}
+
+ThreadPool::ThreadPool(const unsigned threadCount): queuedJobs(0), bStopping(false)
+{
+    auto threads = threadCount;
+
+    if (threads == 0)
+    {
+        threads = std::thread::hardware_concurrency();
+    }
+
+    if (threads == 0)
+    {
+        threads = 1;
+    }
+
+    for (auto i = 0u; i < threads; ++i)
+    {
+        queues.emplace_back(new JobQueue());
+    }
+
+    // The calling thread is one of the threads, so it needs no worker.
+    for (auto i = 1u; i < threads; ++i)
+    {
+        workers.emplace_back(&ThreadPool::WorkerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+
+        bStopping = true;
+    }
+
+    wakeCondition.notify_all();
+
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+}
+
+unsigned ThreadPool::GetThreadCount() const
+{
+    return static_cast<unsigned>(workers.size()) + 1;
+}
+
+void ThreadPool::ParallelFor(const unsigned count, const Task& task, const unsigned grainSize)
+{
+    const auto grain = grainSize > 0 ? grainSize : 1;
+
+    // Not worth waking anyone for.
+    if (workers.empty() || count <= grain)
+    {
+        for (auto i = 0u; i < count; ++i)
+        {
+            task(i);
+        }
+
+        return;
+    }
+
+    std::atomic<unsigned> pending(1);
+
+    Job job;
+
+    job.function = &ThreadPool::RunRange;
+
+    job.context = const_cast<Task*>(&task);
+
+    job.begin = 0;
+
+    job.end = count;
+
+    job.grainSize = grain;
+
+    job.pending = &pending;
+
+    Execute(job);
+
+    WaitFor(pending);
+}
+
+void ThreadPool::Run(TaskGraph& graph)
+{
+    const auto count = graph.GetTaskCount();
+
+    if (count == 0)
+    {
+        return;
+    }
+
+    if (graph.remainingSize < count)
+    {
+        graph.remaining.reset(new std::atomic<unsigned>[count]);
+
+        graph.remainingSize = count;
+    }
+
+    for (auto i = 0u; i < count; ++i)
+    {
+        graph.remaining[i] = graph.nodes[i].dependencyCount;
+    }
+
+    std::atomic<unsigned> pending(count);
+
+    Job job;
+
+    job.function = &ThreadPool::RunGraphTask;
+
+    job.context = &graph;
+
+    job.grainSize = 1;
+
+    job.pending = &pending;
+
+    // Queue the tasks that can start straight away, last first, so this
+    // thread takes them in the order they were added.
+    for (auto i = count; i-- > 0;)
+    {
+        if (graph.nodes[i].dependencyCount == 0)
+        {
+            job.begin = i;
+
+            job.end = i + 1;
+
+            Push(job);
+        }
+    }
+
+    WaitFor(pending);
+}
+
+void ThreadPool::Push(const Job& job)
+{
+    // Counted before it is queued, so a thread taking it never sees the
+    // count go below zero.
+    ++queuedJobs;
+
+    auto& queue = *queues[GetQueueIndex()];
+
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+
+        queue.jobs.push_back(job);
+    }
+
+    // Taking the lock makes sure a worker checking for jobs is either
+    // about to see this one or already waiting to be woken.
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+    }
+
+    wakeCondition.notify_one();
+}
+
+bool ThreadPool::Pop(Job& job)
+{
+    const auto queueCount = static_cast<unsigned>(queues.size());
+
+    const auto own = GetQueueIndex();
+
+    for (auto i = 0u; i < queueCount; ++i)
+    {
+        auto& queue = *queues[(own + i) % queueCount];
+
+        std::lock_guard<std::mutex> lock(queue.mutex);
+
+        if (queue.jobs.empty())
+        {
+            continue;
+        }
+
+        // The newest of our own jobs is the most likely to still be in
+        // the cache, while the oldest of another's is the biggest.
+        if (i == 0)
+        {
+            job = queue.jobs.back();
+
+            queue.jobs.pop_back();
+        }
+        else
+        {
+            job = queue.jobs.front();
+
+            queue.jobs.pop_front();
+        }
+
+        --queuedJobs;
+
+        return true;
+    }
+
+    return false;
+}
+
+void ThreadPool::Execute(const Job& job)
+{
+    job.function(*this, job);
+
+    job.pending->fetch_sub(1, std::memory_order_acq_rel);
+}
+
+void ThreadPool::WaitFor(const std::atomic<unsigned>& pending)
+{
+    while (pending.load(std::memory_order_acquire) != 0)
+    {
+        Job job;
+
+        if (Pop(job))
+        {
+            Execute(job);
+        }
+        else
+        {
+            // The last jobs are running on other threads.
+            std::this_thread::yield();
+        }
+    }
+}
+
+unsigned ThreadPool::GetQueueIndex() const
+{
+    return workerPool == this ? workerQueue : 0;
+}
+
+void ThreadPool::WorkerLoop(const unsigned queueIndex)
+{
+    workerPool = this;
+
+    workerQueue = queueIndex;
+
+    while (true)
+    {
+        Job job;
+
+        if (Pop(job))
+        {
+            Execute(job);
+
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+
+        wakeCondition.wait(lock, [this] { return bStopping || queuedJobs > 0; });
+
+        if (bStopping)
+        {
+            return;
+        }
+    }
+}
+
+void ThreadPool::RunRange(ThreadPool& pool, const Job& job)
+{
+    auto end = job.end;
+
+    // Leave the upper half for another thread until the range is small
+    // enough to run here. The job is still pending while the halves are
+    // queued, so the loop can't be seen as finished too early.
+    while (end - job.begin > job.grainSize)
+    {
+        const auto middle = job.begin + (end - job.begin) / 2;
+
+        auto half = job;
+
+        half.begin = middle;
+
+        half.end = end;
+
+        job.pending->fetch_add(1, std::memory_order_relaxed);
+
+        pool.Push(half);
+
+        end = middle;
+    }
+
+    const auto& task = *static_cast<const Task*>(job.context);
+
+    for (auto i = job.begin; i < end; ++i)
+    {
+        task(i);
+    }
+}
+
+void ThreadPool::RunGraphTask(ThreadPool& pool, const Job& job)
+{
+    auto& graph = *static_cast<TaskGraph*>(job.context);
+
+    const auto& node = graph.nodes[job.begin];
+
+    node.task();
+
+    for (const auto successor : node.successors)
+    {
+        if (graph.remaining[successor].fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            auto next = job;
+
+            next.begin = successor;
+
+            next.end = successor + 1;
+
+            pool.Push(next);
+        }
+    }
+}
@@ -14,58 +14,10 @@ const Vector3 Vector3::Right = Vector3(1.f, 0.f, 0.f);
 
 const Vector3 Vector3::Gravity = Vector3(0.f, -9.81f, 0.f);
 
-Vector3::Vector3(): x(0.f), y(0.f), z(0.f), pad(0.f)
-{
-}
-
-Vector3::Vector3(const real v) : x(v), y(v), z(v), pad(0.f)
-{
-}
-
-Vector3::Vector3(const real x, const real y, const real z) : x(x), y(y), z(z), pad(0.f)
-{
-}
-
 Vector3::Vector3(const Vector4& v): x(v.x), y(v.y), z(v.z), pad(0.f)
 {
 }
 
-Vector3::Vector3(const Vector3& v): x(v.x), y(v.y), z(v.z), pad(0.f)
-{
-}
-
-Vector3 Vector3::operator^(const Vector3& v) const
-{
-    return Vector3(y * v.z - z * v.y,
-                   z * v.x - x * v.z,
-                   x * v.y - y * v.x);
-}
-
-Vector3 Vector3::CrossProduct(const Vector3& a, const Vector3& b)
-{
-    return a ^ b;
-}
-
-real Vector3::operator|(const Vector3& v) const
-{
-    return x * v.x + y * v.y + z * v.z;
-}
-
-real Vector3::DotProduct(const Vector3& a, const Vector3& b)
-{
-    return a | b;
-}
-
-Vector3 Vector3::operator+(const Vector3& v) const
-{
-    return Vector3(x + v.x, y + v.y, z + v.z);
-}
-
-Vector3 Vector3::operator-(const Vector3& v) const
-{
-    return Vector3(x - v.x, y - v.y, z - v.z);
-}
-
 Vector3 Vector3::operator+(const real bias) const
 {
     return Vector3(x + bias, y + bias, z + bias);
@@ -76,21 +28,11 @@ Vector3 Vector3::operator-(const real bias) const
     return Vector3(x - bias, y - bias, z - bias);
 }
 
-Vector3 Vector3::operator*(const real scale) const
-{
-    return Vector3(x * scale, y * scale, z * scale);
-}
-
 Vector3 Vector3::operator/(const real scale) const
 {
     return Vector3(x / scale, y / scale, z / scale);
 }
 
-Vector3 Vector3::operator*(const Vector3& v) const
-{
-    return Vector3(x * v.x, y * v.y, z * v.z);
-}
-
 Vector3 Vector3::operator/(const Vector3& v) const
 {
     return Vector3(x / v.x, y / v.y, z / v.z);
@@ -106,38 +48,6 @@ bool Vector3::operator!=(const Vector3& v) const
     return x != v.x || y != v.y || z != v.z;
 }
 
-Vector3 Vector3::operator-() const
-{
-    return Vector3(-x, -y, -z);
-}
-
-void Vector3::operator+=(const Vector3& v)
-{
-    x += v.x;
-
-    y += v.y;
-
-    z += v.z;
-}
-
-void Vector3::operator-=(const Vector3& v)
-{
-    x -= v.x;
-
-    y -= v.y;
-
-    z -= v.z;
-}
-
-void Vector3::operator*=(const real scale)
-{
-    x *= scale;
-
-    y *= scale;
-
-    z *= scale;
-}
-
 void Vector3::operator/=(const real scale)
 {
     x /= scale;
@@ -184,11 +94,6 @@ real Vector3::Size() const
     return real_sqrt(x * x + y * y + z * z);
 }
 
-real Vector3::SizeSquared() const
-{
-    return x * x + y * y + z * z;
-}
-
 void Vector3::Normalize()
 {
     const auto l = Size();
@@ -243,8 +148,3 @@ real Vector3::Triple(const Vector3& a, const Vector3& b, const Vector3& c)
         + a.y * (b.z * c.x - b.x * c.z)
         + a.z * (b.x * c.y - b.y * c.x);
 }
-
-Vector3 cyclone::operator*(const real s, const Vector3& u)
-{
-    return Vector3(u.x * s, u.y * s, u.z * s);
-}
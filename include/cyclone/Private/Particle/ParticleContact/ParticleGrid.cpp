@@ -0,0 +1,224 @@
+#include "Particle/ParticleContact/ParticleGrid.h"
+#include <cmath>
+
+using namespace cyclone;
+
+ParticleGrid::ParticleGrid(): particles(nullptr), radius(0.f), cellSize(1.f), restitution(0.2f), bGround(false),
+    bucketMask(0)
+{
+}
+
+void ParticleGrid::Init(Particles* particles, const real radius, const real cellSize, const real restitution,
+                        const bool bGround)
+{
+    ParticleGrid::particles = particles;
+
+    ParticleGrid::radius = radius;
+
+    // Smaller cells would let contacts fall outside the neighbouring cells.
+    ParticleGrid::cellSize = cellSize > 2.f * radius ? cellSize : 2.f * radius;
+
+    ParticleGrid::restitution = restitution;
+
+    ParticleGrid::bGround = bGround;
+}
+
+void ParticleGrid::Rebuild()
+{
+    if (particles == nullptr)
+    {
+        return;
+    }
+
+    const auto count = static_cast<unsigned>(particles->size());
+
+    // Keep the table at least twice as big as the particle count, so most
+    // buckets hold a single cell.
+    auto buckets = 1u;
+
+    while (buckets < 2 * count)
+    {
+        buckets <<= 1;
+    }
+
+    bucketMask = buckets - 1;
+
+    bucketStart.assign(buckets + 1, 0);
+
+    particleBuckets.resize(count);
+
+    // Count the particles in each bucket.
+    for (auto i = 0u; i < count; ++i)
+    {
+        const auto position = (*particles)[i]->GetPosition();
+
+        const auto bucket = GetBucket(GetCell(position.x), GetCell(position.y), GetCell(position.z));
+
+        particleBuckets[i] = bucket;
+
+        ++bucketStart[bucket + 1];
+    }
+
+    // Turn the counts into the start of each bucket.
+    for (auto bucket = 0u; bucket < buckets; ++bucket)
+    {
+        bucketStart[bucket + 1] += bucketStart[bucket];
+    }
+
+    // Scatter the particles into their buckets, using the end of each
+    // bucket as a cursor that walks back to its start.
+    sortedParticles.resize(count);
+
+    sortedPositions.resize(count);
+
+    for (auto i = count; i-- > 0;)
+    {
+        const auto slot = --bucketStart[particleBuckets[i] + 1];
+
+        sortedParticles[slot] = i;
+
+        sortedPositions[slot] = (*particles)[i]->GetPosition();
+    }
+
+    // The cursors now hold the starts, shifted by one bucket.
+    for (auto bucket = 0u; bucket < buckets; ++bucket)
+    {
+        bucketStart[bucket] = bucketStart[bucket + 1];
+    }
+
+    bucketStart[buckets] = count;
+}
+
+unsigned ParticleGrid::AddContact(ParticleContact* contact, const unsigned limit) const
+{
+    if (contact == nullptr || particles == nullptr || limit == 0)
+    {
+        return 0;
+    }
+
+    const auto count = static_cast<unsigned>(sortedParticles.size());
+
+    const auto diameter = 2.f * radius;
+
+    auto used = 0u;
+
+    for (auto one = 0u; one < count; ++one)
+    {
+        const auto& position = sortedPositions[one];
+
+        auto particle = (*particles)[sortedParticles[one]];
+
+        if (bGround && position.y < radius)
+        {
+            contact->contactNormal = Vector3::Up;
+
+            contact->particle[0] = particle;
+
+            contact->particle[1] = nullptr;
+
+            contact->penetration = radius - position.y;
+
+            contact->restitution = restitution;
+
+            ++contact;
+
+            if (++used >= limit)
+            {
+                return used;
+            }
+        }
+
+        const auto x = GetCell(position.x);
+
+        const auto y = GetCell(position.y);
+
+        const auto z = GetCell(position.z);
+
+        // Gather the buckets of the neighbouring cells, skipping the ones
+        // that hash to a bucket we already have.
+        unsigned neighbours[27];
+
+        auto neighbourCount = 0u;
+
+        for (auto dx = -1; dx <= 1; ++dx)
+        {
+            for (auto dy = -1; dy <= 1; ++dy)
+            {
+                for (auto dz = -1; dz <= 1; ++dz)
+                {
+                    const auto bucket = GetBucket(x + dx, y + dy, z + dz);
+
+                    auto found = false;
+
+                    for (auto i = 0u; i < neighbourCount && !found; ++i)
+                    {
+                        found = neighbours[i] == bucket;
+                    }
+
+                    if (!found)
+                    {
+                        neighbours[neighbourCount++] = bucket;
+                    }
+                }
+            }
+        }
+
+        for (auto i = 0u; i < neighbourCount; ++i)
+        {
+            const auto end = bucketStart[neighbours[i] + 1];
+
+            // Each pair is only reported by its first particle.
+            for (auto other = bucketStart[neighbours[i]]; other < end; ++other)
+            {
+                if (other <= one)
+                {
+                    continue;
+                }
+
+                const auto offset = position - sortedPositions[other];
+
+                const auto distanceSquared = offset.SizeSquared();
+
+                if (distanceSquared >= diameter * diameter)
+                {
+                    continue;
+                }
+
+                const auto distance = real_sqrt(distanceSquared);
+
+                contact->contactNormal = distance > 0.f ? offset * (1.f / distance) : Vector3::Up;
+
+                contact->particle[0] = particle;
+
+                contact->particle[1] = (*particles)[sortedParticles[other]];
+
+                contact->penetration = diameter - distance;
+
+                contact->restitution = restitution;
+
+                ++contact;
+
+                if (++used >= limit)
+                {
+                    return used;
+                }
+            }
+        }
+    }
+
+    return used;
+}
+
+unsigned ParticleGrid::GetBucket(const int x, const int y, const int z) const
+{
+    // Mix the cell coordinates with large primes.
+    const auto hash = static_cast<unsigned>(x) * 73856093u ^ static_cast<unsigned>(y) * 19349663u ^
+        static_cast<unsigned>(z) * 83492791u;
+
+    return hash & bucketMask;
+}
+
+int ParticleGrid::GetCell(const real value) const
+{
+    return static_cast<int>(std::floor(value / cellSize));
+}
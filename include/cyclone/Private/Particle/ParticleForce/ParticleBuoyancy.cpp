@@ -10,15 +10,27 @@ ParticleBuoyancy::ParticleBuoyancy(const real maxDepth, const real volume, const
 
 void ParticleBuoyancy::UpdateForce(Particle* particle, const real deltaTime)
 {
-    if (particle != nullptr)
+    ParticleBuoyancy::UpdateForces(&particle, 1, deltaTime);
+}
+
+void ParticleBuoyancy::UpdateForces(Particle* const* particles, const unsigned count, const real deltaTime)
+{
+    for (auto i = 0u; i < count; ++i)
     {
+        const auto particle = particles[i];
+
+        if (particle == nullptr)
+        {
+            continue;
+        }
+
         // Calculate the submersion depth
         const auto depth = particle->GetPosition().y;
 
         // Check if we're out of the water
         if (depth >= waterHeight + maxDepth)
         {
-            return;
+            continue;
         }
 
         Vector3 force;
@@ -30,7 +42,7 @@ void ParticleBuoyancy::UpdateForce(Particle* particle, const real deltaTime)
 
             particle->AddForce(force);
 
-            return;
+            continue;
         }
 
         // Otherwise we are partly submerged
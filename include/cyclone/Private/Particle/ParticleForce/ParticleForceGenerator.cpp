@@ -0,0 +1,11 @@
+#include "Particle/ParticleForce/ParticleForceGenerator.h"
+
+using namespace cyclone;
+
+void ParticleForceGenerator::UpdateForces(Particle* const* particles, const unsigned count, const real deltaTime)
+{
+    for (auto i = 0u; i < count; ++i)
+    {
+        UpdateForce(particles[i], deltaTime);
+    }
+}
@@ -1,37 +1,272 @@
 #include "Particle/ParticleForce/ParticleForceRegistry.h"
+#include <algorithm>
 
 using namespace cyclone;
 
-void ParticleForceRegistry::Add(Particle* particle, ParticleForceGenerator* forceGenerator)
+constexpr ParticleForceRegistry::Handle ParticleForceRegistry::InvalidHandle;
+
+constexpr unsigned ParticleForceRegistry::InvalidIndex;
+
+ParticleForceRegistry::ParticleForceRegistry()
+{
+}
+
+ParticleForceRegistry::Handle ParticleForceRegistry::Add(Particle* particle, ParticleForceGenerator* forceGenerator)
 {
+    unsigned slot;
+
+    if (freeSlots.empty())
+    {
+        slot = static_cast<unsigned>(slots.size());
+
+        slots.push_back({ InvalidIndex, 0 });
+    }
+    else
+    {
+        slot = freeSlots.back();
+
+        freeSlots.pop_back();
+    }
+
+    slots[slot].index = static_cast<unsigned>(registrations.size());
+
+    const auto handle = static_cast<Handle>(slots[slot].generation) << 32 | slot;
+
     registrations.emplace_back(particle, forceGenerator);
+
+    handles.push_back(handle);
+
+    AddToBatch(slots[slot].index);
+
+    return handle;
+}
+
+void ParticleForceRegistry::Remove(const Handle handle)
+{
+    const auto slot = static_cast<unsigned>(handle);
+
+    // A handle whose slot has been freed since, and perhaps handed out
+    // again, carries an older generation than the slot.
+    if (slot >= slots.size() || slots[slot].generation != static_cast<unsigned>(handle >> 32) ||
+        slots[slot].index == InvalidIndex)
+    {
+        return;
+    }
+
+    RemoveAt(slots[slot].index);
 }
 
 void ParticleForceRegistry::Remove(Particle* particle, ParticleForceGenerator* forceGenerator)
 {
-    for (auto registry = registrations.begin(); registry != registrations.end(); ++registry)
+    const auto count = static_cast<unsigned>(registrations.size());
+
+    for (auto i = 0u; i < count; ++i)
     {
-        if (registry->particle == particle && registry->forceGenerator == forceGenerator)
+        if (registrations[i].particle == particle && registrations[i].forceGenerator == forceGenerator)
         {
-            registrations.erase(registry);
+            RemoveAt(i);
 
             break;
         }
     }
 }
 
+void ParticleForceRegistry::RemoveAllFor(const Particle* particle)
+{
+    // Walking backwards, the registration moved into a removed one's
+    // place has always been checked already.
+    for (auto i = static_cast<unsigned>(registrations.size()); i-- > 0;)
+    {
+        if (registrations[i].particle == particle)
+        {
+            RemoveAt(i);
+        }
+    }
+}
+
 void ParticleForceRegistry::Clear()
 {
+    // The slots are kept, so the handles handed out so far can't
+    // identify the registrations made after this.
+    for (const auto handle : handles)
+    {
+        FreeSlot(handle);
+    }
+
     registrations.clear();
+
+    handles.clear();
+
+    batches.clear();
+
+    batchIndices.clear();
+}
+
+void ParticleForceRegistry::UpdateForces(const real deltaTime, ThreadPool* threadPool)
+{
+    for (const auto& batch : batches)
+    {
+        const auto particles = batch.particles.data();
+
+        const auto count = static_cast<unsigned>(batch.particles.size());
+
+        if (threadPool == nullptr || batch.repeats > 0 || count <= ParticlesPerJob)
+        {
+            batch.forceGenerator->UpdateForces(particles, count, deltaTime);
+
+            continue;
+        }
+
+        const auto jobCount = (count + ParticlesPerJob - 1) / ParticlesPerJob;
+
+        threadPool->ParallelFor(jobCount, [&batch, particles, count, deltaTime](const unsigned job)
+        {
+            const auto first = job * ParticlesPerJob;
+
+            batch.forceGenerator->UpdateForces(particles + first, std::min(first + ParticlesPerJob, count) - first,
+                                               deltaTime);
+        });
+    }
+}
+
+void ParticleForceRegistry::RemoveAt(const unsigned index)
+{
+    const auto handle = handles[index];
+
+    RemoveFromBatch(index);
+
+    const auto last = static_cast<unsigned>(registrations.size()) - 1;
+
+    if (index != last)
+    {
+        registrations[index] = registrations[last];
+
+        handles[index] = handles[last];
+
+        slots[static_cast<unsigned>(handles[index])].index = index;
+
+        const auto& moved = registrations[index];
+
+        if (moved.batch != InvalidIndex)
+        {
+            batches[moved.batch].registrations[moved.member] = index;
+        }
+    }
+
+    registrations.pop_back();
+
+    handles.pop_back();
+
+    FreeSlot(handle);
+}
+
+void ParticleForceRegistry::FreeSlot(const Handle handle)
+{
+    const auto slot = static_cast<unsigned>(handle);
+
+    slots[slot].index = InvalidIndex;
+
+    ++slots[slot].generation;
+
+    freeSlots.push_back(slot);
+}
+
+void ParticleForceRegistry::AddToBatch(const unsigned index)
+{
+    auto& registration = registrations[index];
+
+    if (registration.forceGenerator == nullptr)
+    {
+        registration.batch = InvalidIndex;
+
+        return;
+    }
+
+    const auto found = batchIndices.emplace(registration.forceGenerator, static_cast<unsigned>(batches.size()));
+
+    if (found.second)
+    {
+        batches.emplace_back();
+
+        batches.back().forceGenerator = registration.forceGenerator;
+
+        batches.back().repeats = 0;
+    }
+
+    auto& batch = batches[found.first->second];
+
+    registration.batch = found.first->second;
+
+    registration.member = static_cast<unsigned>(batch.particles.size());
+
+    batch.particles.push_back(registration.particle);
+
+    batch.registrations.push_back(index);
+
+    if (++batch.counts[registration.particle] == 2)
+    {
+        ++batch.repeats;
+    }
 }
 
-void ParticleForceRegistry::UpdateForces(const real deltaTime)
+void ParticleForceRegistry::RemoveFromBatch(const unsigned index)
 {
-    for (const auto& registry : registrations)
+    const auto& registration = registrations[index];
+
+    if (registration.batch == InvalidIndex)
+    {
+        return;
+    }
+
+    auto& batch = batches[registration.batch];
+
+    const auto count = batch.counts.find(registration.particle);
+
+    if (--count->second == 1)
+    {
+        --batch.repeats;
+    }
+    else if (count->second == 0)
+    {
+        batch.counts.erase(count);
+    }
+
+    const auto last = static_cast<unsigned>(batch.particles.size()) - 1;
+
+    if (registration.member != last)
     {
-        if (registry.forceGenerator != nullptr)
+        batch.particles[registration.member] = batch.particles[last];
+
+        batch.registrations[registration.member] = batch.registrations[last];
+
+        registrations[batch.registrations[last]].member = registration.member;
+    }
+
+    batch.particles.pop_back();
+
+    batch.registrations.pop_back();
+
+    if (!batch.particles.empty())
+    {
+        return;
+    }
+
+    // The last batch takes the place of the empty one.
+    batchIndices.erase(batch.forceGenerator);
+
+    const auto lastBatch = static_cast<unsigned>(batches.size()) - 1;
+
+    if (registration.batch != lastBatch)
+    {
+        batches[registration.batch] = std::move(batches[lastBatch]);
+
+        batchIndices[batches[registration.batch].forceGenerator] = registration.batch;
+
+        for (const auto moved : batches[registration.batch].registrations)
         {
-            registry.forceGenerator->UpdateForce(registry.particle, deltaTime);
+            registrations[moved].batch = registration.batch;
         }
     }
+
+    batches.pop_back();
 }
@@ -8,12 +8,19 @@ ParticleGravity::ParticleGravity(const Vector3& gravity): gravity(gravity)
 
 void ParticleGravity::UpdateForce(Particle* particle, real deltaTime)
 {
-    if (particle != nullptr)
+    ParticleGravity::UpdateForces(&particle, 1, deltaTime);
+}
+
+void ParticleGravity::UpdateForces(Particle* const* particles, const unsigned count, const real deltaTime)
+{
+    for (auto i = 0u; i < count; ++i)
     {
+        const auto particle = particles[i];
+
         // Check that we do not have infinite mass
-        if (!particle->HasFiniteMass())
+        if (particle == nullptr || !particle->HasFiniteMass())
         {
-            return;
+            continue;
         }
 
         // Apply the mass-scaled force to the particle
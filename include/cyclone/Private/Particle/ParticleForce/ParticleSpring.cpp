@@ -9,14 +9,30 @@ ParticleSpring::ParticleSpring(Particle* other, const real springConstant, const
 
 void ParticleSpring::UpdateForce(Particle* particle, const real duration)
 {
-    if (particle != nullptr && other != nullptr)
+    ParticleSpring::UpdateForces(&particle, 1, duration);
+}
+
+void ParticleSpring::UpdateForces(Particle* const* particles, const unsigned count, const real duration)
+{
+    if (other == nullptr)
     {
-        // Calculate the vector of the spring
-        Vector3 force;
+        return;
+    }
 
-        particle->GetPosition(&force);
+    // The other end is the same for every particle.
+    const auto otherPosition = other->GetPosition();
 
-        force -= other->GetPosition();
+    for (auto i = 0u; i < count; ++i)
+    {
+        const auto particle = particles[i];
+
+        if (particle == nullptr)
+        {
+            continue;
+        }
+
+        // Calculate the vector of the spring
+        auto force = particle->GetPosition() - otherPosition;
 
         // Calculate the magnitude of the force
         auto magnitude = force.Size();
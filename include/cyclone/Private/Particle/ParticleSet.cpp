@@ -0,0 +1,185 @@
+#include "Particle/ParticleSet.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <initializer_list>
+
+using namespace cyclone;
+
+namespace
+{
+    /**
+    * Integrates one axis of a run of particles. Immovable particles have
+    * a moving factor of zero and a damping factor of one, which leaves
+    * them untouched without a branch in the loop.
+    */
+    void IntegrateAxis(real* __restrict position, real* __restrict velocity, real* __restrict force,
+                       const real* __restrict acceleration, const real* __restrict inverseMass,
+                       const real* __restrict moving, const real* __restrict dampingFactor, const unsigned count,
+                       const real deltaTime)
+    {
+        for (auto i = 0u; i < count; ++i)
+        {
+            // Update linear position.
+            position[i] += velocity[i] * deltaTime * moving[i];
+
+            // Work out the acceleration from the force
+            const auto resultingAcceleration = acceleration[i] + force[i] * inverseMass[i];
+
+            // Update linear velocity from the acceleration, and impose drag.
+            velocity[i] = (velocity[i] + resultingAcceleration * deltaTime * moving[i]) * dampingFactor[i];
+
+            // Clear the forces.
+            force[i] *= 1.f - moving[i];
+        }
+    }
+}
+
+unsigned ParticleSet::Add(const Particle& particle)
+{
+    const auto index = Size();
+
+    Resize(index + 1);
+
+    Load(index, particle);
+
+    return index;
+}
+
+void ParticleSet::Resize(const unsigned count)
+{
+    for (auto array : {
+             &positionX, &positionY, &positionZ, &velocityX, &velocityY, &velocityZ, &accelerationX, &accelerationY,
+             &accelerationZ, &forceX, &forceY, &forceZ, &inverseMass
+         })
+    {
+        array->resize(count, 0.f);
+    }
+
+    damping.resize(count, 1.f);
+}
+
+void ParticleSet::Clear()
+{
+    Resize(0);
+}
+
+unsigned ParticleSet::Size() const
+{
+    return static_cast<unsigned>(inverseMass.size());
+}
+
+void ParticleSet::Load(const unsigned index, const Particle& particle)
+{
+    positionX[index] = particle.position.x;
+
+    positionY[index] = particle.position.y;
+
+    positionZ[index] = particle.position.z;
+
+    velocityX[index] = particle.velocity.x;
+
+    velocityY[index] = particle.velocity.y;
+
+    velocityZ[index] = particle.velocity.z;
+
+    accelerationX[index] = particle.acceleration.x;
+
+    accelerationY[index] = particle.acceleration.y;
+
+    accelerationZ[index] = particle.acceleration.z;
+
+    forceX[index] = particle.accumulatedForce.x;
+
+    forceY[index] = particle.accumulatedForce.y;
+
+    forceZ[index] = particle.accumulatedForce.z;
+
+    inverseMass[index] = particle.inverseMass;
+
+    damping[index] = particle.damping;
+}
+
+void ParticleSet::Integrate(const real deltaTime, ThreadPool* threadPool)
+{
+    assert(deltaTime > 0.f);
+
+    const auto count = Size();
+
+    moving.resize(count);
+
+    dampingFactor.resize(count);
+
+    if (threadPool == nullptr)
+    {
+        IntegrateRange(0, count, deltaTime);
+
+        return;
+    }
+
+    const auto jobCount = (count + ParticlesPerJob - 1) / ParticlesPerJob;
+
+    threadPool->ParallelFor(jobCount, [this, count, deltaTime](const unsigned job)
+    {
+        const auto first = job * ParticlesPerJob;
+
+        IntegrateRange(first, std::min(first + ParticlesPerJob, count), deltaTime);
+    });
+}
+
+void ParticleSet::AddForce(const unsigned index, const Vector3& force)
+{
+    forceX[index] += force.x;
+
+    forceY[index] += force.y;
+
+    forceZ[index] += force.z;
+}
+
+void ParticleSet::ClearAccumulators()
+{
+    std::fill(forceX.begin(), forceX.end(), 0.f);
+
+    std::fill(forceY.begin(), forceY.end(), 0.f);
+
+    std::fill(forceZ.begin(), forceZ.end(), 0.f);
+}
+
+Vector3 ParticleSet::GetPosition(const unsigned index) const
+{
+    return Vector3(positionX[index], positionY[index], positionZ[index]);
+}
+
+Vector3 ParticleSet::GetVelocity(const unsigned index) const
+{
+    return Vector3(velocityX[index], velocityY[index], velocityZ[index]);
+}
+
+void ParticleSet::IntegrateRange(const unsigned first, const unsigned last, const real deltaTime)
+{
+    // The drag is the only part that can't be vectorized, so it is
+    // worked out for every particle before the main loops, along with
+    // whether the particle can move at all.
+    for (auto i = first; i < last; ++i)
+    {
+        const auto bMoving = inverseMass[i] > 0.f;
+
+        moving[i] = bMoving ? 1.f : 0.f;
+
+        dampingFactor[i] = bMoving ? real_pow(damping[i], deltaTime) : 1.f;
+    }
+
+    const auto count = last - first;
+
+    IntegrateAxis(positionX.data() + first, velocityX.data() + first, forceX.data() + first,
+                  accelerationX.data() + first, inverseMass.data() + first, moving.data() + first,
+                  dampingFactor.data() + first, count, deltaTime);
+
+    IntegrateAxis(positionY.data() + first, velocityY.data() + first, forceY.data() + first,
+                  accelerationY.data() + first, inverseMass.data() + first, moving.data() + first,
+                  dampingFactor.data() + first, count, deltaTime);
+
+    IntegrateAxis(positionZ.data() + first, velocityZ.data() + first, forceZ.data() + first,
+                  accelerationZ.data() + first, inverseMass.data() + first, moving.data() + first,
+                  dampingFactor.data() + first, count, deltaTime);
+}
@@ -6,7 +6,7 @@ ParticleWorld::ParticleWorld(const unsigned maxContacts, const unsigned iteratio
     bCalculateIterations(iterations == 0),
     resolver(iterations),
     contacts(new ParticleContact[maxContacts]),
-    maxContacts(maxContacts)
+    maxContacts(maxContacts), threadPool(nullptr)
 {
 }
 
@@ -20,12 +20,31 @@ ParticleWorld::~ParticleWorld()
     }
 }
 
+void ParticleWorld::SetThreadPool(ThreadPool* threadPool)
+{
+    ParticleWorld::threadPool = threadPool;
+}
+
 unsigned ParticleWorld::GenerateContacts()
 {
     auto limit = maxContacts;
 
     auto nextContact = contacts;
 
+    // Start with the particles colliding with each other
+    grid.Rebuild();
+
+    const auto gridContacts = grid.AddContact(nextContact, limit);
+
+    limit -= gridContacts;
+
+    nextContact += gridContacts;
+
+    if (limit == 0)
+    {
+        return maxContacts;
+    }
+
     for (const auto& contactGenerator : contactGenerators)
     {
         const auto used = contactGenerator->AddContact(nextContact, limit);
@@ -48,17 +67,26 @@ unsigned ParticleWorld::GenerateContacts()
 
 void ParticleWorld::Integrate(const real deltaTime)
 {
-    for (auto& particle : particles)
+    if (threadPool == nullptr)
     {
-        // Remove all forces from the accumulator
-        particle->Integrate(deltaTime);
+        for (auto& particle : particles)
+        {
+            particle->Integrate(deltaTime);
+        }
+
+        return;
     }
+
+    threadPool->ParallelFor(static_cast<unsigned>(particles.size()), [this, deltaTime](const unsigned i)
+    {
+        particles[i]->Integrate(deltaTime);
+    }, ParticlesPerJob);
 }
 
 void ParticleWorld::RunPhysics(const real deltaTime)
 {
     // First apply the force generators
-    registry.UpdateForces(deltaTime);
+    registry.UpdateForces(deltaTime, threadPool);
 
     // Then integrate the objects
     Integrate(deltaTime);
@@ -101,3 +129,8 @@ ParticleForceRegistry& ParticleWorld::GetForceRegistry()
 {
     return registry;
 }
+
+ParticleGrid& ParticleWorld::GetGrid()
+{
+    return grid;
+}
@@ -0,0 +1,16 @@
+#include "RigidBody/CoarseCollision/BVHNode.h"
+#include "RigidBody/CoarseCollision/BoundingBox.h"
+#include "RigidBody/CoarseCollision/BoundingSphere.h"
+
+using namespace cyclone;
+
+// The hierarchy is a template that nothing else in the library uses, so
+// it is instantiated here for both bounding volumes, and every build
+// checks that it still compiles.
+template class cyclone::BVHNode<BoundingSphere>;
+
+template class cyclone::BVHTree<BoundingSphere>;
+
+template class cyclone::BVHNode<BoundingBox>;
+
+template class cyclone::BVHTree<BoundingBox>;
@@ -0,0 +1,95 @@
+#include "RigidBody/CoarseCollision/BoundingBox.h"
+#include "RigidBody/FineCollision/CollisionBox.h"
+#include "RigidBody/FineCollision/CollisionSphere.h"
+#include <cmath>
+
+using namespace cyclone;
+
+BoundingBox::BoundingBox()
+{
+}
+
+BoundingBox::BoundingBox(const Vector3& minimum, const Vector3& maximum): minimum(minimum), maximum(maximum)
+{
+}
+
+BoundingBox::BoundingBox(const BoundingBox& one, const BoundingBox& another):
+    minimum(one.minimum.x < another.minimum.x ? one.minimum.x : another.minimum.x,
+            one.minimum.y < another.minimum.y ? one.minimum.y : another.minimum.y,
+            one.minimum.z < another.minimum.z ? one.minimum.z : another.minimum.z),
+    maximum(one.maximum.x > another.maximum.x ? one.maximum.x : another.maximum.x,
+            one.maximum.y > another.maximum.y ? one.maximum.y : another.maximum.y,
+            one.maximum.z > another.maximum.z ? one.maximum.z : another.maximum.z)
+{
+}
+
+BoundingBox BoundingBox::Enclosing(const CollisionBox& box)
+{
+    const auto& transform = box.GetTransform();
+
+    const auto centre = box.GetAxis(3);
+
+    // Project the half-sizes of the box onto each world axis.
+    const Vector3 extent(
+        real_abs(transform.M[0][0]) * box.halfSize.x + real_abs(transform.M[0][1]) * box.halfSize.y +
+        real_abs(transform.M[0][2]) * box.halfSize.z,
+        real_abs(transform.M[1][0]) * box.halfSize.x + real_abs(transform.M[1][1]) * box.halfSize.y +
+        real_abs(transform.M[1][2]) * box.halfSize.z,
+        real_abs(transform.M[2][0]) * box.halfSize.x + real_abs(transform.M[2][1]) * box.halfSize.y +
+        real_abs(transform.M[2][2]) * box.halfSize.z);
+
+    return BoundingBox(centre - extent, centre + extent);
+}
+
+BoundingBox BoundingBox::Enclosing(const CollisionSphere& sphere)
+{
+    const auto centre = sphere.GetAxis(3);
+
+    return BoundingBox(centre - sphere.radius, centre + sphere.radius);
+}
+
+bool BoundingBox::Overlaps(const BoundingBox& other) const
+{
+    return minimum.x <= other.maximum.x && maximum.x >= other.minimum.x &&
+        minimum.y <= other.maximum.y && maximum.y >= other.minimum.y &&
+        minimum.z <= other.maximum.z && maximum.z >= other.minimum.z;
+}
+
+bool BoundingBox::Contains(const BoundingBox& other) const
+{
+    return minimum.x <= other.minimum.x && maximum.x >= other.maximum.x &&
+        minimum.y <= other.minimum.y && maximum.y >= other.maximum.y &&
+        minimum.z <= other.minimum.z && maximum.z >= other.maximum.z;
+}
+
+real BoundingBox::GetGrowth(const BoundingBox& other) const
+{
+    const BoundingBox box(*this, other);
+
+    // We return a value proportional to the change in surface area of the box.
+    return box.GetSurfaceArea() - GetSurfaceArea();
+}
+
+real BoundingBox::Size() const
+{
+    const auto extent = maximum - minimum;
+
+    return extent.x * extent.y * extent.z;
+}
+
+real BoundingBox::GetSurfaceArea() const
+{
+    const auto extent = maximum - minimum;
+
+    return 2.f * (extent.x * extent.y + extent.y * extent.z + extent.z * extent.x);
+}
+
+BoundingBox BoundingBox::Expanded(const real margin) const
+{
+    return BoundingBox(minimum - margin, maximum + margin);
+}
+
+BoundingBox BoundingBox::Swept(const Vector3& displacement) const
+{
+    return BoundingBox(*this, BoundingBox(minimum + displacement, maximum + displacement));
+}
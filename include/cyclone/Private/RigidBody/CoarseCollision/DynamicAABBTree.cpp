@@ -0,0 +1,736 @@
+#include "RigidBody/CoarseCollision/DynamicAABBTree.h"
+#include "Core/Simd.h"
+#include "RigidBody/FineCollision/IntersectionTests.h"
+
+using namespace cyclone;
+
+constexpr unsigned DynamicAABBTree::NullNode;
+
+namespace
+{
+    /**
+    * Returns the world space box enclosing the given box or sphere.
+    */
+    BoundingBox GetBoundingVolume(const CollisionPrimitive& primitive)
+    {
+        if (primitive.GetType() == PrimitiveType::Box)
+        {
+            return BoundingBox::Enclosing(static_cast<const CollisionBox&>(primitive));
+        }
+
+        return BoundingBox::Enclosing(static_cast<const CollisionSphere&>(primitive));
+    }
+}
+
+bool DynamicAABBTree::Node::IsLeaf() const
+{
+    return children[0] == NullNode;
+}
+
+DynamicAABBTree::DynamicAABBTree(const real margin, const real displacementMultiplier): root(NullNode),
+    freeList(NullNode), margin(margin), displacementMultiplier(displacementMultiplier)
+{
+}
+
+unsigned DynamicAABBTree::Insert(RigidBody* body, const BoundingBox& volume, CollisionPrimitive* primitive)
+{
+    const auto proxy = AllocateNode();
+
+    auto& node = nodes[proxy];
+
+    node.volume = volume.Expanded(margin);
+
+    node.body = body;
+
+    node.primitive = primitive;
+
+    node.height = 0;
+
+    InsertLeaf(proxy);
+
+    return proxy;
+}
+
+void DynamicAABBTree::Remove(const unsigned proxy)
+{
+    RemoveLeaf(proxy);
+
+    FreeNode(proxy);
+}
+
+bool DynamicAABBTree::Move(const unsigned proxy, const BoundingBox& volume, const Vector3& displacement)
+{
+    // While the body stays inside its fat box there is nothing to do.
+    if (nodes[proxy].volume.Contains(volume))
+    {
+        return false;
+    }
+
+    RemoveLeaf(proxy);
+
+    // Stretch the new box in the direction the body is heading, so it
+    // can keep moving for a while before it escapes again.
+    nodes[proxy].volume = volume.Expanded(margin).Swept(displacement * displacementMultiplier);
+
+    InsertLeaf(proxy);
+
+    return true;
+}
+
+unsigned DynamicAABBTree::GetPotentialContacts(PotentialContact* contacts, const unsigned limit) const
+{
+    if (contacts == nullptr)
+    {
+        return 0;
+    }
+
+    auto count = 0u;
+
+    // Every pair of leaves meets at exactly one branch, so checking the
+    // two children of each branch against each other finds them all.
+    for (const auto& node : nodes)
+    {
+        if (count >= limit)
+        {
+            break;
+        }
+
+        if (node.height <= 0)
+        {
+            continue;
+        }
+
+        count += GetPotentialContactsWith(node.children[0], node.children[1], contacts + count, limit - count);
+    }
+
+    return count;
+}
+
+unsigned DynamicAABBTree::Query(const BoundingBox& volume, unsigned* proxies, const unsigned limit) const
+{
+    if (proxies == nullptr || root == NullNode)
+    {
+        return 0;
+    }
+
+    return QueryNode(root, volume, proxies, limit);
+}
+
+unsigned DynamicAABBTree::RaycastAll(const Ray* rays, const unsigned count, RayHit* hits) const
+{
+    if (rays == nullptr || hits == nullptr)
+    {
+        return 0;
+    }
+
+    auto hitCount = 0u;
+
+    for (auto first = 0u; first < count; first += RaysPerPacket)
+    {
+        const auto packetSize = count - first < RaysPerPacket ? count - first : RaysPerPacket;
+
+        hitCount += RaycastPacket(rays + first, packetSize, hits + first);
+    }
+
+    return hitCount;
+}
+
+unsigned DynamicAABBTree::Overlap(const CollisionPrimitive& shape, RigidBody** bodies, const unsigned limit) const
+{
+    if (bodies == nullptr || root == NullNode)
+    {
+        return 0;
+    }
+
+    return OverlapNode(root, shape, GetBoundingVolume(shape), bodies, limit);
+}
+
+unsigned DynamicAABBTree::Sweep(const CollisionPrimitive& shape, const Vector3& motion, SweepHit* hits,
+                                const unsigned limit) const
+{
+    if (hits == nullptr || limit == 0 || root == NullNode)
+    {
+        return 0;
+    }
+
+    // The sweep starts where the shape is, so a shape without a body
+    // starts from the origin and is placed by its offset.
+    BodySweep sweep;
+
+    sweep.position = shape.body != nullptr ? shape.body->GetPosition() : Vector3();
+
+    sweep.orientation = shape.body != nullptr ? shape.body->GetOrientation() : Quaternion();
+
+    sweep.velocity = motion;
+
+    sweep.duration = 1;
+
+    auto count = 0u;
+
+    SweepNode(root, shape, sweep, GetBoundingVolume(shape).Swept(motion), hits, limit, &count);
+
+    return count;
+}
+
+void DynamicAABBTree::Clear()
+{
+    nodes.clear();
+
+    root = NullNode;
+
+    freeList = NullNode;
+}
+
+const BoundingBox& DynamicAABBTree::GetFatVolume(const unsigned proxy) const
+{
+    return nodes[proxy].volume;
+}
+
+RigidBody* DynamicAABBTree::GetBody(const unsigned proxy) const
+{
+    return nodes[proxy].body;
+}
+
+CollisionPrimitive* DynamicAABBTree::GetPrimitive(const unsigned proxy) const
+{
+    return nodes[proxy].primitive;
+}
+
+unsigned DynamicAABBTree::GetHeight() const
+{
+    return root == NullNode ? 0 : static_cast<unsigned>(nodes[root].height);
+}
+
+unsigned DynamicAABBTree::AllocateNode()
+{
+    // Grow the pool when the free list runs out.
+    if (freeList == NullNode)
+    {
+        nodes.emplace_back();
+
+        nodes.back().parent = NullNode;
+
+        freeList = static_cast<unsigned>(nodes.size() - 1);
+    }
+
+    const auto index = freeList;
+
+    auto& node = nodes[index];
+
+    freeList = node.parent;
+
+    node.body = nullptr;
+
+    node.primitive = nullptr;
+
+    node.parent = NullNode;
+
+    node.children[0] = node.children[1] = NullNode;
+
+    node.height = 0;
+
+    return index;
+}
+
+void DynamicAABBTree::FreeNode(const unsigned node)
+{
+    nodes[node].parent = freeList;
+
+    nodes[node].height = -1;
+
+    freeList = node;
+}
+
+void DynamicAABBTree::InsertLeaf(const unsigned leaf)
+{
+    if (root == NullNode)
+    {
+        root = leaf;
+
+        nodes[root].parent = NullNode;
+
+        return;
+    }
+
+    const auto volume = nodes[leaf].volume;
+
+    // Work out which leaf becomes our sibling. Like BVHNode, we give the
+    // new leaf to whichever child would grow the least to incorporate it.
+    auto sibling = root;
+
+    while (!nodes[sibling].IsLeaf())
+    {
+        const auto& node = nodes[sibling];
+
+        const auto& one = nodes[node.children[0]].volume;
+
+        const auto& another = nodes[node.children[1]].volume;
+
+        sibling = one.GetGrowth(volume) < another.GetGrowth(volume) ? node.children[0] : node.children[1];
+    }
+
+    // Put a new branch where the sibling was, holding both leaves.
+    const auto oldParent = nodes[sibling].parent;
+
+    const auto newParent = AllocateNode();
+
+    nodes[newParent].parent = oldParent;
+
+    nodes[newParent].volume = BoundingBox(volume, nodes[sibling].volume);
+
+    nodes[newParent].height = nodes[sibling].height + 1;
+
+    nodes[newParent].children[0] = sibling;
+
+    nodes[newParent].children[1] = leaf;
+
+    nodes[sibling].parent = newParent;
+
+    nodes[leaf].parent = newParent;
+
+    if (oldParent == NullNode)
+    {
+        root = newParent;
+    }
+    else
+    {
+        auto& parent = nodes[oldParent];
+
+        parent.children[parent.children[0] == sibling ? 0 : 1] = newParent;
+    }
+
+    // Fix up the volumes and heights above the new branch.
+    Refit(oldParent);
+}
+
+void DynamicAABBTree::RemoveLeaf(const unsigned leaf)
+{
+    if (leaf == root)
+    {
+        root = NullNode;
+
+        return;
+    }
+
+    // The sibling takes the place of our parent, which is freed.
+    const auto parent = nodes[leaf].parent;
+
+    const auto grandParent = nodes[parent].parent;
+
+    const auto sibling = nodes[parent].children[nodes[parent].children[0] == leaf ? 1 : 0];
+
+    nodes[sibling].parent = grandParent;
+
+    FreeNode(parent);
+
+    nodes[leaf].parent = NullNode;
+
+    if (grandParent == NullNode)
+    {
+        root = sibling;
+
+        return;
+    }
+
+    auto& node = nodes[grandParent];
+
+    node.children[node.children[0] == parent ? 0 : 1] = sibling;
+
+    Refit(grandParent);
+}
+
+void DynamicAABBTree::Refit(unsigned node)
+{
+    while (node != NullNode)
+    {
+        node = Balance(node);
+
+        auto& branch = nodes[node];
+
+        const auto& one = nodes[branch.children[0]];
+
+        const auto& another = nodes[branch.children[1]];
+
+        // Use the bounding volume combining constructor.
+        branch.volume = BoundingBox(one.volume, another.volume);
+
+        branch.height = 1 + (one.height > another.height ? one.height : another.height);
+
+        node = branch.parent;
+    }
+}
+
+unsigned DynamicAABBTree::Balance(const unsigned node)
+{
+    const auto a = node;
+
+    if (nodes[a].IsLeaf() || nodes[a].height < 2)
+    {
+        return a;
+    }
+
+    const auto b = nodes[a].children[0];
+
+    const auto c = nodes[a].children[1];
+
+    const auto balance = nodes[c].height - nodes[b].height;
+
+    if (balance >= -1 && balance <= 1)
+    {
+        return a;
+    }
+
+    // Lift the taller child up to take the place of this branch, and
+    // hand this branch the shorter of its grandchildren.
+    const auto up = balance > 1 ? c : b;
+
+    const auto stay = balance > 1 ? b : c;
+
+    const auto f = nodes[up].children[0];
+
+    const auto g = nodes[up].children[1];
+
+    nodes[up].children[0] = a;
+
+    nodes[up].parent = nodes[a].parent;
+
+    nodes[a].parent = up;
+
+    if (nodes[up].parent == NullNode)
+    {
+        root = up;
+    }
+    else
+    {
+        auto& parent = nodes[nodes[up].parent];
+
+        parent.children[parent.children[0] == a ? 0 : 1] = up;
+    }
+
+    const auto taller = nodes[f].height > nodes[g].height ? f : g;
+
+    const auto shorter = taller == f ? g : f;
+
+    nodes[up].children[1] = taller;
+
+    nodes[a].children[0] = stay;
+
+    nodes[a].children[1] = shorter;
+
+    nodes[shorter].parent = a;
+
+    nodes[a].volume = BoundingBox(nodes[stay].volume, nodes[shorter].volume);
+
+    nodes[up].volume = BoundingBox(nodes[a].volume, nodes[taller].volume);
+
+    nodes[a].height = 1 + (nodes[stay].height > nodes[shorter].height ? nodes[stay].height : nodes[shorter].height);
+
+    nodes[up].height = 1 + (nodes[a].height > nodes[taller].height ? nodes[a].height : nodes[taller].height);
+
+    return up;
+}
+
+unsigned DynamicAABBTree::GetPotentialContactsWith(const unsigned one, const unsigned another,
+                                                   PotentialContact* contacts, const unsigned limit) const
+{
+    const auto& first = nodes[one];
+
+    const auto& second = nodes[another];
+
+    // Early out if we don't overlap or if we have no room
+    // to report contacts
+    if (limit == 0 || !first.volume.Overlaps(second.volume))
+    {
+        return 0;
+    }
+
+    // If we're both at leaf nodes, then we have a potential contact
+    if (first.IsLeaf() && second.IsLeaf())
+    {
+        // A body made of several primitives doesn't collide with itself.
+        if (first.body == second.body)
+        {
+            return 0;
+        }
+
+        contacts->body[0] = first.body;
+
+        contacts->body[1] = second.body;
+
+        contacts->primitive[0] = first.primitive;
+
+        contacts->primitive[1] = second.primitive;
+
+        return 1;
+    }
+
+    // Determine which node to descend into. If either is
+    // a leaf, then we descend the other. If both are branches,
+    // then we use the one with the largest size.
+    if (second.IsLeaf() || (!first.IsLeaf() && first.volume.Size() >= second.volume.Size()))
+    {
+        const auto count = GetPotentialContactsWith(first.children[0], another, contacts, limit);
+
+        return count + GetPotentialContactsWith(first.children[1], another, contacts + count, limit - count);
+    }
+
+    const auto count = GetPotentialContactsWith(one, second.children[0], contacts, limit);
+
+    return count + GetPotentialContactsWith(one, second.children[1], contacts + count, limit - count);
+}
+
+unsigned DynamicAABBTree::QueryNode(const unsigned node, const BoundingBox& volume, unsigned* proxies,
+                                    const unsigned limit) const
+{
+    const auto& current = nodes[node];
+
+    if (limit == 0 || !current.volume.Overlaps(volume))
+    {
+        return 0;
+    }
+
+    if (current.IsLeaf())
+    {
+        proxies[0] = node;
+
+        return 1;
+    }
+
+    const auto count = QueryNode(current.children[0], volume, proxies, limit);
+
+    return count + QueryNode(current.children[1], volume, proxies + count, limit - count);
+}
+
+unsigned DynamicAABBTree::OverlapNode(const unsigned node, const CollisionPrimitive& shape, const BoundingBox& volume,
+                                      RigidBody** bodies, const unsigned limit) const
+{
+    const auto& current = nodes[node];
+
+    if (limit == 0 || !current.volume.Overlaps(volume))
+    {
+        return 0;
+    }
+
+    if (!current.IsLeaf())
+    {
+        const auto count = OverlapNode(current.children[0], shape, volume, bodies, limit);
+
+        return count + OverlapNode(current.children[1], shape, volume, bodies + count, limit - count);
+    }
+
+    // A shape doesn't overlap its own body.
+    if (current.primitive == nullptr || (shape.body != nullptr && current.body == shape.body) ||
+        !IntersectionTests::PrimitiveAndPrimitive(shape, *current.primitive))
+    {
+        return 0;
+    }
+
+    bodies[0] = current.body;
+
+    return 1;
+}
+
+void DynamicAABBTree::SweepNode(const unsigned node, const CollisionPrimitive& shape, const BodySweep& sweep,
+                                const BoundingBox& volume, SweepHit* hits, const unsigned limit,
+                                unsigned* count) const
+{
+    const auto& current = nodes[node];
+
+    if (!current.volume.Overlaps(volume))
+    {
+        return;
+    }
+
+    if (!current.IsLeaf())
+    {
+        SweepNode(current.children[0], shape, sweep, volume, hits, limit, count);
+
+        SweepNode(current.children[1], shape, sweep, volume, hits, limit, count);
+
+        return;
+    }
+
+    if (current.primitive == nullptr || (shape.body != nullptr && current.body == shape.body))
+    {
+        return;
+    }
+
+    real fraction;
+
+    if (!TimeOfImpact::Sweep(shape, sweep, *current.primitive, 0, SweepTolerance, &fraction))
+    {
+        return;
+    }
+
+    // Once the list is full, a hit has to beat the farthest to get in.
+    if (*count == limit && fraction >= hits[limit - 1].fraction)
+    {
+        return;
+    }
+
+    auto slot = *count < limit ? (*count)++ : limit - 1;
+
+    // Shift the farther hits up to keep the list sorted.
+    while (slot > 0 && hits[slot - 1].fraction > fraction)
+    {
+        hits[slot] = hits[slot - 1];
+
+        --slot;
+    }
+
+    hits[slot].body = current.body;
+
+    hits[slot].primitive = current.primitive;
+
+    hits[slot].fraction = fraction;
+}
+
+unsigned DynamicAABBTree::RaycastPacket(const Ray* rays, const unsigned count, RayHit* hits) const
+{
+    // Lay the packet out one axis to a set of lanes. Lanes without a ray
+    // get a negative reach, so they never enter a volume.
+    real origins[3][RaysPerPacket];
+
+    real inverses[3][RaysPerPacket];
+
+    real reach[RaysPerPacket];
+
+    for (auto lane = 0u; lane < RaysPerPacket; ++lane)
+    {
+        const auto& ray = rays[lane < count ? lane : 0];
+
+        for (auto axis = 0u; axis < 3; ++axis)
+        {
+            const auto direction = ray.direction[axis];
+
+            origins[axis][lane] = ray.origin[axis];
+
+            // Keep the slabs of rays parallel to an axis finite.
+            inverses[axis][lane] = real_abs(direction) < real_epsilon
+                                       ? direction < 0 ? -REAL_MAX : REAL_MAX
+                                       : 1 / direction;
+        }
+
+        reach[lane] = lane < count ? ray.maxDistance : -1;
+
+        if (lane < count)
+        {
+            hits[lane].body = nullptr;
+
+            hits[lane].primitive = nullptr;
+
+            hits[lane].distance = ray.maxDistance;
+        }
+    }
+
+    if (root == NullNode)
+    {
+        return 0;
+    }
+
+    const simd::Lanes origin[3] = {simd::Load(origins[0]), simd::Load(origins[1]), simd::Load(origins[2])};
+
+    const simd::Lanes inverse[3] = {simd::Load(inverses[0]), simd::Load(inverses[1]), simd::Load(inverses[2])};
+
+    const auto zero = simd::Splat(0);
+
+    auto reachLanes = simd::Load(reach);
+
+    // Returns a mask of the rays that pass through the volume before
+    // their closest hit so far, using the slab test on every lane at once.
+    const auto getMask = [&](const BoundingBox& volume)
+    {
+        auto entry = zero;
+
+        auto exit = reachLanes;
+
+        for (auto axis = 0u; axis < 3; ++axis)
+        {
+            const auto nearSlab = simd::Mul(simd::Sub(simd::Splat(volume.minimum[axis]), origin[axis]),
+                                            inverse[axis]);
+
+            const auto farSlab = simd::Mul(simd::Sub(simd::Splat(volume.maximum[axis]), origin[axis]),
+                                           inverse[axis]);
+
+            entry = simd::Max(entry, simd::Min(nearSlab, farSlab));
+
+            exit = simd::Min(exit, simd::Max(nearSlab, farSlab));
+        }
+
+        return simd::LessEqual(entry, exit);
+    };
+
+    // The tree is balanced, so a stack as deep as it is tall is enough.
+    unsigned stack[MaxRayDepth + 1];
+
+    auto stackSize = 0u;
+
+    stack[stackSize++] = root;
+
+    while (stackSize > 0)
+    {
+        const auto& node = nodes[stack[--stackSize]];
+
+        const auto mask = getMask(node.volume);
+
+        if (mask == 0)
+        {
+            continue;
+        }
+
+        if (!node.IsLeaf())
+        {
+            // Visit the child nearer along the first ray first, so the
+            // hits it finds can cull the other.
+            const auto& one = nodes[node.children[0]].volume;
+
+            const auto& another = nodes[node.children[1]].volume;
+
+            const auto oneDistance = (one.minimum + one.maximum - rays[0].origin * 2) | rays[0].direction;
+
+            const auto anotherDistance = (another.minimum + another.maximum - rays[0].origin * 2) | rays[0].direction;
+
+            const auto nearer = oneDistance <= anotherDistance ? 0 : 1;
+
+            stack[stackSize++] = node.children[1 - nearer];
+
+            stack[stackSize++] = node.children[nearer];
+
+            continue;
+        }
+
+        if (node.primitive == nullptr)
+        {
+            continue;
+        }
+
+        // Only the rays that reach the leaf are tested against its primitive.
+        for (auto lane = 0u; lane < count; ++lane)
+        {
+            if ((mask & 1 << lane) == 0)
+            {
+                continue;
+            }
+
+            auto ray = rays[lane];
+
+            ray.maxDistance = reach[lane];
+
+            if (IntersectionTests::RayAndPrimitive(ray, *node.primitive, &hits[lane]))
+            {
+                reach[lane] = hits[lane].distance;
+            }
+        }
+
+        reachLanes = simd::Load(reach);
+    }
+
+    auto hitCount = 0u;
+
+    for (auto lane = 0u; lane < count; ++lane)
+    {
+        hitCount += hits[lane].primitive != nullptr ? 1 : 0;
+    }
+
+    return hitCount;
+}
@@ -0,0 +1,295 @@
+#include "RigidBody/CoarseCollision/SweepAndPrune.h"
+
+using namespace cyclone;
+
+namespace
+{
+    /**
+    * Marks the end of the free list.
+    */
+    constexpr unsigned NullProxy = 0xffffffff;
+
+    /**
+    * Returns the component of the vector along the given axis.
+    */
+    real GetComponent(const Vector3& vector, const unsigned axis)
+    {
+        return axis == 0 ? vector.x : axis == 1 ? vector.y : vector.z;
+    }
+}
+
+SweepAndPrune::SweepAndPrune(): freeList(NullProxy), bClearRemovedPairs(false)
+{
+}
+
+unsigned SweepAndPrune::Insert(RigidBody* body, const BoundingBox& volume, CollisionPrimitive* primitive)
+{
+    unsigned proxy;
+
+    if (freeList == NullProxy)
+    {
+        proxies.emplace_back();
+
+        proxy = static_cast<unsigned>(proxies.size() - 1);
+    }
+    else
+    {
+        proxy = freeList;
+
+        freeList = proxies[proxy].next;
+    }
+
+    auto& data = proxies[proxy];
+
+    data.volume = volume;
+
+    data.body = body;
+
+    data.primitive = primitive;
+
+    data.next = NullProxy;
+
+    // The new endpoints start at the top of each axis, so the insertion
+    // sort finds every pair they pass on the way down.
+    for (auto axis = 0u; axis < 3; ++axis)
+    {
+        endpoints[axis].push_back({GetComponent(volume.minimum, axis), proxy, false});
+
+        endpoints[axis].push_back({GetComponent(volume.maximum, axis), proxy, true});
+    }
+
+    return proxy;
+}
+
+void SweepAndPrune::Remove(const unsigned proxy)
+{
+    if (bClearRemovedPairs)
+    {
+        removedPairs.clear();
+
+        bClearRemovedPairs = false;
+    }
+
+    for (auto& axis : endpoints)
+    {
+        auto last = axis.begin();
+
+        for (auto endpoint = axis.begin(); endpoint != axis.end(); ++endpoint)
+        {
+            if (endpoint->proxy != proxy)
+            {
+                *last++ = *endpoint;
+            }
+        }
+
+        axis.erase(last, axis.end());
+    }
+
+    for (auto pair = pairs.begin(); pair != pairs.end();)
+    {
+        const auto one = static_cast<unsigned>(*pair >> 32);
+
+        const auto other = static_cast<unsigned>(*pair & 0xffffffff);
+
+        if (one == proxy || other == proxy)
+        {
+            removedPairs.push_back({{one, other}});
+
+            pair = pairs.erase(pair);
+        }
+        else
+        {
+            ++pair;
+        }
+    }
+
+    auto& data = proxies[proxy];
+
+    data.body = nullptr;
+
+    data.primitive = nullptr;
+
+    data.next = freeList;
+
+    freeList = proxy;
+}
+
+void SweepAndPrune::Move(const unsigned proxy, const BoundingBox& volume)
+{
+    proxies[proxy].volume = volume;
+}
+
+void SweepAndPrune::Update()
+{
+    addedPairs.clear();
+
+    if (bClearRemovedPairs)
+    {
+        removedPairs.clear();
+    }
+
+    // The removals made before the next update belong with this one.
+    bClearRemovedPairs = true;
+
+    for (auto axis = 0u; axis < 3; ++axis)
+    {
+        SortAxis(axis);
+    }
+}
+
+unsigned SweepAndPrune::GetPotentialContacts(PotentialContact* contacts, const unsigned limit) const
+{
+    if (contacts == nullptr)
+    {
+        return 0;
+    }
+
+    auto count = 0u;
+
+    for (const auto pair : pairs)
+    {
+        if (count >= limit)
+        {
+            break;
+        }
+
+        const auto& one = proxies[static_cast<unsigned>(pair >> 32)];
+
+        const auto& other = proxies[static_cast<unsigned>(pair & 0xffffffff)];
+
+        // A body made of several primitives doesn't collide with itself.
+        if (one.body == other.body)
+        {
+            continue;
+        }
+
+        contacts[count].body[0] = one.body;
+
+        contacts[count].body[1] = other.body;
+
+        contacts[count].primitive[0] = one.primitive;
+
+        contacts[count].primitive[1] = other.primitive;
+
+        ++count;
+    }
+
+    return count;
+}
+
+const SweepAndPrune::ProxyPairs& SweepAndPrune::GetAddedPairs() const
+{
+    return addedPairs;
+}
+
+const SweepAndPrune::ProxyPairs& SweepAndPrune::GetRemovedPairs() const
+{
+    return removedPairs;
+}
+
+unsigned SweepAndPrune::GetPairCount() const
+{
+    return static_cast<unsigned>(pairs.size());
+}
+
+void SweepAndPrune::Clear()
+{
+    proxies.clear();
+
+    freeList = NullProxy;
+
+    for (auto& axis : endpoints)
+    {
+        axis.clear();
+    }
+
+    pairs.clear();
+
+    addedPairs.clear();
+
+    removedPairs.clear();
+
+    bClearRemovedPairs = false;
+}
+
+void SweepAndPrune::SortAxis(const unsigned axis)
+{
+    auto& list = endpoints[axis];
+
+    // Refresh the cached values from the current volumes.
+    for (auto& endpoint : list)
+    {
+        const auto& volume = proxies[endpoint.proxy].volume;
+
+        endpoint.value = GetComponent(endpoint.bIsMaximum ? volume.maximum : volume.minimum, axis);
+    }
+
+    const auto count = static_cast<unsigned>(list.size());
+
+    for (auto i = 1u; i < count; ++i)
+    {
+        const auto endpoint = list[i];
+
+        auto j = i;
+
+        // Move the endpoint down past everything above its value. Lower
+        // ends go before upper ends of the same value, so touching boxes
+        // overlap just as BoundingBox::Overlaps says they do.
+        while (j > 0 && (list[j - 1].value > endpoint.value ||
+            (list[j - 1].value == endpoint.value && list[j - 1].bIsMaximum && !endpoint.bIsMaximum)))
+        {
+            const auto& passed = list[j - 1];
+
+            if (!endpoint.bIsMaximum && passed.bIsMaximum)
+            {
+                // A lower end passing an upper end starts an overlap on
+                // this axis, which matters if the others overlap too.
+                if (proxies[endpoint.proxy].volume.Overlaps(proxies[passed.proxy].volume))
+                {
+                    AddPair(endpoint.proxy, passed.proxy);
+                }
+            }
+            else if (endpoint.bIsMaximum && !passed.bIsMaximum)
+            {
+                // An upper end passing a lower end ends the overlap.
+                RemovePair(endpoint.proxy, passed.proxy);
+            }
+
+            list[j] = passed;
+
+            --j;
+        }
+
+        list[j] = endpoint;
+    }
+}
+
+void SweepAndPrune::AddPair(const unsigned one, const unsigned other)
+{
+    if (one == other)
+    {
+        return;
+    }
+
+    if (pairs.insert(GetPairKey(one, other)).second)
+    {
+        addedPairs.push_back({{one < other ? one : other, one < other ? other : one}});
+    }
+}
+
+void SweepAndPrune::RemovePair(const unsigned one, const unsigned other)
+{
+    if (pairs.erase(GetPairKey(one, other)) != 0)
+    {
+        removedPairs.push_back({{one < other ? one : other, one < other ? other : one}});
+    }
+}
+
+unsigned long long SweepAndPrune::GetPairKey(const unsigned one, const unsigned other)
+{
+    const auto low = one < other ? one : other;
+
+    const auto high = one < other ? other : one;
+
+    return static_cast<unsigned long long>(low) << 32 | high;
+}
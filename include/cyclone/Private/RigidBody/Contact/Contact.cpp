@@ -4,7 +4,8 @@
 
 using namespace cyclone;
 
-void Contact::SetBodyData(RigidBody* one, RigidBody* two, const real friction, const real restitution)
+void Contact::SetBodyData(RigidBody* one, RigidBody* two, const real friction, const real restitution,
+                          const unsigned feature)
 {
     body[0] = one;
 
@@ -13,6 +14,8 @@ void Contact::SetBodyData(RigidBody* one, RigidBody* two, const real friction, c
     Contact::friction = friction;
 
     Contact::restitution = restitution;
+
+    Contact::feature = feature;
 }
 
 void Contact::CalculateInternals(const real deltaTime)
@@ -199,7 +202,8 @@ void Contact::CalculateContactBasis()
         contactTangent[1].z = contactNormal.x * contactTangent[0].y;
     }
 
-    contactToWorld = Matrix(contactNormal, contactTangent[0], contactTangent[1]);
+    // The basis vectors form the columns of the matrix.
+    contactToWorld = Matrix3(contactNormal, contactTangent[0], contactTangent[1]).Transposed();
 }
 
 void Contact::ApplyVelocityChange(Vector3 velocityChange[2], Vector3 rotationChange[2])
@@ -211,7 +215,7 @@ void Contact::ApplyVelocityChange(Vector3 velocityChange[2], Vector3 rotationCha
 
     // Get hold of the inverse mass and inverse inertia tensor, both in
     // world coordinates.
-    Matrix inverseInertiaTensor[2];
+    Matrix3 inverseInertiaTensor[2];
 
     body[0]->GetInverseInertiaTensorWorld(&inverseInertiaTensor[0]);
 
@@ -286,7 +290,7 @@ void Contact::ApplyPositionChange(Vector3 linearChange[2], Vector3 angularChange
     {
         if (body[i] != nullptr)
         {
-            Matrix inverseInertiaTensor;
+            Matrix3 inverseInertiaTensor;
 
             body[i]->GetInverseInertiaTensorWorld(&inverseInertiaTensor);
 
@@ -362,7 +366,7 @@ void Contact::ApplyPositionChange(Vector3 linearChange[2], Vector3 angularChange
                 // Work out the direction we'd like to rotate in.
                 auto targetAngularDirection = relativeContactPosition[i] ^ contactNormal;
 
-                Matrix inverseInertiaTensor;
+                Matrix3 inverseInertiaTensor;
 
                 body[i]->GetInverseInertiaTensorWorld(&inverseInertiaTensor);
 
@@ -403,7 +407,7 @@ void Contact::ApplyPositionChange(Vector3 linearChange[2], Vector3 angularChange
     }
 }
 
-Vector3 Contact::CalculateFrictionlessImpulse(Matrix* inverseInertiaTensor)
+Vector3 Contact::CalculateFrictionlessImpulse(Matrix3* inverseInertiaTensor)
 {
     if (body[0] == nullptr)
     {
@@ -454,20 +458,20 @@ Vector3 Contact::CalculateFrictionlessImpulse(Matrix* inverseInertiaTensor)
     return impulseContact;
 }
 
-Vector3 Contact::CalculateFrictionImpulse(Matrix* inverseInertiaTensor)
+Vector3 Contact::CalculateFrictionImpulse(Matrix3* inverseInertiaTensor)
 {
     auto inverseMass = body[0]->GetInverseMass();
 
     // The equivalent of a cross product in matrices is multiplication
     // by a skew symmetric matrix - we build the matrix for converting
     // between linear and angular quantities.
-    Matrix impulseToTorque(0.f, -relativeContactPosition[0].z, relativeContactPosition[0].y, 0.f,
-                           relativeContactPosition[0].z, 0.f, -relativeContactPosition[0].x, 0.f,
-                           -relativeContactPosition[0].y, relativeContactPosition[0].x, 0.f, 0.f);
+    Matrix3 impulseToTorque;
+
+    impulseToTorque.SetSkewSymmetric(relativeContactPosition[0]);
 
     // Build the matrix to convert contact impulse to change in velocity
     // in world coordinates.
-    Matrix deltaVelWorld = impulseToTorque;
+    auto deltaVelWorld = impulseToTorque;
 
     deltaVelWorld *= inverseInertiaTensor[0];
 
@@ -479,9 +483,7 @@ Vector3 Contact::CalculateFrictionImpulse(Matrix* inverseInertiaTensor)
     if (body[1] != nullptr)
     {
         // Set the cross product matrix
-        impulseToTorque = Matrix(0.f, -relativeContactPosition[1].z, relativeContactPosition[1].y, 0.f,
-                                 relativeContactPosition[1].z, 0.f, -relativeContactPosition[1].x, 0.f,
-                                 -relativeContactPosition[1].y, relativeContactPosition[1].x, 0.f, 0.f);
+        impulseToTorque.SetSkewSymmetric(relativeContactPosition[1]);
 
         // Calculate the velocity change matrix
         auto deltaVelWorld2 = impulseToTorque;
@@ -544,3 +546,63 @@ Vector3 Contact::CalculateFrictionImpulse(Matrix* inverseInertiaTensor)
 
     return impulseContact;
 }
+
+Vector3 Contact::CalculateRelativeVelocity() const
+{
+    auto velocity = (body[0]->GetRotation() ^ relativeContactPosition[0]) + body[0]->GetVelocity();
+
+    if (body[1] != nullptr)
+    {
+        velocity -= (body[1]->GetRotation() ^ relativeContactPosition[1]) + body[1]->GetVelocity();
+    }
+
+    return contactToWorld.InverseTransformVector(velocity);
+}
+
+real Contact::CalculateVelocityPerImpulse(const Vector3& axis) const
+{
+    real velocityPerImpulse = 0.f;
+
+    for (auto i = 0u; i < 2; ++i)
+    {
+        if (body[i] != nullptr)
+        {
+            Matrix3 inverseInertiaTensor;
+
+            body[i]->GetInverseInertiaTensorWorld(&inverseInertiaTensor);
+
+            // The same sequence as for the frictionless impulse: the
+            // rotation the impulse makes, turned back into the velocity
+            // of the contact point.
+            auto angularVelocity = inverseInertiaTensor.TransformVector(relativeContactPosition[i] ^ axis);
+
+            velocityPerImpulse += (angularVelocity ^ relativeContactPosition[i]) | axis;
+
+            velocityPerImpulse += body[i]->GetInverseMass();
+        }
+    }
+
+    return velocityPerImpulse;
+}
+
+void Contact::ApplyImpulse(const Vector3& impulseContact)
+{
+    const auto impulse = contactToWorld.TransformVector(impulseContact);
+
+    Matrix3 inverseInertiaTensor;
+
+    body[0]->GetInverseInertiaTensorWorld(&inverseInertiaTensor);
+
+    body[0]->AddVelocity(impulse * body[0]->GetInverseMass());
+
+    body[0]->AddRotation(inverseInertiaTensor.TransformVector(relativeContactPosition[0] ^ impulse));
+
+    if (body[1] != nullptr)
+    {
+        body[1]->GetInverseInertiaTensorWorld(&inverseInertiaTensor);
+
+        body[1]->AddVelocity(impulse * -body[1]->GetInverseMass());
+
+        body[1]->AddRotation(inverseInertiaTensor.TransformVector(impulse ^ relativeContactPosition[1]));
+    }
+}
@@ -1,23 +1,167 @@
 #include "RigidBody/Contact/ContactResolver.h"
+#include <algorithm>
+#include <functional>
 
 using namespace cyclone;
 
+namespace
+{
+    /**
+    * A binary max-heap over the contacts of one island, ordered on one of
+    * their values. The heap lives in the island's contact indices, and
+    * the place of each contact in it is tracked so the contact can be
+    * moved when its value changes.
+    */
+    class ContactHeap
+    {
+    public:
+        ContactHeap(const Contact* contacts, unsigned* heap, unsigned* positions, const unsigned count,
+                    const real Contact::* key): contacts(contacts), heap(heap), positions(positions), count(count),
+            key(key)
+        {
+            for (auto place = 0u; place < count; ++place)
+            {
+                positions[heap[place]] = place;
+            }
+
+            // Sift down every parent, from the last up to the root.
+            for (auto place = count / 2; place-- > 0;)
+            {
+                SiftDown(place);
+            }
+        }
+
+        /**
+        * Returns the index of the contact with the largest value.
+        */
+        unsigned Top() const
+        {
+            return heap[0];
+        }
+
+        /**
+        * Returns the largest value.
+        */
+        real TopValue() const
+        {
+            return GetValue(0);
+        }
+
+        /**
+        * Moves the given contact to its place after its value changed.
+        */
+        void Update(const unsigned contact)
+        {
+            const auto place = positions[contact];
+
+            if (place > 0 && GetValue(place) > GetValue((place - 1) / 2))
+            {
+                SiftUp(place);
+            }
+            else
+            {
+                SiftDown(place);
+            }
+        }
+
+    private:
+        real GetValue(const unsigned place) const
+        {
+            return contacts[heap[place]].*key;
+        }
+
+        void Swap(const unsigned one, const unsigned two)
+        {
+            const auto contact = heap[one];
+
+            heap[one] = heap[two];
+
+            heap[two] = contact;
+
+            positions[heap[one]] = one;
+
+            positions[heap[two]] = two;
+        }
+
+        void SiftUp(unsigned place)
+        {
+            while (place > 0)
+            {
+                const auto parent = (place - 1) / 2;
+
+                if (!(GetValue(place) > GetValue(parent)))
+                {
+                    return;
+                }
+
+                Swap(place, parent);
+
+                place = parent;
+            }
+        }
+
+        void SiftDown(unsigned place)
+        {
+            while (true)
+            {
+                auto largest = place;
+
+                const auto left = place * 2 + 1;
+
+                const auto right = left + 1;
+
+                if (left < count && GetValue(left) > GetValue(largest))
+                {
+                    largest = left;
+                }
+
+                if (right < count && GetValue(right) > GetValue(largest))
+                {
+                    largest = right;
+                }
+
+                if (largest == place)
+                {
+                    return;
+                }
+
+                Swap(place, largest);
+
+                place = largest;
+            }
+        }
+
+    private:
+        const Contact* contacts;
+
+        unsigned* heap;
+
+        unsigned* positions;
+
+        unsigned count;
+
+        const real Contact::* key;
+    };
+}
+
 ContactResolver::ContactResolver(const unsigned iterations, const real velocityEpsilon, const real positionEpsilon):
     velocityIterationsUsed(0), positionIterationsUsed(0), velocityIterations(iterations),
-    positionIterations(iterations), velocityEpsilon(velocityEpsilon), positionEpsilon(positionEpsilon)
+    positionIterations(iterations), velocityEpsilon(velocityEpsilon), positionEpsilon(positionEpsilon),
+    threadPool(nullptr), mode(ResolutionMode::WorstFirst), impulseIterations(10), bWarmStarting(true)
 {
 }
 
 ContactResolver::ContactResolver(const unsigned velocityIterations, const unsigned positionIterations,
                                  const real velocityEpsilon, const real positionEpsilon): velocityIterationsUsed(0),
     positionIterationsUsed(0), velocityIterations(velocityIterations), positionIterations(positionIterations),
-    velocityEpsilon(velocityEpsilon), positionEpsilon(positionEpsilon)
+    velocityEpsilon(velocityEpsilon), positionEpsilon(positionEpsilon), threadPool(nullptr),
+    mode(ResolutionMode::WorstFirst), impulseIterations(10), bWarmStarting(true)
 {
 }
 
 bool ContactResolver::IsValid() const
 {
-    return velocityIterations > 0 && positionIterationsUsed > 0 && velocityEpsilon >= 0.f && positionEpsilon >= 0.f;
+    return velocityIterations > 0 && positionIterations > 0 && velocityEpsilon >= 0.f && positionEpsilon >= 0.f;
 }
 
 void ContactResolver::SetIterations(const unsigned iterations)
@@ -39,6 +183,28 @@ void ContactResolver::SetEpsilon(const real velocityEpsilon, const real position
     ContactResolver::positionEpsilon = positionEpsilon;
 }
 
+void ContactResolver::SetThreadPool(ThreadPool* threadPool)
+{
+    ContactResolver::threadPool = threadPool;
+}
+
+void ContactResolver::SetMode(const ResolutionMode mode)
+{
+    ContactResolver::mode = mode;
+}
+
+ResolutionMode ContactResolver::GetMode() const
+{
+    return mode;
+}
+
+void ContactResolver::SetImpulseIterations(const unsigned impulseIterations, const bool bWarmStarting)
+{
+    ContactResolver::impulseIterations = impulseIterations;
+
+    ContactResolver::bWarmStarting = bWarmStarting;
+}
+
 void ContactResolver::ResolveContacts(Contact* contacts, const unsigned numContacts, const real deltaTime)
 {
     // Make sure we have something to do.
@@ -52,17 +218,50 @@ void ContactResolver::ResolveContacts(Contact* contacts, const unsigned numConta
         return;
     }
 
-    // Prepare the contacts for processing
-    PrepareContacts(contacts, numContacts, deltaTime);
+    // Prepare the contacts for processing, finding the groups of them
+    // that can be resolved independently.
+    const auto numIslands = PrepareContacts(contacts, numContacts, deltaTime);
 
-    // Resolve the interpenetration problems with the contacts.
-    AdjustPositions(contacts, numContacts, deltaTime);
+    if (mode == ResolutionMode::SequentialImpulse)
+    {
+        PrepareImpulses(contacts, numContacts);
+    }
 
-    // Resolve the velocity problems with the contacts.
-    AdjustVelocities(contacts, numContacts, deltaTime);
+    islandIterationsUsed.resize(numIslands);
+
+    if (threadPool != nullptr && numIslands > 1)
+    {
+        threadPool->ParallelFor(numIslands, [this, contacts, numContacts, deltaTime](const unsigned island)
+        {
+            ResolveIsland(contacts, numContacts, island, deltaTime);
+        });
+    }
+    else
+    {
+        for (auto island = 0u; island < numIslands; ++island)
+        {
+            ResolveIsland(contacts, numContacts, island, deltaTime);
+        }
+    }
+
+    if (mode == ResolutionMode::SequentialImpulse)
+    {
+        StoreImpulses(contacts, numContacts);
+    }
+
+    velocityIterationsUsed = 0u;
+
+    positionIterationsUsed = 0u;
+
+    for (const auto& used : islandIterationsUsed)
+    {
+        velocityIterationsUsed += used.first;
+
+        positionIterationsUsed += used.second;
+    }
 }
 
-void ContactResolver::PrepareContacts(Contact* contacts, const unsigned numContacts, const real deltaTime)
+unsigned ContactResolver::PrepareContacts(Contact* contacts, const unsigned numContacts, const real deltaTime)
 {
     // Generate contact velocity and axis information.
     const auto LastContact = contacts + numContacts;
@@ -72,37 +271,187 @@ void ContactResolver::PrepareContacts(Contact* contacts, const unsigned numConta
         // Calculate the internal contact data (inertia, basis, etc).
         contact->CalculateInternals(deltaTime);
     }
+
+    // List every body of every contact, and sort the list by body so the
+    // contacts touching the same body sit next to each other.
+    bodyContacts.clear();
+
+    for (auto i = 0u; i < numContacts; ++i)
+    {
+        for (auto b = 0u; b < 2; ++b)
+        {
+            if (contacts[i].body[b])
+            {
+                bodyContacts.emplace_back(contacts[i].body[b], i * 2 + b);
+            }
+        }
+    }
+
+    std::sort(bodyContacts.begin(), bodyContacts.end());
+
+    // Point each side of each contact at the run of its body.
+    contactAdjacency.assign(numContacts * 2, std::make_pair(0u, 0u));
+
+    const auto numEntries = static_cast<unsigned>(bodyContacts.size());
+
+    for (auto start = 0u, end = 0u; start < numEntries; start = end)
+    {
+        while (end < numEntries && bodyContacts[end].first == bodyContacts[start].first)
+        {
+            ++end;
+        }
+
+        for (auto entry = start; entry < end; ++entry)
+        {
+            contactAdjacency[bodyContacts[entry].second] = std::make_pair(start, end);
+        }
+    }
+
+    return BuildIslands(numContacts);
 }
 
-void ContactResolver::AdjustVelocities(Contact* contacts, const unsigned numContacts, const real deltaTime)
+unsigned ContactResolver::BuildIslands(const unsigned numContacts)
 {
-    Vector3 velocityChange[2], rotationChange[2];
+    // Every contact starts out as an island of its own.
+    islandParents.resize(numContacts);
 
-    // iteratively handle impacts in order of severity.
-    velocityIterationsUsed = 0u;
+    for (auto i = 0u; i < numContacts; ++i)
+    {
+        islandParents[i] = i;
+    }
 
-    while (velocityIterationsUsed < velocityIterations)
+    // Contacts touching the same body sit next to each other in the
+    // sorted list, and each such neighbour joins the two islands.
+    for (auto i = 1u; i < bodyContacts.size(); ++i)
     {
-        // Find contact with maximum magnitude of probable velocity change.
-        auto maxVelocity = velocityEpsilon;
+        if (bodyContacts[i].first != bodyContacts[i - 1].first)
+        {
+            continue;
+        }
 
-        auto index = numContacts;
+        const auto one = FindIsland(bodyContacts[i - 1].second / 2);
 
-        for (auto i = 0u; i < numContacts; ++i)
-        {
-            if (contacts[i].desiredDeltaVelocity > maxVelocity)
-            {
-                maxVelocity = contacts[i].desiredDeltaVelocity;
+        const auto two = FindIsland(bodyContacts[i].second / 2);
 
-                index = i;
-            }
+        // Keeping the lower index as the root keeps the islands in the
+        // order of their first contact.
+        if (one < two)
+        {
+            islandParents[two] = one;
         }
+        else if (two < one)
+        {
+            islandParents[one] = two;
+        }
+    }
+
+    // Every parent has a lower index than its child, so in one pass in
+    // order each contact can take the island number already given to
+    // its parent, with each root opening a new island.
+    auto numIslands = 0u;
+
+    for (auto i = 0u; i < numContacts; ++i)
+    {
+        const auto parent = islandParents[i];
+
+        islandParents[i] = parent == i ? numIslands++ : islandParents[parent];
+    }
+
+    // Count the contacts of each island, and turn the counts into the
+    // end of each island in the grouped indices.
+    islandStarts.assign(numIslands + 1, 0u);
+
+    for (auto i = 0u; i < numContacts; ++i)
+    {
+        ++islandStarts[islandParents[i]];
+    }
+
+    for (auto island = 1u; island < numIslands; ++island)
+    {
+        islandStarts[island] += islandStarts[island - 1];
+    }
+
+    // Filling each island from its end leaves its contacts in order, and
+    // its end moved back to its start.
+    islandContacts.resize(numContacts);
+
+    for (auto i = numContacts; i-- > 0;)
+    {
+        islandContacts[--islandStarts[islandParents[i]]] = i;
+    }
+
+    islandStarts[numIslands] = numContacts;
+
+    heapPositions.resize(numContacts);
+
+    return numIslands;
+}
+
+unsigned ContactResolver::FindIsland(unsigned index)
+{
+    while (islandParents[index] != index)
+    {
+        // Halve the path as we go, so later searches are shorter.
+        islandParents[index] = islandParents[islandParents[index]];
+
+        index = islandParents[index];
+    }
 
-        if (index == numContacts)
+    return index;
+}
+
+void ContactResolver::ResolveIsland(Contact* contacts, const unsigned numContacts, const unsigned island,
+                                    const real deltaTime)
+{
+    const auto count = islandStarts[island + 1] - islandStarts[island];
+
+    // Each island gets the share of the iterations its contacts make up.
+    const auto Share = [count, numContacts](const unsigned iterations)
+    {
+        const auto share = (static_cast<unsigned long long>(iterations) * count + numContacts - 1) / numContacts;
+
+        return static_cast<unsigned>(share);
+    };
+
+    auto& used = islandIterationsUsed[island];
+
+    // Resolve the interpenetration problems with the contacts.
+    used.second = AdjustPositions(contacts, island, Share(positionIterations));
+
+    // Resolve the velocity problems with the contacts.
+    if (mode == ResolutionMode::SequentialImpulse)
+    {
+        used.first = SolveImpulses(contacts, island, impulseIterations);
+    }
+    else
+    {
+        used.first = AdjustVelocities(contacts, island, Share(velocityIterations), deltaTime);
+    }
+}
+
+unsigned ContactResolver::AdjustVelocities(Contact* contacts, const unsigned island, const unsigned iterations,
+                                           const real deltaTime)
+{
+    Vector3 velocityChange[2], rotationChange[2];
+
+    // Keep the island's contacts ordered by their probable velocity
+    // change, so the largest is always at hand.
+    ContactHeap heap(contacts, islandContacts.data() + islandStarts[island], heapPositions.data(),
+                     islandStarts[island + 1] - islandStarts[island], &Contact::desiredDeltaVelocity);
+
+    // iteratively handle impacts in order of severity.
+    auto iterationsUsed = 0u;
+
+    while (iterationsUsed < iterations)
+    {
+        // Find contact with maximum magnitude of probable velocity change.
+        if (!(heap.TopValue() > velocityEpsilon))
         {
             break;
         }
 
+        const auto index = heap.Top();
+
         // Match the awake state at the contact
         contacts[index].MatchAwakeState();
 
@@ -111,103 +460,320 @@ void ContactResolver::AdjustVelocities(Contact* contacts, const unsigned numCont
 
         // With the change in velocity of the two bodies, the update of
         // contact velocities means that some of the relative closing
-        // velocities need recomputing.
-        for (auto i = 0u; i < numContacts; ++i)
+        // velocities need recomputing. Only the contacts touching the
+        // two bodies are visited.
+        for (auto d = 0u; d < 2; ++d)
         {
-            // Check each body in the contact
-            for (auto b = 0; b < 2; ++b)
+            const auto& adjacent = contactAdjacency[index * 2 + d];
+
+            for (auto entry = adjacent.first; entry < adjacent.second; ++entry)
             {
-                if (contacts[i].body[b])
-                {
-                    // Check for a match with each body in the newly
-                    // resolved contact
-                    for (auto d = 0; d < 2; ++d)
-                    {
-                        if (contacts[i].body[b] == contacts[index].body[d])
-                        {
-                            auto deltaVelocity = velocityChange[d] + rotationChange[d] ^ contacts[i].
-                                relativeContactPosition[b];
-
-                            // The sign of the change is negative if we're dealing
-                            // with the second body in a contact.
-                            contacts[i].contactVelocity += contacts[i].contactToWorld.InverseTransformPosition(
-                                deltaVelocity) * (b ? -1.f : 1.f);
-
-                            contacts[i].CalculateDesiredDeltaVelocity(deltaTime);
-                        }
-                    }
-                }
+                const auto i = bodyContacts[entry].second / 2;
+
+                const auto b = bodyContacts[entry].second % 2;
+
+                auto deltaVelocity = velocityChange[d] + (rotationChange[d] ^ contacts[i].relativeContactPosition[b]);
+
+                // The sign of the change is negative if we're dealing
+                // with the second body in a contact.
+                contacts[i].contactVelocity += contacts[i].contactToWorld.InverseTransformVector(deltaVelocity) *
+                    (b ? -1.f : 1.f);
+
+                contacts[i].CalculateDesiredDeltaVelocity(deltaTime);
+
+                heap.Update(i);
             }
         }
 
-        ++velocityIterationsUsed;
+        ++iterationsUsed;
     }
+
+    return iterationsUsed;
 }
 
-void ContactResolver::AdjustPositions(Contact* contacts, const unsigned numContacts, const real deltaTime)
+unsigned ContactResolver::AdjustPositions(Contact* contacts, const unsigned island, const unsigned iterations)
 {
     Vector3 linearChange[2], angularChange[2];
 
+    // Keep the island's contacts ordered by their penetration, so the
+    // deepest is always at hand.
+    ContactHeap heap(contacts, islandContacts.data() + islandStarts[island], heapPositions.data(),
+                     islandStarts[island + 1] - islandStarts[island], &Contact::penetration);
+
     // iteratively resolve interpenetration in order of severity.
-    positionIterationsUsed = 0u;
+    auto iterationsUsed = 0u;
 
-    while (positionIterationsUsed < positionIterations)
+    while (iterationsUsed < iterations)
     {
         // Find biggest penetration
-        auto maxPenetration = positionEpsilon;
+        const auto maxPenetration = heap.TopValue();
+
+        if (!(maxPenetration > positionEpsilon))
+        {
+            break;
+        }
 
-        auto index = numContacts;
+        const auto index = heap.Top();
 
-        for (auto i = 0u; i < numContacts; ++i)
+        // Match the awake state at the contact
+        contacts[index].MatchAwakeState();
+
+        // Resolve the penetration.
+        contacts[index].ApplyPositionChange(linearChange, angularChange, maxPenetration);
+
+        // Again this action may have changed the penetration of other
+        // bodies, so we update the contacts touching the two bodies.
+        for (auto d = 0u; d < 2; ++d)
         {
-            if (contacts[i].penetration > maxPenetration)
+            const auto& adjacent = contactAdjacency[index * 2 + d];
+
+            for (auto entry = adjacent.first; entry < adjacent.second; ++entry)
             {
-                maxPenetration = contacts[i].penetration;
+                const auto i = bodyContacts[entry].second / 2;
+
+                const auto b = bodyContacts[entry].second % 2;
+
+                auto deltaPosition = linearChange[d] + (angularChange[d] ^ contacts[i].relativeContactPosition[b]);
+
+                // The sign of the change is positive if we're
+                // dealing with the second body in a contact
+                // and negative otherwise (because we're
+                // subtracting the resolution)..
+                contacts[i].penetration += deltaPosition | contacts[i].contactNormal * (b ? 1.f : -1.f);
 
-                index = i;
+                heap.Update(i);
             }
         }
 
-        if (index == numContacts)
+        ++iterationsUsed;
+    }
+
+    return iterationsUsed;
+}
+
+void ContactResolver::PrepareImpulses(const Contact* contacts, const unsigned numContacts)
+{
+    contactImpulses.resize(numContacts);
+
+    CachedImpulse key;
+
+    for (auto i = 0u; i < numContacts; ++i)
+    {
+        const auto& contact = contacts[i];
+
+        auto& state = contactImpulses[i];
+
+        // The velocity left after the desired change, which takes care of
+        // restitution and of the velocity built up by this frame's forces.
+        state.targetVelocity = contact.contactVelocity.x + contact.desiredDeltaVelocity;
+
+        for (auto axis = 0u; axis < 3; ++axis)
         {
-            return;
+            const Vector3 direction(contact.contactToWorld.M[0][axis], contact.contactToWorld.M[1][axis],
+                                    contact.contactToWorld.M[2][axis]);
+
+            // Contacts that no impulse can move are given a response so
+            // large that the impulses worked out for them vanish.
+            const auto velocityPerImpulse = contact.CalculateVelocityPerImpulse(direction);
+
+            state.velocityPerImpulse[axis] = velocityPerImpulse > 0.f ? velocityPerImpulse : REAL_MAX;
         }
 
-        // Match the awake state at the contact
-        contacts[index].MatchAwakeState();
+        state.impulse.Reset();
 
-        // Resolve the penetration.
-        contacts[index].ApplyPositionChange(linearChange, angularChange, maxPenetration);
+        if (!bWarmStarting || impulseCache.empty())
+        {
+            continue;
+        }
 
-        // Again this action may have changed the penetration of other
-        // bodies, so we update contacts.
-        for (auto i = 0u; i < numContacts; ++i)
+        key.body[0] = contact.body[0];
+
+        key.body[1] = contact.body[1];
+
+        key.feature = contact.feature;
+
+        const auto cached = std::lower_bound(impulseCache.begin(), impulseCache.end(), key);
+
+        if (cached == impulseCache.end() || key < *cached)
+        {
+            continue;
+        }
+
+        // Bring last frame's impulse into this frame's contact basis, and
+        // keep it within the limits it will be clamped to anyway.
+        auto impulse = contact.contactToWorld.InverseTransformVector(cached->impulse);
+
+        if (impulse.x <= 0.f)
         {
-            // Check each body in the contact
-            for (auto b = 0; b < 2; ++b)
+            continue;
+        }
+
+        const auto planarImpulse = real_sqrt(impulse.y * impulse.y + impulse.z * impulse.z);
+
+        const auto planarLimit = contact.friction * impulse.x;
+
+        if (planarImpulse > planarLimit)
+        {
+            impulse.y *= planarLimit / planarImpulse;
+
+            impulse.z *= planarLimit / planarImpulse;
+        }
+
+        state.impulse = impulse;
+    }
+}
+
+unsigned ContactResolver::SolveImpulses(Contact* contacts, const unsigned island, const unsigned iterations)
+{
+    const auto first = islandContacts.data() + islandStarts[island];
+
+    const auto last = islandContacts.data() + islandStarts[island + 1];
+
+    // Contacts between bodies that are all asleep are left alone, as
+    // changing the velocity of a sleeping body has no effect until it
+    // wakes up, when it would be wrong.
+    const auto IsAsleep = [](const Contact& contact)
+    {
+        return !contact.body[0]->GetAwake() && (contact.body[1] == nullptr || !contact.body[1]->GetAwake());
+    };
+
+    // Start from the impulses carried over from the last frame.
+    for (auto index = first; index < last; ++index)
+    {
+        auto& contact = contacts[*index];
+
+        const auto& state = contactImpulses[*index];
+
+        if (state.impulse.x > 0.f && !IsAsleep(contact))
+        {
+            contact.MatchAwakeState();
+
+            contact.ApplyImpulse(state.impulse);
+        }
+    }
+
+    auto sweeps = 0u;
+
+    while (sweeps < iterations)
+    {
+        ++sweeps;
+
+        // The largest change in velocity made during this sweep.
+        real maxVelocityChange = 0.f;
+
+        for (auto index = first; index < last; ++index)
+        {
+            auto& contact = contacts[*index];
+
+            auto& state = contactImpulses[*index];
+
+            if (IsAsleep(contact))
+            {
+                continue;
+            }
+
+            Vector3 impulseChange;
+
+            // Friction first, limited by the normal impulse applied so far.
+            if (contact.friction > 0.f)
             {
-                if (contacts[i].body[b])
+                const auto velocity = contact.CalculateRelativeVelocity();
+
+                const auto oldImpulse = state.impulse;
+
+                state.impulse.y -= velocity.y / state.velocityPerImpulse.y;
+
+                state.impulse.z -= velocity.z / state.velocityPerImpulse.z;
+
+                const auto planarImpulse = real_sqrt(state.impulse.y * state.impulse.y +
+                                                     state.impulse.z * state.impulse.z);
+
+                const auto planarLimit = contact.friction * state.impulse.x;
+
+                if (planarImpulse > planarLimit)
                 {
-                    // Check for a match with each body in the newly
-                    // resolved contact
-                    for (auto d = 0; d < 2; ++d)
-                    {
-                        if (contacts[i].body[b] == contacts[index].body[d])
-                        {
-                            auto deltaPosition = linearChange[d] + angularChange[d] ^ contacts[i].
-                                relativeContactPosition[b];
-
-                            // The sign of the change is positive if we're
-                            // dealing with the second body in a contact
-                            // and negative otherwise (because we're
-                            // subtracting the resolution)..
-                            contacts[i].penetration += deltaPosition | contacts[i].contactNormal * (b ? 1.f : -1.f);
-                        }
-                    }
+                    state.impulse.y *= planarLimit / planarImpulse;
+
+                    state.impulse.z *= planarLimit / planarImpulse;
                 }
+
+                impulseChange.y = state.impulse.y - oldImpulse.y;
+
+                impulseChange.z = state.impulse.z - oldImpulse.z;
+
+                maxVelocityChange = std::max<real>(maxVelocityChange, real_abs(impulseChange.y * state.velocityPerImpulse.y));
+
+                maxVelocityChange = std::max<real>(maxVelocityChange, real_abs(impulseChange.z * state.velocityPerImpulse.z));
+
+                if (impulseChange.y != 0.f || impulseChange.z != 0.f)
+                {
+                    contact.ApplyImpulse(impulseChange);
+                }
+
+                impulseChange.y = impulseChange.z = 0.f;
+            }
+
+            // Then the normal impulse, which may only push the bodies apart
+            // in total.
+            const auto velocity = contact.CalculateRelativeVelocity();
+
+            const auto oldNormalImpulse = state.impulse.x;
+
+            state.impulse.x = std::max<real>(oldNormalImpulse + (state.targetVelocity - velocity.x) /
+                                       state.velocityPerImpulse.x, 0.f);
+
+            impulseChange.x = state.impulse.x - oldNormalImpulse;
+
+            maxVelocityChange = std::max<real>(maxVelocityChange, real_abs(impulseChange.x * state.velocityPerImpulse.x));
+
+            if (impulseChange.x != 0.f)
+            {
+                contact.MatchAwakeState();
+
+                contact.ApplyImpulse(impulseChange);
             }
         }
 
-        ++positionIterationsUsed;
+        if (maxVelocityChange < velocityEpsilon)
+        {
+            break;
+        }
+    }
+
+    return sweeps;
+}
+
+void ContactResolver::StoreImpulses(const Contact* contacts, const unsigned numContacts)
+{
+    impulseCache.resize(numContacts);
+
+    for (auto i = 0u; i < numContacts; ++i)
+    {
+        auto& cached = impulseCache[i];
+
+        cached.body[0] = contacts[i].body[0];
+
+        cached.body[1] = contacts[i].body[1];
+
+        cached.feature = contacts[i].feature;
+
+        cached.impulse = contacts[i].contactToWorld.TransformVector(contactImpulses[i].impulse);
     }
+
+    std::sort(impulseCache.begin(), impulseCache.end());
+}
+
+bool ContactResolver::CachedImpulse::operator<(const CachedImpulse& other) const
+{
+    if (body[0] != other.body[0])
+    {
+        return std::less<const RigidBody*>()(body[0], other.body[0]);
+    }
+
+    if (body[1] != other.body[1])
+    {
+        return std::less<const RigidBody*>()(body[1], other.body[1]);
+    }
+
+    return feature < other.feature;
 }
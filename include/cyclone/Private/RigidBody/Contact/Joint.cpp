@@ -49,6 +49,8 @@ unsigned Joint::AddContact(Contact* contact, unsigned limit) const
 
         contact->restitution = 0.f;
 
+        contact->feature = 0;
+
         return 1;
     }
 
@@ -1,66 +1,171 @@
 #include "RigidBody/FineCollision/CollisionDetector.h"
 #include "RigidBody/FineCollision/IntersectionTests.h"
+#include "Core/Simd.h"
 #include <cfloat>
 #include <cmath>
 #include <cassert>
 
 using namespace cyclone;
 
-static real TransformToAxis(const CollisionBox& box, const Vector3& axis)
+namespace
 {
-    return box.halfSize.x * real_abs(axis | box.GetAxis(0)) + box.halfSize.y * real_abs(axis | box.GetAxis(1)) + box.
-        halfSize.z * real_abs(axis | box.GetAxis(2));
+    /**
+    * Holds the overlap of two boxes along each of the 15 axes the boxes
+    * could be separated on: the three face axes of box one, the three of
+    * box two, and the cross product of each axis of one with each of two,
+    * in that order.
+    */
+    struct BoxAndBoxAxes
+    {
+        /**
+        * Holds the overlap along each axis before it is normalized. Positive
+        * indicates overlap, negative indicates separation.
+        */
+        real overlap[15];
+
+        /**
+        * Holds the squared length of each axis.
+        */
+        real sizeSquared[15];
+    };
+
+    /**
+    * Holds a corner of the polygon being clipped in the face-face box
+    * test, along with what it came from.
+    */
+    struct ClipVertex
+    {
+        /**
+        * Holds the position of the corner in world coordinates.
+        */
+        Vector3 point;
+
+        /**
+        * Holds the feature that produced the corner, for the contact.
+        */
+        unsigned feature;
+
+        /**
+        * Holds what the edge from this corner to the next lies on: one
+        * of the four edges of the incident face, or after them one of
+        * the four side planes of the reference face.
+        */
+        unsigned edge;
+    };
+
+    /**
+    * The most corners the clipped polygon can have: each of the four
+    * side planes adds at most one to the incident face's four.
+    */
+    constexpr unsigned MaxClipVertices = 8;
 }
 
 /*
-* This function checks if the two boxes overlap
-* along the given axis, returning the amount of overlap.
-* The final parameter toCentre
-* is used to pass in the vector between the boxes centre
-* points, to avoid having to recalculate it each time.
+* Works out the overlap of the two boxes along all 15 axes in one pass.
+*
+* Rather than projecting both boxes onto each axis in turn, it builds the
+* rotation of box two relative to box one, R[i][j] = one[i] . two[j],
+* and its absolute value, from which every projection is a sum of a few
+* products. Each row is held in SIMD lanes, one lane for each axis of box
+* two, so the three axes sharing an axis of box one are done together.
 */
-static real PenetrationOnAxis(const CollisionBox& one, const CollisionBox& two, const Vector3& axis,
-                              const Vector3& toCentre)
+static void GetBoxAndBoxAxes(const CollisionBox& one, const CollisionBox& two, const Vector3& toCentre,
+                             BoxAndBoxAxes* axes)
 {
-    // Project the half-size of one onto axis
-    const auto oneProject = TransformToAxis(one, axis);
+    const auto& oneTransform = one.GetTransform();
 
-    const auto twoProject = TransformToAxis(two, axis);
+    const auto& twoTransform = two.GetTransform();
 
-    // Project this onto the axis
-    const auto distance = real_abs(toCentre | axis);
+    // The rows of two's transform hold the x, y and z of each of its axes.
+    const simd::Lanes twoRows[3] = {
+        simd::Load(twoTransform.M[0]), simd::Load(twoTransform.M[1]), simd::Load(twoTransform.M[2])
+    };
 
-    // Return the overlap (i.e. positive indicates
-    // overlap, negative indicates separation).
-    return oneProject + twoProject - distance;
-}
+    simd::Lanes rotation[3];
 
-static bool TryAxis(const CollisionBox& one, const CollisionBox& two, Vector3 axis, const Vector3& toCenter,
-                    const unsigned index, real& smallestPenetration, unsigned& smallestCase)
-{
-    // Make sure we have a normalized axis, and don't check almost parallel axes
-    if (axis.SizeSquared() < 0.0001f)
+    simd::Lanes absolute[3];
+
+    real centre[3];
+
+    for (auto i = 0u; i < 3; ++i)
     {
-        return true;
+        rotation[i] = simd::Add(simd::Add(simd::Mul(simd::Splat(oneTransform.M[0][i]), twoRows[0]),
+                                          simd::Mul(simd::Splat(oneTransform.M[1][i]), twoRows[1])),
+                                simd::Mul(simd::Splat(oneTransform.M[2][i]), twoRows[2]));
+
+        absolute[i] = simd::Abs(rotation[i]);
+
+        centre[i] = toCentre | one.GetAxis(i);
     }
 
-    axis.Normalize();
+    const auto twoHalfSize = two.halfSize.Load();
 
-    const auto penetration = PenetrationOnAxis(one, two, axis, toCenter);
+    alignas(32) real lanes[4];
 
-    if (penetration < 0.f)
+    // The face axes of box one
+    for (auto i = 0u; i < 3; ++i)
+    {
+        axes->overlap[i] = one.halfSize[i] + simd::Dot3(twoHalfSize, absolute[i]) - real_abs(centre[i]);
+
+        axes->sizeSquared[i] = 1;
+    }
+
+    // The face axes of box two, one to a lane
+    auto oneProject = simd::Splat(0);
+
+    auto distance = simd::Splat(0);
+
+    for (auto i = 0u; i < 3; ++i)
     {
-        return false;
+        oneProject = simd::Add(oneProject, simd::Mul(simd::Splat(one.halfSize[i]), absolute[i]));
+
+        distance = simd::Add(distance, simd::Mul(simd::Splat(centre[i]), rotation[i]));
     }
 
-    if (penetration < smallestPenetration)
+    simd::Store(lanes, simd::Sub(simd::Add(oneProject, twoHalfSize), simd::Abs(distance)));
+
+    for (auto j = 0u; j < 3; ++j)
     {
-        smallestPenetration = penetration;
+        axes->overlap[3 + j] = lanes[j];
 
-        smallestCase = index;
+        axes->sizeSquared[3 + j] = 1;
     }
 
-    return true;
+    // The cross products of axis i of box one with each axis of box two,
+    // which lie in the plane of one's other two axes, i1 and i2.
+    for (auto i = 0u; i < 3; ++i)
+    {
+        const auto i1 = (i + 1) % 3;
+
+        const auto i2 = (i + 2) % 3;
+
+        oneProject = simd::Add(simd::Mul(simd::Splat(one.halfSize[i1]), absolute[i2]),
+                               simd::Mul(simd::Splat(one.halfSize[i2]), absolute[i1]));
+
+        // Lane j of the rotated rows holds the entries for two's axes j1
+        // and j2, in the same way.
+        const auto twoProject = simd::Add(simd::Mul(simd::RotateLeft(twoHalfSize), simd::RotateRight(absolute[i])),
+                                          simd::Mul(simd::RotateRight(twoHalfSize), simd::RotateLeft(absolute[i])));
+
+        distance = simd::Sub(simd::Mul(simd::Splat(centre[i2]), rotation[i1]),
+                             simd::Mul(simd::Splat(centre[i1]), rotation[i2]));
+
+        simd::Store(lanes, simd::Sub(simd::Add(oneProject, twoProject), simd::Abs(distance)));
+
+        for (auto j = 0u; j < 3; ++j)
+        {
+            axes->overlap[6 + i * 3 + j] = lanes[j];
+        }
+
+        // The cross product of two unit axes is as long as the sine of
+        // the angle between them.
+        simd::Store(lanes, simd::Sub(simd::Splat(1), simd::Mul(rotation[i], rotation[i])));
+
+        for (auto j = 0u; j < 3; ++j)
+        {
+            axes->sizeSquared[6 + i * 3 + j] = lanes[j];
+        }
+    }
 }
 
 static void FillPointFaceBoxBox(const CollisionBox& one, const CollisionBox& two, const Vector3& toCentre,
@@ -91,22 +196,20 @@ static void FillPointFaceBoxBox(const CollisionBox& one, const CollisionBox& two
     }
 
     // Work out which vertex of box two we're colliding with.
-    // Using toCentre doesn't work!
+    // Using toCentre doesn't work! The vertex is numbered by the
+    // axes it lies on the negative side of.
     auto vertex = two.halfSize;
 
-    if ((two.GetAxis(0) | normal) < 0)
-    {
-        vertex.x = -vertex.x;
-    }
+    auto vertexIndex = 0u;
 
-    if ((two.GetAxis(1) | normal) < 0)
+    for (auto i = 0u; i < 3; ++i)
     {
-        vertex.y = -vertex.y;
-    }
+        if ((two.GetAxis(i) | normal) < 0)
+        {
+            vertex[i] = -vertex[i];
 
-    if ((two.GetAxis(2) | normal) < 0)
-    {
-        vertex.z = -vertex.z;
+            vertexIndex |= 1u << i;
+        }
     }
 
     // Create the contact data
@@ -116,7 +219,281 @@ static void FillPointFaceBoxBox(const CollisionBox& one, const CollisionBox& two
 
     contact->contactPoint = two.GetTransform() * vertex;
 
-    contact->SetBodyData(one.body, two.body, data->friction, data->restitution);
+    // The feature is the face of box one and the vertex of box two.
+    contact->SetBodyData(one.body, two.body, data->friction, data->restitution, best * 8 + vertexIndex);
+}
+
+/*
+* Clips the polygon to the side of the plane where axis . point is no
+* more than the offset, writing the clipped polygon to the given array,
+* which has room for the given number of corners. New corners are
+* numbered by the given base, the edge they were cut from and the plane.
+* Returns the number of corners written.
+*/
+static unsigned ClipPolygon(const ClipVertex* polygon, const unsigned count, const Vector3& axis, const real offset,
+                            const unsigned plane, const unsigned featureBase, ClipVertex* clipped,
+                            const unsigned capacity)
+{
+    auto clippedCount = 0u;
+
+    for (auto i = 0u; i < count; ++i)
+    {
+        const auto& from = polygon[i];
+
+        const auto& to = polygon[(i + 1) % count];
+
+        const auto fromDistance = (axis | from.point) - offset;
+
+        const auto toDistance = (axis | to.point) - offset;
+
+        if (fromDistance <= 0 && clippedCount < capacity)
+        {
+            clipped[clippedCount++] = from;
+        }
+
+        // Add the corner where the edge crosses the plane.
+        if ((fromDistance <= 0) != (toDistance <= 0) && clippedCount < capacity)
+        {
+            auto& corner = clipped[clippedCount++];
+
+            corner.point = from.point + (to.point - from.point) * (fromDistance / (fromDistance - toDistance));
+
+            corner.feature = featureBase + (from.edge << 2 | plane);
+
+            // Leaving the plane's side, the polygon runs along the plane.
+            corner.edge = fromDistance <= 0 ? 4 + plane : from.edge;
+        }
+    }
+
+    return clippedCount;
+}
+
+/*
+* Picks up to the given number of the points to keep: the deepest, the
+* one farthest from it, then the two that span the largest area with
+* those on either side. Writes the indices of the points to keep and
+* returns how many there are.
+*/
+static unsigned ReduceFacePoints(const ClipVertex* points, const real* penetrations, const unsigned count,
+                                 const Vector3& normal, const unsigned limit, unsigned* kept)
+{
+    if (count <= limit)
+    {
+        for (auto i = 0u; i < count; ++i)
+        {
+            kept[i] = i;
+        }
+
+        return count;
+    }
+
+    auto deepest = 0u;
+
+    for (auto i = 1u; i < count; ++i)
+    {
+        if (penetrations[i] > penetrations[deepest])
+        {
+            deepest = i;
+        }
+    }
+
+    auto farthest = deepest == 0 ? 1u : 0u;
+
+    for (auto i = 0u; i < count; ++i)
+    {
+        if ((points[i].point - points[deepest].point).SizeSquared() >
+            (points[farthest].point - points[deepest].point).SizeSquared())
+        {
+            farthest = i;
+        }
+    }
+
+    // The area each point spans with the first two, signed by which side
+    // of the line through them it lies on.
+    const auto line = points[farthest].point - points[deepest].point;
+
+    auto left = count;
+
+    auto right = count;
+
+    auto leftArea = static_cast<real>(0.f);
+
+    auto rightArea = static_cast<real>(0.f);
+
+    for (auto i = 0u; i < count; ++i)
+    {
+        const auto area = ((points[i].point - points[deepest].point) ^ line) | normal;
+
+        if (area > leftArea)
+        {
+            leftArea = area;
+
+            left = i;
+        }
+        else if (area < rightArea)
+        {
+            rightArea = area;
+
+            right = i;
+        }
+    }
+
+    const unsigned candidates[4] = {deepest, farthest, left, right};
+
+    auto keptCount = 0u;
+
+    for (auto i = 0u; i < 4 && keptCount < limit; ++i)
+    {
+        if (candidates[i] < count)
+        {
+            kept[keptCount++] = candidates[i];
+        }
+    }
+
+    return keptCount;
+}
+
+/*
+* This method is called when the boxes meet on a face of box one. It
+* takes the face of box two most nearly facing it, and clips that face
+* to the sides of the face of box one, writing a contact for each corner
+* left below the face of box one, up to four. Returns the number of
+* contacts written, or zero if none of the corners are below the face.
+*/
+static unsigned FillFaceFaceBoxBox(const CollisionBox& one, const CollisionBox& two, const Vector3& toCentre,
+                                   CollisionData* data, const unsigned best)
+{
+    auto contact = data->contacts;
+
+    if (contact == nullptr)
+    {
+        return 0;
+    }
+
+    // The normal points from box two to box one, as in
+    // FillPointFaceBoxBox, so the face of box one is on box two's side.
+    auto normal = one.GetAxis(best);
+
+    if ((normal | toCentre) > 0)
+    {
+        normal *= -1.f;
+    }
+
+    const auto faceCentre = one.GetAxis(3) - normal * one.halfSize[best];
+
+    // The incident face of box two is the one facing box one the most.
+    auto incident = 0u;
+
+    auto incidentDot = static_cast<real>(0.f);
+
+    for (auto i = 0u; i < 3; ++i)
+    {
+        const auto dot = two.GetAxis(i) | normal;
+
+        if (real_abs(dot) > real_abs(incidentDot))
+        {
+            incident = i;
+
+            incidentDot = dot;
+        }
+    }
+
+    // Walk around the incident face, numbering each corner by the axes
+    // it lies on the negative side of, as FillPointFaceBoxBox does.
+    const auto incident1 = (incident + 1) % 3;
+
+    const auto incident2 = (incident + 2) % 3;
+
+    static const real corners[4][2] = {{1.f, 1.f}, {-1.f, 1.f}, {-1.f, -1.f}, {1.f, -1.f}};
+
+    ClipVertex polygon[MaxClipVertices];
+
+    ClipVertex clipped[MaxClipVertices];
+
+    for (auto i = 0u; i < 4; ++i)
+    {
+        Vector3 corner;
+
+        corner[incident] = incidentDot > 0 ? two.halfSize[incident] : -two.halfSize[incident];
+
+        corner[incident1] = corners[i][0] * two.halfSize[incident1];
+
+        corner[incident2] = corners[i][1] * two.halfSize[incident2];
+
+        auto vertexIndex = 0u;
+
+        for (auto j = 0u; j < 3; ++j)
+        {
+            vertexIndex |= corner[j] < 0 ? 1u << j : 0u;
+        }
+
+        polygon[i].point = two.GetTransform() * corner;
+
+        polygon[i].feature = best * 8 + vertexIndex;
+
+        polygon[i].edge = i;
+    }
+
+    // Clip it to the four sides of the face of box one. Corners made by
+    // clipping are numbered above the edge-edge features.
+    const auto featureBase = 1024 + (best << 8);
+
+    auto count = 4u;
+
+    auto side = 0u;
+
+    for (auto i = 1u; i < 3 && count > 0; ++i)
+    {
+        const auto axisIndex = (best + i) % 3;
+
+        const auto axis = one.GetAxis(axisIndex);
+
+        const auto centre = axis | one.GetAxis(3);
+
+        count = ClipPolygon(polygon, count, axis, centre + one.halfSize[axisIndex], side++, featureBase, clipped,
+                            MaxClipVertices);
+
+        count = ClipPolygon(clipped, count, axis * -1.f, one.halfSize[axisIndex] - centre, side++, featureBase,
+                            polygon, MaxClipVertices);
+    }
+
+    // Keep the corners below the face.
+    ClipVertex points[MaxClipVertices];
+
+    real penetrations[MaxClipVertices];
+
+    auto pointCount = 0u;
+
+    for (auto i = 0u; i < count; ++i)
+    {
+        const auto penetration = (polygon[i].point - faceCentre) | normal;
+
+        if (penetration > 0)
+        {
+            points[pointCount] = polygon[i];
+
+            penetrations[pointCount++] = penetration;
+        }
+    }
+
+    unsigned kept[4];
+
+    const auto limit = data->contactsLeft < 4 ? static_cast<unsigned>(data->contactsLeft) : 4u;
+
+    const auto keptCount = ReduceFacePoints(points, penetrations, pointCount, normal, limit, kept);
+
+    for (auto i = 0u; i < keptCount; ++i, ++contact)
+    {
+        contact->contactNormal = normal;
+
+        contact->penetration = penetrations[kept[i]];
+
+        contact->contactPoint = points[kept[i]].point;
+
+        contact->SetBodyData(one.body, two.body, data->friction, data->restitution, points[kept[i]].feature);
+    }
+
+    return keptCount;
 }
 
 static Vector3 ContactPoint(const Vector3& pointOne, const Vector3& axisOne, const real oneSize,
@@ -171,7 +548,7 @@ unsigned CollisionDetector::SphereAndHalfSpace(const CollisionSphere& sphere, co
     const auto position = sphere.GetAxis(3);
 
     // Find the distance from the plane
-    const auto ballDistance = plane.direction | position - sphere.radius - plane.offset;
+    const auto ballDistance = (plane.direction | position) - sphere.radius - plane.offset;
 
     if (ballDistance >= 0)
     {
@@ -212,7 +589,7 @@ unsigned CollisionDetector::SphereAndTruePlane(const CollisionSphere& sphere, co
     const auto position = sphere.GetAxis(3);
 
     // Find the distance from the plane
-    const auto centreDistance = plane.direction | position - plane.offset;
+    const auto centreDistance = (plane.direction | position) - plane.offset;
 
     // Check if we're within radius
     if (centreDistance * centreDistance > sphere.radius * sphere.radius)
@@ -366,8 +743,8 @@ unsigned CollisionDetector::BoxAndHalfSpace(const CollisionBox& box, const Colli
 
             contact->penetration = plane.offset - vertexDistance;
 
-            // Write the appropriate data
-            contact->SetBodyData(box.body, nullptr, data->friction, data->restitution);
+            // Write the appropriate data, the vertex being the feature.
+            contact->SetBodyData(box.body, nullptr, data->friction, data->restitution, i);
 
             // Move onto the next contact
             ++contact;
@@ -386,11 +763,6 @@ unsigned CollisionDetector::BoxAndHalfSpace(const CollisionBox& box, const Colli
     return contactsUsed;
 }
 
-// This preprocessor definition is only used as a convenience
-// in the boxAndBox contact generation method.
-#define CHECK_OVERLAP(axis, index) \
-if (!TryAxis(one, two, axis, toCentre, index, pen, best)) return 0;
-
 unsigned CollisionDetector::BoxAndBox(const CollisionBox& one, const CollisionBox& two, CollisionData* data)
 {
     // Make sure we have contacts
@@ -402,47 +774,50 @@ unsigned CollisionDetector::BoxAndBox(const CollisionBox& one, const CollisionBo
     // Find the vector between the two centres
     const auto toCentre = two.GetAxis(3) - one.GetAxis(3);
 
+    BoxAndBoxAxes axes;
+
+    GetBoxAndBoxAxes(one, two, toCentre, &axes);
+
     // We start assuming there is no contact
     auto pen = REAL_MAX;
 
     auto best = 0xffffffu;
 
-    // Now we check each axes, returning if it gives us
-    // a separating axis, and keeping track of the axis with
-    // the smallest penetration otherwise.
-    CHECK_OVERLAP(one.GetAxis(0), 0);
-
-    CHECK_OVERLAP(one.GetAxis(1), 1);
-
-    CHECK_OVERLAP(one.GetAxis(2), 2);
-
-    CHECK_OVERLAP(two.GetAxis(0), 3);
-
-    CHECK_OVERLAP(two.GetAxis(1), 4);
-
-    CHECK_OVERLAP(two.GetAxis(2), 5);
+    auto bestSingleAxis = best;
 
-    // Store the best axis-major, in case we run into almost
-    // parallel edge collisions later
-    const auto bestSingleAxis = best;
-
-    CHECK_OVERLAP(one.GetAxis(0) ^ two.GetAxis(0), 6);
-
-    CHECK_OVERLAP(one.GetAxis(0) ^ two.GetAxis(1), 7);
-
-    CHECK_OVERLAP(one.GetAxis(0) ^ two.GetAxis(2), 8);
-
-    CHECK_OVERLAP(one.GetAxis(1) ^ two.GetAxis(0), 9);
+    // Now we check each axis, returning if it gives us a separating
+    // axis, and keeping track of the axis with the smallest penetration
+    // otherwise. Almost parallel edges give no axis worth checking.
+    for (auto index = 0u; index < 15; ++index)
+    {
+        // Store the best axis-major, in case we run into almost
+        // parallel edge collisions later
+        if (index == 6)
+        {
+            bestSingleAxis = best;
+        }
 
-    CHECK_OVERLAP(one.GetAxis(1) ^ two.GetAxis(1), 10);
+        if (axes.sizeSquared[index] < 0.0001f)
+        {
+            continue;
+        }
 
-    CHECK_OVERLAP(one.GetAxis(1) ^ two.GetAxis(2), 11);
+        const auto penetration = index < 6
+                                     ? axes.overlap[index]
+                                     : axes.overlap[index] / real_sqrt(axes.sizeSquared[index]);
 
-    CHECK_OVERLAP(one.GetAxis(2) ^ two.GetAxis(0), 12);
+        if (penetration < 0.f)
+        {
+            return 0;
+        }
 
-    CHECK_OVERLAP(one.GetAxis(2) ^ two.GetAxis(1), 13);
+        if (penetration < pen)
+        {
+            pen = penetration;
 
-    CHECK_OVERLAP(one.GetAxis(2) ^ two.GetAxis(2), 14);
+            best = index;
+        }
+    }
 
     // Make sure we've got a result.
     assert(best != 0xffffffu);
@@ -453,25 +828,40 @@ unsigned CollisionDetector::BoxAndBox(const CollisionBox& one, const CollisionBo
     // the case.
     if (best < 3)
     {
-        // We've got a vertex of box two on a face of box one.
-        FillPointFaceBoxBox(one, two, toCentre, data, best, pen);
+        // We've got a face of box one, and up to four points of box
+        // two on it, or failing that the deepest vertex.
+        auto count = FillFaceFaceBoxBox(one, two, toCentre, data, best);
 
-        data->AddContacts(1);
+        if (count == 0)
+        {
+            FillPointFaceBoxBox(one, two, toCentre, data, best, pen);
+
+            count = 1;
+        }
+
+        data->AddContacts(count);
 
-        return 1;
+        return count;
     }
 
     if (best < 6)
     {
-        // We've got a vertex of box one on a face of box two.
+        // We've got a face of box two, with points of box one on it.
         // We use the same algorithm as above, but swap around
         // one and two (and therefore also the vector between their
         // centres).
-        FillPointFaceBoxBox(two, one, toCentre * -1.f, data, best - 3, pen);
+        auto count = FillFaceFaceBoxBox(two, one, toCentre * -1.f, data, best - 3);
+
+        if (count == 0)
+        {
+            FillPointFaceBoxBox(two, one, toCentre * -1.f, data, best - 3, pen);
+
+            count = 1;
+        }
 
-        data->AddContacts(1);
+        data->AddContacts(count);
 
-        return 1;
+        return count;
     }
 
     // We've got an edge-edge contact. Find out which axes
@@ -505,6 +895,11 @@ unsigned CollisionDetector::BoxAndBox(const CollisionBox& one, const CollisionBo
 
     auto pointOnTwoEdge = two.halfSize;
 
+    // Each edge is numbered by the axes it lies on the negative side of.
+    auto oneEdgeIndex = 0u;
+
+    auto twoEdgeIndex = 0u;
+
     for (auto i = 0u; i < 3; ++i)
     {
         if (i == oneAxisIndex)
@@ -514,6 +909,8 @@ unsigned CollisionDetector::BoxAndBox(const CollisionBox& one, const CollisionBo
         else if ((one.GetAxis(i) | axis) > 0)
         {
             pointOnOneEdge[i] = -pointOnOneEdge[i];
+
+            oneEdgeIndex |= 1u << i;
         }
 
         if (i == twoAxisIndex)
@@ -523,6 +920,8 @@ unsigned CollisionDetector::BoxAndBox(const CollisionBox& one, const CollisionBo
         else if ((two.GetAxis(i) | axis) < 0)
         {
             pointOnTwoEdge[i] = -pointOnTwoEdge[i];
+
+            twoEdgeIndex |= 1u << i;
         }
     }
 
@@ -552,15 +951,16 @@ unsigned CollisionDetector::BoxAndBox(const CollisionBox& one, const CollisionBo
 
     contact->contactPoint = vertex;
 
-    contact->SetBodyData(one.body, two.body, data->friction, data->restitution);
+    // The feature is the pair of edges, numbered above the point-face
+    // features.
+    contact->SetBodyData(one.body, two.body, data->friction, data->restitution,
+                         64 + (best << 6 | oneEdgeIndex << 3 | twoEdgeIndex));
 
     data->AddContacts(1);
 
     return 1;
 }
 
-#undef CHECK_OVERLAP
-
 unsigned CollisionDetector::BoxAndPoint(const CollisionBox& box, const Vector3& point, CollisionData* data)
 {
     // Make sure we have contacts
@@ -570,7 +970,7 @@ unsigned CollisionDetector::BoxAndPoint(const CollisionBox& box, const Vector3&
     }
 
     // Transform the point into box coordinates
-    const auto relPoint = box.GetTransform().InverseTransformVector(point);
+    const auto relPoint = box.GetTransform().InverseTransformPosition(point);
 
     // Check each axis, looking for the axis on which the
     // penetration is least deep.
@@ -646,7 +1046,7 @@ unsigned CollisionDetector::BoxAndSphere(const CollisionBox& box, const Collisio
     // Transform the centre of the sphere into box coordinates
     const auto centre = sphere.GetAxis(3);
 
-    auto relCentre = box.transform.InverseTransformVector(centre);
+    auto relCentre = box.transform.InverseTransformPosition(centre);
 
     // Early out check to see if we can exclude the contact
     if (real_abs(relCentre.x) - sphere.radius > box.halfSize.x ||
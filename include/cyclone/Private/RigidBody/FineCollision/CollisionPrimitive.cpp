@@ -1,13 +1,29 @@
 #include "RigidBody/FineCollision/CollisionPrimitive.h"
+#include "RigidBody/FineCollision/CollisionBox.h"
+#include "RigidBody/FineCollision/CollisionPlane.h"
+#include "RigidBody/FineCollision/CollisionSphere.h"
 
 using namespace cyclone;
 
+CollisionPrimitive::CollisionPrimitive(const PrimitiveType type): body(nullptr), type(type)
+{
+}
+
+PrimitiveType CollisionPrimitive::GetType() const
+{
+    return type;
+}
+
 void CollisionPrimitive::CalculateInternals()
 {
     if (body != nullptr)
     {
         transform = body->GetTransform() * offset;
     }
+    else
+    {
+        transform = offset;
+    }
 }
 
 Vector3 CollisionPrimitive::GetAxis(const unsigned index) const
@@ -15,7 +31,19 @@ Vector3 CollisionPrimitive::GetAxis(const unsigned index) const
     return Vector3(transform.M[0][index], transform.M[1][index], transform.M[2][index]);
 }
 
-const Matrix& CollisionPrimitive::GetTransform() const
+const Matrix3x4& CollisionPrimitive::GetTransform() const
 {
     return transform;
 }
+
+CollisionBox::CollisionBox(): CollisionPrimitive(PrimitiveType::Box)
+{
+}
+
+CollisionSphere::CollisionSphere(): CollisionPrimitive(PrimitiveType::Sphere), radius(0.f)
+{
+}
+
+CollisionPlane::CollisionPlane(): CollisionPrimitive(PrimitiveType::Plane), offset(0.f)
+{
+}
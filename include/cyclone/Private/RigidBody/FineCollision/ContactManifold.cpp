@@ -0,0 +1,340 @@
+#include "RigidBody/FineCollision/ContactManifold.h"
+#include <algorithm>
+#include <functional>
+#include <tuple>
+
+using namespace cyclone;
+
+ContactManifold::ContactManifold(const CollisionPrimitive* one, const CollisionPrimitive* two): lastFrame(0),
+    pointCount(0), bTested(false)
+{
+    primitive[0] = one;
+
+    primitive[1] = two;
+
+    body[0] = nullptr;
+
+    body[1] = nullptr;
+}
+
+bool ContactManifold::CanReuse() const
+{
+    if (!bTested)
+    {
+        return false;
+    }
+
+    for (auto i = 0u; i < 2; ++i)
+    {
+        const auto thisBody = primitive[i]->body;
+
+        if (thisBody == nullptr)
+        {
+            continue;
+        }
+
+        if ((thisBody->GetPosition() - testedPosition[i]).SizeSquared() > ReuseDistance * ReuseDistance)
+        {
+            return false;
+        }
+
+        // The cosine of half the angle between the two orientations.
+        const auto orientation = thisBody->GetOrientation();
+
+        const auto& tested = testedOrientation[i];
+
+        const auto alignment = orientation.i * tested.i + orientation.j * tested.j + orientation.k * tested.k +
+            orientation.a * tested.a;
+
+        if (real_abs(alignment) < ReuseAlignment)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void ContactManifold::Refresh()
+{
+    auto kept = 0u;
+
+    for (auto i = 0u; i < pointCount; ++i)
+    {
+        auto& point = points[i];
+
+        const auto pointOne = ToWorld(body[0], point.localPoint[0]);
+
+        const auto pointTwo = ToWorld(body[1], point.localPoint[1]);
+
+        const auto separation = pointTwo - pointOne;
+
+        const auto penetration = separation | point.normal;
+
+        // Drop the point once the bodies have moved apart, or slid far
+        // enough that the two halves of the point no longer meet.
+        const auto slide = separation - point.normal * penetration;
+
+        if (penetration < -BreakingThreshold || slide.SizeSquared() > BreakingThreshold * BreakingThreshold)
+        {
+            continue;
+        }
+
+        point.worldPoint = pointOne;
+
+        point.penetration = penetration;
+
+        points[kept++] = point;
+    }
+
+    pointCount = kept;
+}
+
+void ContactManifold::Merge(const Contact* contacts, const unsigned count)
+{
+    for (auto c = 0u; c < count; ++c)
+    {
+        const auto& contact = contacts[c];
+
+        // The bodies keep the order the collision tests give them in.
+        if (contact.body[0] != body[0] || contact.body[1] != body[1])
+        {
+            body[0] = contact.body[0];
+
+            body[1] = contact.body[1];
+
+            pointCount = 0;
+        }
+
+        ManifoldPoint point;
+
+        point.localPoint[0] = ToLocal(body[0], contact.contactPoint);
+
+        point.localPoint[1] = ToLocal(body[1], contact.contactPoint + contact.contactNormal * contact.penetration);
+
+        point.normal = contact.contactNormal;
+
+        point.feature = contact.feature;
+
+        point.worldPoint = contact.contactPoint;
+
+        point.penetration = contact.penetration;
+
+        // Refresh the point made by the same feature, or failing that
+        // one found in the same place.
+        auto match = pointCount;
+
+        for (auto i = 0u; i < pointCount && match == pointCount; ++i)
+        {
+            if (points[i].feature == point.feature)
+            {
+                match = i;
+            }
+        }
+
+        for (auto i = 0u; i < pointCount && match == pointCount; ++i)
+        {
+            if ((points[i].worldPoint - point.worldPoint).SizeSquared() < BreakingThreshold * BreakingThreshold)
+            {
+                match = i;
+            }
+        }
+
+        if (match < pointCount)
+        {
+            points[match] = point;
+        }
+        else
+        {
+            AddPoint(point);
+        }
+    }
+
+    // Remember where the bodies were for deciding when to test again.
+    for (auto i = 0u; i < 2; ++i)
+    {
+        if (primitive[i]->body != nullptr)
+        {
+            testedPosition[i] = primitive[i]->body->GetPosition();
+
+            testedOrientation[i] = primitive[i]->body->GetOrientation();
+        }
+    }
+
+    bTested = true;
+}
+
+unsigned ContactManifold::WriteContacts(CollisionData* data) const
+{
+    auto written = 0u;
+
+    for (auto i = 0u; i < pointCount && data->HasMoreContacts(); ++i)
+    {
+        const auto& point = points[i];
+
+        auto contact = data->contacts;
+
+        contact->contactPoint = point.worldPoint;
+
+        contact->contactNormal = point.normal;
+
+        contact->penetration = point.penetration;
+
+        contact->SetBodyData(body[0], body[1], data->friction, data->restitution, point.feature);
+
+        data->AddContacts(1);
+
+        ++written;
+    }
+
+    return written;
+}
+
+unsigned ContactManifold::GetPointCount() const
+{
+    return pointCount;
+}
+
+const ManifoldPoint& ContactManifold::GetPoint(const unsigned index) const
+{
+    return points[index];
+}
+
+void ContactManifold::AddPoint(const ManifoldPoint& point)
+{
+    if (pointCount < MaxPoints)
+    {
+        points[pointCount++] = point;
+
+        return;
+    }
+
+    points[FindPointToDrop(point)] = point;
+}
+
+unsigned ContactManifold::FindPointToDrop(const ManifoldPoint& point) const
+{
+    // The deepest point is always kept, unless the new one is deeper.
+    auto deepest = MaxPoints;
+
+    auto maxPenetration = point.penetration;
+
+    for (auto i = 0u; i < MaxPoints; ++i)
+    {
+        if (points[i].penetration > maxPenetration)
+        {
+            maxPenetration = points[i].penetration;
+
+            deepest = i;
+        }
+    }
+
+    // Of the others, drop the one whose replacement by the new point
+    // leaves the largest area. The area of four points is measured by
+    // the largest cross product of a pair of their diagonals.
+    auto drop = 0u;
+
+    real maxArea = -1.f;
+
+    for (auto i = 0u; i < MaxPoints; ++i)
+    {
+        if (i == deepest)
+        {
+            continue;
+        }
+
+        Vector3 corners[MaxPoints];
+
+        for (auto j = 0u; j < MaxPoints; ++j)
+        {
+            corners[j] = j == i ? point.worldPoint : points[j].worldPoint;
+        }
+
+        auto area = ((corners[0] - corners[1]) ^ (corners[2] - corners[3])).SizeSquared();
+
+        area = std::max<real>(area, ((corners[0] - corners[2]) ^ (corners[1] - corners[3])).SizeSquared());
+
+        area = std::max<real>(area, ((corners[0] - corners[3]) ^ (corners[1] - corners[2])).SizeSquared());
+
+        if (area > maxArea)
+        {
+            maxArea = area;
+
+            drop = i;
+        }
+    }
+
+    return drop;
+}
+
+Vector3 ContactManifold::ToLocal(const RigidBody* body, const Vector3& point)
+{
+    return body != nullptr ? body->GetPointInLocalSpace(point) : point;
+}
+
+Vector3 ContactManifold::ToWorld(const RigidBody* body, const Vector3& point)
+{
+    return body != nullptr ? body->GetPointInWorldSpace(point) : point;
+}
+
+ContactManifoldCache::ContactManifoldCache(): frame(0)
+{
+}
+
+void ContactManifoldCache::BeginFrame()
+{
+    ++frame;
+}
+
+void ContactManifoldCache::EndFrame()
+{
+    for (auto manifold = manifolds.begin(); manifold != manifolds.end();)
+    {
+        if (manifold->second.lastFrame != frame)
+        {
+            manifold = manifolds.erase(manifold);
+        }
+        else
+        {
+            ++manifold;
+        }
+    }
+}
+
+ContactManifold& ContactManifoldCache::Find(const CollisionPrimitive* one, const CollisionPrimitive* two)
+{
+    const auto key = Key(one, two);
+
+    auto found = manifolds.find(key);
+
+    if (found == manifolds.end())
+    {
+        found = manifolds.emplace(std::piecewise_construct, std::forward_as_tuple(key),
+                                  std::forward_as_tuple(one, two)).first;
+    }
+
+    auto& manifold = found->second;
+
+    manifold.lastFrame = frame;
+
+    return manifold;
+}
+
+void ContactManifoldCache::Clear()
+{
+    manifolds.clear();
+}
+
+unsigned ContactManifoldCache::GetManifoldCount() const
+{
+    return static_cast<unsigned>(manifolds.size());
+}
+
+size_t ContactManifoldCache::KeyHash::operator()(const Key& key) const
+{
+    const auto one = std::hash<const void*>()(key.first);
+
+    const auto two = std::hash<const void*>()(key.second);
+
+    return one ^ (two + 0x9e3779b9 + (one << 6) + (one >> 2));
+}
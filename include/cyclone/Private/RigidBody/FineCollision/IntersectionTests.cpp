@@ -1,4 +1,5 @@
 #include "RigidBody/FineCollision/IntersectionTests.h"
+#include <algorithm>
 #include <cmath>
 
 using namespace cyclone;
@@ -37,7 +38,7 @@ static bool OverlapOnAxis(const CollisionBox& one, const CollisionBox& two, cons
 bool IntersectionTests::SphereAndHalfSpace(const CollisionSphere& sphere, const CollisionPlane& plane)
 {
     // Find the distance from the origin
-    const auto ballDistance = plane.direction | sphere.GetAxis(3) - sphere.radius;
+    const auto ballDistance = (plane.direction | sphere.GetAxis(3)) - sphere.radius;
 
     // Check for the intersection
     return ballDistance <= plane.offset;
@@ -94,14 +95,223 @@ bool IntersectionTests::BoxAndBox(const CollisionBox& one, const CollisionBox& t
 
 #undef TEST_OVERLAP
 
+bool IntersectionTests::BoxAndSphere(const CollisionBox& box, const CollisionSphere& sphere)
+{
+    // Clamp the centre of the sphere to the box, in the box's coordinates
+    const auto centre = box.GetTransform().InverseTransformPosition(sphere.GetAxis(3));
+
+    auto distanceSquared = static_cast<real>(0.f);
+
+    for (auto i = 0u; i < 3; ++i)
+    {
+        const auto outside = real_abs(centre[i]) - box.halfSize[i];
+
+        if (outside > 0)
+        {
+            distanceSquared += outside * outside;
+        }
+    }
+
+    return distanceSquared < sphere.radius * sphere.radius;
+}
+
+bool IntersectionTests::PrimitiveAndPrimitive(const CollisionPrimitive& one, const CollisionPrimitive& two)
+{
+    if (one.GetType() == PrimitiveType::Sphere)
+    {
+        if (two.GetType() == PrimitiveType::Sphere)
+        {
+            return SphereAndSphere(static_cast<const CollisionSphere&>(one), static_cast<const CollisionSphere&>(two));
+        }
+
+        return BoxAndSphere(static_cast<const CollisionBox&>(two), static_cast<const CollisionSphere&>(one));
+    }
+
+    if (two.GetType() == PrimitiveType::Sphere)
+    {
+        return BoxAndSphere(static_cast<const CollisionBox&>(one), static_cast<const CollisionSphere&>(two));
+    }
+
+    return BoxAndBox(static_cast<const CollisionBox&>(one), static_cast<const CollisionBox&>(two));
+}
+
 bool IntersectionTests::BoxAndHalfSpace(const CollisionBox& box, const CollisionPlane& plane)
 {
     // Work out the projected radius of the box onto the plane direction
     const auto projectedRadius = TransformToAxis(box, plane.direction);
 
     // Work out how far the box is from the origin
-    const auto boxDistance = plane.direction | box.GetAxis(3) - projectedRadius;
+    const auto boxDistance = (plane.direction | box.GetAxis(3)) - projectedRadius;
 
     // Check for the intersection
     return boxDistance <= plane.offset;
 }
+
+/**
+* Fills in a hit at the given distance along the ray.
+*/
+static bool WriteRayHit(const Ray& ray, const CollisionPrimitive& primitive, const real distance,
+                        const Vector3& normal, RayHit* hit)
+{
+    hit->body = primitive.body;
+
+    hit->primitive = const_cast<CollisionPrimitive*>(&primitive);
+
+    hit->distance = distance;
+
+    hit->point = ray.origin + ray.direction * distance;
+
+    hit->normal = normal;
+
+    return true;
+}
+
+bool IntersectionTests::RayAndSphere(const Ray& ray, const CollisionSphere& sphere, RayHit* hit)
+{
+    // Solve |origin + t * direction - centre| = radius for t.
+    const auto toOrigin = ray.origin - sphere.GetAxis(3);
+
+    const auto c = (toOrigin | toOrigin) - sphere.radius * sphere.radius;
+
+    if (c <= 0)
+    {
+        return WriteRayHit(ray, sphere, 0, ray.direction * -1, hit);
+    }
+
+    const auto b = toOrigin | ray.direction;
+
+    const auto discriminant = b * b - c;
+
+    // Heading away from the sphere, or passing it by
+    if (b >= 0 || discriminant < 0)
+    {
+        return false;
+    }
+
+    const auto distance = -b - real_sqrt(discriminant);
+
+    if (distance > ray.maxDistance)
+    {
+        return false;
+    }
+
+    auto normal = ray.origin + ray.direction * distance - sphere.GetAxis(3);
+
+    normal.Normalize();
+
+    return WriteRayHit(ray, sphere, distance, normal, hit);
+}
+
+bool IntersectionTests::RayAndBox(const Ray& ray, const CollisionBox& box, RayHit* hit)
+{
+    const auto& transform = box.GetTransform();
+
+    const auto origin = transform.InverseTransformPosition(ray.origin);
+
+    const auto direction = transform.InverseTransformVector(ray.direction);
+
+    auto entry = real(0);
+
+    auto exit = ray.maxDistance;
+
+    auto entryAxis = 3u;
+
+    auto entrySign = real(0);
+
+    for (auto i = 0u; i < 3; ++i)
+    {
+        // Parallel to this pair of faces, so it must start between them.
+        if (real_abs(direction[i]) < real_epsilon)
+        {
+            if (real_abs(origin[i]) > box.halfSize[i])
+            {
+                return false;
+            }
+
+            continue;
+        }
+
+        const auto inverse = 1 / direction[i];
+
+        auto nearDistance = (-box.halfSize[i] - origin[i]) * inverse;
+
+        auto farDistance = (box.halfSize[i] - origin[i]) * inverse;
+
+        auto sign = real(-1);
+
+        if (nearDistance > farDistance)
+        {
+            std::swap(nearDistance, farDistance);
+
+            sign = 1;
+        }
+
+        if (nearDistance > entry)
+        {
+            entry = nearDistance;
+
+            entryAxis = i;
+
+            entrySign = sign;
+        }
+
+        exit = std::min(exit, farDistance);
+
+        if (entry > exit)
+        {
+            return false;
+        }
+    }
+
+    // Never crossed a face on the way in, so it started inside.
+    if (entryAxis == 3)
+    {
+        return WriteRayHit(ray, box, 0, ray.direction * -1, hit);
+    }
+
+    return WriteRayHit(ray, box, entry, box.GetAxis(entryAxis) * entrySign, hit);
+}
+
+bool IntersectionTests::RayAndHalfSpace(const Ray& ray, const CollisionPlane& plane, RayHit* hit)
+{
+    const auto height = (plane.direction | ray.origin) - plane.offset;
+
+    if (height <= 0)
+    {
+        return WriteRayHit(ray, plane, 0, ray.direction * -1, hit);
+    }
+
+    const auto speed = plane.direction | ray.direction;
+
+    // Running parallel to the plane, or away from it
+    if (speed >= 0)
+    {
+        return false;
+    }
+
+    const auto distance = -height / speed;
+
+    if (distance > ray.maxDistance)
+    {
+        return false;
+    }
+
+    return WriteRayHit(ray, plane, distance, plane.direction, hit);
+}
+
+bool IntersectionTests::RayAndPrimitive(const Ray& ray, const CollisionPrimitive& primitive, RayHit* hit)
+{
+    switch (primitive.GetType())
+    {
+    case PrimitiveType::Box:
+        return RayAndBox(ray, static_cast<const CollisionBox&>(primitive), hit);
+
+    case PrimitiveType::Sphere:
+        return RayAndSphere(ray, static_cast<const CollisionSphere&>(primitive), hit);
+
+    case PrimitiveType::Plane:
+        return RayAndHalfSpace(ray, static_cast<const CollisionPlane&>(primitive), hit);
+    }
+
+    return false;
+}
@@ -0,0 +1,319 @@
+#include "RigidBody/FineCollision/TimeOfImpact.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace cyclone;
+
+namespace
+{
+    Vector3 GetColumn(const Matrix3x4& transform, const unsigned index)
+    {
+        return Vector3(transform.M[0][index], transform.M[1][index], transform.M[2][index]);
+    }
+
+    /**
+    * Returns how far the box reaches along the given unit axis.
+    */
+    real ProjectBox(const Vector3& halfSize, const Matrix3x4& transform, const Vector3& axis)
+    {
+        return halfSize.x * real_abs(axis | GetColumn(transform, 0)) +
+            halfSize.y * real_abs(axis | GetColumn(transform, 1)) +
+            halfSize.z * real_abs(axis | GetColumn(transform, 2));
+    }
+
+    /*
+    * Each of these also writes the direction in which moving the first
+    * primitive opens the gap fastest.
+    */
+    real SphereAndSphere(const CollisionSphere& one, const Matrix3x4& oneTransform, const CollisionSphere& two,
+                         const Matrix3x4& twoTransform, Vector3& normal)
+    {
+        normal = GetColumn(oneTransform, 3) - GetColumn(twoTransform, 3);
+
+        const auto distance = normal.Size();
+
+        normal.Normalize();
+
+        return distance - one.radius - two.radius;
+    }
+
+    real BoxAndSphere(const CollisionBox& box, const Matrix3x4& boxTransform, const CollisionSphere& sphere,
+                      const Matrix3x4& sphereTransform, Vector3& normal)
+    {
+        const auto centre = boxTransform.InverseTransformPosition(GetColumn(sphereTransform, 3));
+
+        Vector3 outside;
+
+        auto inside = REAL_MAX;
+
+        auto nearest = 0u;
+
+        for (auto i = 0u; i < 3; ++i)
+        {
+            const auto depth = box.halfSize[i] - real_abs(centre[i]);
+
+            // Pointing from the sphere towards the box.
+            const auto away = centre[i] < 0 ? -depth : depth;
+
+            if (depth < 0)
+            {
+                outside[i] = away;
+            }
+
+            if (depth < inside)
+            {
+                inside = depth;
+
+                nearest = i;
+            }
+        }
+
+        // Inside the box the centre is as deep as its nearest face.
+        if (inside >= 0)
+        {
+            normal = centre[nearest] < 0 ? GetColumn(boxTransform, nearest) : -GetColumn(boxTransform, nearest);
+
+            return -inside - sphere.radius;
+        }
+
+        normal = boxTransform.TransformVector(outside);
+
+        const auto distance = normal.Size();
+
+        normal.Normalize();
+
+        return distance - sphere.radius;
+    }
+
+    real BoxAndBox(const CollisionBox& one, const Matrix3x4& oneTransform, const CollisionBox& two,
+                   const Matrix3x4& twoTransform, Vector3& normal)
+    {
+        const auto toCentre = GetColumn(twoTransform, 3) - GetColumn(oneTransform, 3);
+
+        auto separation = -REAL_MAX;
+
+        const auto checkAxis = [&](const Vector3& axis)
+        {
+            const auto centreGap = toCentre | axis;
+
+            const auto gap = real_abs(centreGap) - ProjectBox(one.halfSize, oneTransform, axis) -
+                ProjectBox(two.halfSize, twoTransform, axis);
+
+            if (gap > separation)
+            {
+                separation = gap;
+
+                normal = centreGap < 0 ? axis : -axis;
+            }
+        };
+
+        for (auto i = 0u; i < 3; ++i)
+        {
+            checkAxis(GetColumn(oneTransform, i));
+
+            checkAxis(GetColumn(twoTransform, i));
+        }
+
+        // Edges that are nearly parallel give no axis worth checking.
+        for (auto i = 0u; i < 3; ++i)
+        {
+            for (auto j = 0u; j < 3; ++j)
+            {
+                auto axis = GetColumn(oneTransform, i) ^ GetColumn(twoTransform, j);
+
+                if ((axis | axis) < 0.001f)
+                {
+                    continue;
+                }
+
+                axis.Normalize();
+
+                checkAxis(axis);
+            }
+        }
+
+        return separation;
+    }
+
+    real PrimitiveAndPlane(const CollisionPrimitive& primitive, const Matrix3x4& transform,
+                           const CollisionPlane& plane, Vector3& normal)
+    {
+        normal = plane.direction;
+
+        const auto distance = (GetColumn(transform, 3) | plane.direction) - plane.offset;
+
+        if (primitive.GetType() == PrimitiveType::Box)
+        {
+            const auto& box = static_cast<const CollisionBox&>(primitive);
+
+            return distance - ProjectBox(box.halfSize, transform, plane.direction);
+        }
+
+        return distance - static_cast<const CollisionSphere&>(primitive).radius;
+    }
+}
+
+Vector3 BodySweep::GetPosition(const real fraction) const
+{
+    return position + velocity * (duration * fraction);
+}
+
+Quaternion BodySweep::GetOrientation(const real fraction) const
+{
+    const auto time = duration * fraction;
+
+    // Turn the orientation the way the integrator does.
+    const auto x = rotation.x * time;
+
+    const auto y = rotation.y * time;
+
+    const auto z = rotation.z * time;
+
+    auto q = orientation;
+
+    q.i = orientation.i + (x * orientation.a - z * orientation.j + y * orientation.k) * 0.5f;
+
+    q.j = orientation.j + (y * orientation.a + z * orientation.i - x * orientation.k) * 0.5f;
+
+    q.k = orientation.k + (z * orientation.a - y * orientation.i + x * orientation.j) * 0.5f;
+
+    q.a = orientation.a + (-x * orientation.i - y * orientation.j - z * orientation.k) * 0.5f;
+
+    q.Normalize();
+
+    return q;
+}
+
+Matrix3x4 BodySweep::GetTransform(const real fraction) const
+{
+    const auto q = GetOrientation(fraction);
+
+    return Matrix3x4(Matrix3(1 - 2 * q.j * q.j - 2 * q.k * q.k, 2 * q.i * q.j - 2 * q.a * q.k,
+                             2 * q.i * q.k + 2 * q.a * q.j,
+                             2 * q.i * q.j + 2 * q.a * q.k, 1 - 2 * q.i * q.i - 2 * q.k * q.k,
+                             2 * q.j * q.k - 2 * q.a * q.i,
+                             2 * q.i * q.k - 2 * q.a * q.j, 2 * q.j * q.k + 2 * q.a * q.i,
+                             1 - 2 * q.i * q.i - 2 * q.j * q.j), GetPosition(fraction));
+}
+
+real TimeOfImpact::GetSeparation(const CollisionPrimitive& one, const Matrix3x4& oneTransform,
+                                 const CollisionPrimitive& two, const Matrix3x4& twoTransform, Vector3* normal)
+{
+    Vector3 direction;
+
+    auto separation = static_cast<real>(0.f);
+
+    if (one.GetType() == PrimitiveType::Plane)
+    {
+        separation = GetSeparation(two, twoTransform, one, oneTransform, &direction);
+
+        direction = -direction;
+    }
+    else if (two.GetType() == PrimitiveType::Plane)
+    {
+        separation = PrimitiveAndPlane(one, oneTransform, static_cast<const CollisionPlane&>(two), direction);
+    }
+    else if (one.GetType() == PrimitiveType::Sphere)
+    {
+        if (two.GetType() == PrimitiveType::Sphere)
+        {
+            separation = SphereAndSphere(static_cast<const CollisionSphere&>(one), oneTransform,
+                                         static_cast<const CollisionSphere&>(two), twoTransform, direction);
+        }
+        else
+        {
+            separation = BoxAndSphere(static_cast<const CollisionBox&>(two), twoTransform,
+                                      static_cast<const CollisionSphere&>(one), oneTransform, direction);
+
+            direction = -direction;
+        }
+    }
+    else if (two.GetType() == PrimitiveType::Sphere)
+    {
+        separation = BoxAndSphere(static_cast<const CollisionBox&>(one), oneTransform,
+                                  static_cast<const CollisionSphere&>(two), twoTransform, direction);
+    }
+    else
+    {
+        separation = BoxAndBox(static_cast<const CollisionBox&>(one), oneTransform,
+                               static_cast<const CollisionBox&>(two), twoTransform, direction);
+    }
+
+    if (normal != nullptr)
+    {
+        *normal = direction;
+    }
+
+    return separation;
+}
+
+real TimeOfImpact::GetMotionRadius(const CollisionPrimitive& primitive)
+{
+    // A sphere is only as far from where it is as its centre is.
+    const auto offset = GetColumn(primitive.offset, 3).Size();
+
+    if (primitive.GetType() == PrimitiveType::Box)
+    {
+        return offset + static_cast<const CollisionBox&>(primitive).halfSize.Size();
+    }
+
+    return offset;
+}
+
+bool TimeOfImpact::Sweep(const CollisionPrimitive& moving, const BodySweep& sweep, const CollisionPrimitive& other,
+                         const real targetSeparation, const real tolerance, real* fraction)
+{
+    const auto displacement = sweep.velocity * sweep.duration;
+
+    // The most spinning can add to how fast the separation shrinks.
+    const auto turningBound = (sweep.rotation * sweep.duration).Size() * GetMotionRadius(moving);
+
+    auto time = static_cast<real>(0.f);
+
+    for (auto i = 0u; i < MaxIterations; ++i)
+    {
+        Vector3 normal;
+
+        const auto separation = GetSeparation(moving, sweep.GetTransform(time) * moving.offset, other,
+                                              other.GetTransform(), &normal);
+
+        const auto remaining = separation - targetSeparation;
+
+        if (remaining <= tolerance)
+        {
+            if (fraction != nullptr)
+            {
+                *fraction = time;
+            }
+
+            return true;
+        }
+
+        // The separation only ever grows faster than it does here as the
+        // primitive moves in a straight line, so its speed towards the
+        // other now bounds how fast the gap can close.
+        const auto closingBound = turningBound - (displacement | normal);
+
+        if (closingBound <= 0)
+        {
+            return false;
+        }
+
+        time += remaining / closingBound;
+
+        if (time > 1)
+        {
+            return false;
+        }
+    }
+
+    // Only a primitive grazing the other closes in this slowly. It is
+    // still coming closer, so stop it where it is rather than let it
+    // through.
+    if (fraction != nullptr)
+    {
+        *fraction = time;
+    }
+
+    return true;
+}
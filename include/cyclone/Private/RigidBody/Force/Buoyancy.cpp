@@ -10,8 +10,20 @@ Buoyancy::Buoyancy(const Vector3& centreOfBuoyancy, const real maxDepth, const r
 
 void Buoyancy::UpdateForce(RigidBody* body, const real deltaTime)
 {
-    if (body != nullptr)
+    Buoyancy::UpdateForces(&body, 1, deltaTime);
+}
+
+void Buoyancy::UpdateForces(RigidBody* const* bodies, const unsigned count, const real deltaTime)
+{
+    for (auto i = 0u; i < count; ++i)
     {
+        const auto body = bodies[i];
+
+        if (body == nullptr)
+        {
+            continue;
+        }
+
         // Calculate the submersion depth
         const auto pointInWorld = body->GetPointInWorldSpace(centreOfBuoyancy);
 
@@ -20,7 +32,7 @@ void Buoyancy::UpdateForce(RigidBody* body, const real deltaTime)
         // Check if we're out of the water
         if (depth >= waterHeight + maxDepth)
         {
-            return;
+            continue;
         }
 
         Vector3 force(0.f, 0.f, 0.f);
@@ -29,14 +41,12 @@ void Buoyancy::UpdateForce(RigidBody* body, const real deltaTime)
         if (depth <= waterHeight - maxDepth)
         {
             force.y = liquidDensity * volume;
-
-            body->AddForceAtBodyPoint(force, centreOfBuoyancy);
-
-            return;
         }
-
-        // Otherwise we are partly submerged
-        force.y = liquidDensity * volume * (depth - maxDepth - waterHeight) / 2 * maxDepth;
+        else
+        {
+            // Otherwise we are partly submerged
+            force.y = liquidDensity * volume * (depth - maxDepth - waterHeight) / 2 * maxDepth;
+        }
 
         body->AddForceAtBodyPoint(force, centreOfBuoyancy);
     }
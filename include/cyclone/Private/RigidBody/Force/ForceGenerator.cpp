@@ -0,0 +1,11 @@
+#include "RigidBody/Force/ForceGenerator.h"
+
+using namespace cyclone;
+
+void ForceGenerator::UpdateForces(RigidBody* const* bodies, const unsigned count, const real deltaTime)
+{
+    for (auto i = 0u; i < count; ++i)
+    {
+        UpdateForce(bodies[i], deltaTime);
+    }
+}
@@ -8,12 +8,20 @@ Gravity::Gravity(const Vector3& gravity): gravity(gravity)
 
 void Gravity::UpdateForce(RigidBody* body, const real deltaTime)
 {
-    if (body != nullptr)
+    Gravity::UpdateForces(&body, 1, deltaTime);
+}
+
+void Gravity::UpdateForces(RigidBody* const* bodies, const unsigned count, const real deltaTime)
+{
+    for (auto i = 0u; i < count; ++i)
     {
-        // Check that we do not have infinite mass
-        if (!body->HasFiniteMass())
+        const auto body = bodies[i];
+
+        // Check that we do not have infinite mass. Sleeping bodies are
+        // left alone too, as adding the force would wake them again.
+        if (body == nullptr || !body->HasFiniteMass() || !body->GetAwake())
         {
-            return;
+            continue;
         }
 
         // Apply the mass-scaled force to the body
@@ -13,13 +13,31 @@ Spring::Spring(const Vector3& localConnectionPoint, RigidBody* other, const Vect
 
 void Spring::UpdateForce(RigidBody* body, const real deltaTime)
 {
-    if (body != nullptr && other != nullptr)
+    Spring::UpdateForces(&body, 1, deltaTime);
+}
+
+void Spring::UpdateForces(RigidBody* const* bodies, const unsigned count, const real deltaTime)
+{
+    if (other == nullptr)
+    {
+        return;
+    }
+
+    // The other end is the same for every body.
+    const auto otherWorldSpace = other->GetPointInWorldSpace(otherConnectionPoint);
+
+    for (auto i = 0u; i < count; ++i)
     {
+        const auto body = bodies[i];
+
+        if (body == nullptr)
+        {
+            continue;
+        }
+
         // Calculate the two ends in world space
         const auto localWorldSpace = body->GetPointInWorldSpace(connectionPoint);
 
-        const auto otherWorldSpace = other->GetPointInWorldSpace(otherConnectionPoint);
-
         // Calculate the vector of the spring
         auto force = localWorldSpace - otherWorldSpace;
 
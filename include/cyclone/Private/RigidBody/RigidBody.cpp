@@ -7,6 +7,60 @@ using namespace cyclone;
 
 real RigidBody::sleepEpsilon = 0.3f;
 
+namespace
+{
+    /**
+    * Remembers the damping factors worked out for one time step, so
+    * bodies sharing a damping share the call to real_pow. Bodies mostly
+    * use a handful of dampings, so a short list is searched in turn.
+    */
+    class DampingFactors
+    {
+    public:
+        explicit DampingFactors(const real deltaTime): deltaTime(deltaTime), count(0)
+        {
+        }
+
+        /**
+        * Returns the given damping raised to the power of the time step.
+        */
+        real Get(const real damping)
+        {
+            for (auto i = 0u; i < count; ++i)
+            {
+                if (dampings[i] == damping)
+                {
+                    return factors[i];
+                }
+            }
+
+            const auto factor = real_pow(damping, deltaTime);
+
+            if (count < Capacity)
+            {
+                dampings[count] = damping;
+
+                factors[count] = factor;
+
+                ++count;
+            }
+
+            return factor;
+        }
+
+    private:
+        static constexpr unsigned Capacity = 8;
+
+        real deltaTime;
+
+        real dampings[Capacity];
+
+        real factors[Capacity];
+
+        unsigned count;
+    };
+}
+
 RigidBody::RigidBody(): inverseMass(0), linearDamping(0), angularDamping(0), motion(0), isAwake(false), canSleep(false)
 {
 }
@@ -29,6 +83,34 @@ void RigidBody::Integrate(const real deltaTime)
         return;
     }
 
+    Integrate(deltaTime, real_pow(linearDamping, deltaTime), real_pow(angularDamping, deltaTime),
+              real_pow(0.5f, deltaTime));
+}
+
+void RigidBody::IntegrateBodies(RigidBody* bodies, const unsigned* indices, const unsigned count,
+                                const real deltaTime)
+{
+    DampingFactors dampingFactors(deltaTime);
+
+    const auto motionBias = real_pow(0.5f, deltaTime);
+
+    for (auto i = 0u; i < count; ++i)
+    {
+        auto& body = bodies[indices[i]];
+
+        if (!body.isAwake)
+        {
+            continue;
+        }
+
+        body.Integrate(deltaTime, dampingFactors.Get(body.linearDamping), dampingFactors.Get(body.angularDamping),
+                       motionBias);
+    }
+}
+
+void RigidBody::Integrate(const real deltaTime, const real linearDampingFactor, const real angularDampingFactor,
+                          const real motionBias)
+{
     // Calculate linear acceleration from force inputs.
     lastFrameAcceleration = acceleration;
 
@@ -45,20 +127,45 @@ void RigidBody::Integrate(const real deltaTime)
     rotation += angularAcceleration * deltaTime;
 
     // Impose drag.
-    velocity *= real_pow(linearDamping, deltaTime);
+    velocity *= linearDampingFactor;
 
-    rotation *= real_pow(angularDamping, deltaTime);
+    rotation *= angularDampingFactor;
 
     // Adjust positions
     // Update linear position.
     position += velocity * deltaTime;
 
-    // Update angular position.
-    orientation += rotation * deltaTime;
+    // Update angular position, by half the quaternion (0, w dt) times
+    // the orientation, worked out directly on the components.
+    const auto x = rotation.x * deltaTime;
+
+    const auto y = rotation.y * deltaTime;
+
+    const auto z = rotation.z * deltaTime;
+
+    const auto i = orientation.i;
+
+    const auto j = orientation.j;
+
+    const auto k = orientation.k;
+
+    const auto a = orientation.a;
+
+    orientation.i = i + (x * a - z * j + y * k) * 0.5f;
+
+    orientation.j = j + (y * a + z * i - x * k) * 0.5f;
+
+    orientation.k = k + (z * a - y * i + x * j) * 0.5f;
+
+    orientation.a = a + (-x * i - y * j - z * k) * 0.5f;
 
     // Normalize the orientation, and update the matrices with the new
     // position and orientation
-    CalculateDerivedData();
+    orientation.Normalize();
+
+    CalculateTransformMatrix(transformMatrix, position, orientation);
+
+    TransformInertiaTensor(inverseInertiaTensorWorld, inverseInertiaTensor, transformMatrix);
 
     // Clear accumulators.
     ClearAccumulators();
@@ -68,9 +175,7 @@ void RigidBody::Integrate(const real deltaTime)
     {
         const auto currentMotion = (velocity | velocity) + (rotation | rotation);
 
-        const auto bias = real_pow(0.5f, deltaTime);
-
-        motion = bias * motion + (1 - bias) * currentMotion;
+        motion = motionBias * motion + (1 - motionBias) * currentMotion;
 
         if (motion < sleepEpsilon)
         {
@@ -115,12 +220,12 @@ bool RigidBody::HasFiniteMass() const
     return inverseMass >= 0.f;
 }
 
-void RigidBody::SetInertiaTensor(const Matrix& inertiaTensor)
+void RigidBody::SetInertiaTensor(const Matrix3& inertiaTensor)
 {
     inverseInertiaTensor = inertiaTensor.Inverse();
 }
 
-void RigidBody::GetInertiaTensor(Matrix* inertiaTensor) const
+void RigidBody::GetInertiaTensor(Matrix3* inertiaTensor) const
 {
     if (inertiaTensor != nullptr)
     {
@@ -128,12 +233,12 @@ void RigidBody::GetInertiaTensor(Matrix* inertiaTensor) const
     }
 }
 
-Matrix RigidBody::GetInertiaTensor() const
+Matrix3 RigidBody::GetInertiaTensor() const
 {
     return inverseInertiaTensor.Inverse();
 }
 
-void RigidBody::GetInertiaTensorWorld(Matrix* inertiaTensor) const
+void RigidBody::GetInertiaTensorWorld(Matrix3* inertiaTensor) const
 {
     if (inertiaTensor != nullptr)
     {
@@ -141,17 +246,17 @@ void RigidBody::GetInertiaTensorWorld(Matrix* inertiaTensor) const
     }
 }
 
-Matrix RigidBody::GetInertiaTensorWorld() const
+Matrix3 RigidBody::GetInertiaTensorWorld() const
 {
     return inverseInertiaTensorWorld.Inverse();
 }
 
-void RigidBody::SetInverseInertiaTensor(const Matrix& inverseInertiaTensor)
+void RigidBody::SetInverseInertiaTensor(const Matrix3& inverseInertiaTensor)
 {
     RigidBody::inverseInertiaTensor = inverseInertiaTensor;
 }
 
-void RigidBody::GetInverseInertiaTensor(Matrix* inverseInertiaTensor) const
+void RigidBody::GetInverseInertiaTensor(Matrix3* inverseInertiaTensor) const
 {
     if (inverseInertiaTensor != nullptr)
     {
@@ -159,12 +264,12 @@ void RigidBody::GetInverseInertiaTensor(Matrix* inverseInertiaTensor) const
     }
 }
 
-Matrix RigidBody::GetInverseInertiaTensor() const
+Matrix3 RigidBody::GetInverseInertiaTensor() const
 {
     return inverseInertiaTensor;
 }
 
-void RigidBody::GetInverseInertiaTensorWorld(Matrix* inverseInertiaTensor) const
+void RigidBody::GetInverseInertiaTensorWorld(Matrix3* inverseInertiaTensor) const
 {
     if (inverseInertiaTensor != nullptr)
     {
@@ -172,7 +277,7 @@ void RigidBody::GetInverseInertiaTensorWorld(Matrix* inverseInertiaTensor) const
     }
 }
 
-Matrix RigidBody::GetInverseInertiaTensorWorld() const
+Matrix3 RigidBody::GetInverseInertiaTensorWorld() const
 {
     return inverseInertiaTensorWorld;
 }
@@ -262,15 +367,15 @@ Quaternion RigidBody::GetOrientation() const
     return orientation;
 }
 
-void RigidBody::GetOrientation(Matrix* matrix) const
+void RigidBody::GetOrientation(Matrix3* matrix) const
 {
     if (matrix != nullptr)
     {
-        *matrix = transformMatrix;
+        *matrix = transformMatrix.GetRotation();
     }
 }
 
-void RigidBody::GetTransform(Matrix* transform) const
+void RigidBody::GetTransform(Matrix3x4* transform) const
 {
     if (transform != nullptr)
     {
@@ -292,7 +397,7 @@ void RigidBody::GetGLTransform(float matrix[16]) const
 
     matrix[5] = transformMatrix.M[1][1];
 
-    matrix[6] = transformMatrix.M[1][2];
+    matrix[6] = transformMatrix.M[2][1];
 
     matrix[7] = 0;
 
@@ -313,7 +418,7 @@ void RigidBody::GetGLTransform(float matrix[16]) const
     matrix[15] = 1;
 }
 
-Matrix RigidBody::GetTransform() const
+Matrix3x4 RigidBody::GetTransform() const
 {
     return transformMatrix;
 }
@@ -441,6 +546,16 @@ void RigidBody::SetCanSleep(const bool canSleep)
     }
 }
 
+real RigidBody::GetMotion() const
+{
+    return motion;
+}
+
+real RigidBody::GetSleepEpsilon()
+{
+    return sleepEpsilon;
+}
+
 void RigidBody::GetLastFrameLinearAcceleration(Vector3* linearAcceleration) const
 {
     if (linearAcceleration != nullptr)
@@ -524,7 +639,7 @@ Vector3 RigidBody::GetAcceleration() const
     return acceleration;
 }
 
-void RigidBody::CalculateTransformMatrix(Matrix& transformMatrix, const Vector3& position,
+void RigidBody::CalculateTransformMatrix(Matrix3x4& transformMatrix, const Vector3& position,
                                          const Quaternion& orientation)
 {
     transformMatrix.M[0][0] = 1 - 2 * orientation.j * orientation.j - 2 * orientation.k * orientation.k;
@@ -550,75 +665,37 @@ void RigidBody::CalculateTransformMatrix(Matrix& transformMatrix, const Vector3&
     transformMatrix.M[2][2] = 1 - 2 * orientation.i * orientation.i - 2 * orientation.j * orientation.j;
 
     transformMatrix.M[2][3] = position.z;
-
-    transformMatrix.M[3][0] = transformMatrix.M[3][1] = transformMatrix.M[3][2] = 0;
-
-    transformMatrix.M[3][3] = 1.f;
 }
 
-void RigidBody::TransformInertiaTensor(Matrix& inverseInertiaTensorWorld, const Matrix& inverseInertiaTensorLocal,
-                                       const Matrix& transformMatrix)
+void RigidBody::TransformInertiaTensor(Matrix3& inverseInertiaTensorWorld, const Matrix3& inverseInertiaTensorLocal,
+                                       const Matrix3x4& transformMatrix)
 {
-    const auto t4 = transformMatrix.M[0][0] * inverseInertiaTensorLocal.M[0][0] + transformMatrix.M[0][1] *
-        inverseInertiaTensorLocal.M[1][0]
-        + transformMatrix.M[0][2] * inverseInertiaTensorLocal.M[2][0];
-
-    const auto t9 = transformMatrix.M[0][0] * inverseInertiaTensorLocal.M[0][1] + transformMatrix.M[0][1] *
-        inverseInertiaTensorLocal.M[1][1]
-        + transformMatrix.M[0][2] * inverseInertiaTensorLocal.M[2][1];
+    const auto& R = transformMatrix.M;
 
-    const auto t14 = transformMatrix.M[0][0] * inverseInertiaTensorLocal.M[0][2] + transformMatrix.M[0][1] *
-        inverseInertiaTensorLocal.M[1][2]
-        + transformMatrix.M[0][2] * inverseInertiaTensorLocal.M[2][2];
+    const auto& I = inverseInertiaTensorLocal.M;
 
-    const auto t28 = transformMatrix.M[1][0] * inverseInertiaTensorLocal.M[0][0] + transformMatrix.M[1][1] *
-        inverseInertiaTensorLocal.M[1][0]
-        + transformMatrix.M[1][2] * inverseInertiaTensorLocal.M[2][0];
+    // Rotate the rows of the tensor: T = R * I.
+    real T[3][3];
 
-    const auto t33 = transformMatrix.M[1][0] * inverseInertiaTensorLocal.M[0][1] + transformMatrix.M[1][1] *
-        inverseInertiaTensorLocal.M[1][1]
-        + transformMatrix.M[1][2] * inverseInertiaTensorLocal.M[2][1];
-
-    const auto t38 = transformMatrix.M[1][0] * inverseInertiaTensorLocal.M[0][2] + transformMatrix.M[1][1] *
-        inverseInertiaTensorLocal.M[1][2]
-        + transformMatrix.M[1][2] * inverseInertiaTensorLocal.M[2][2];
-
-    const auto t52 = transformMatrix.M[2][0] * inverseInertiaTensorLocal.M[0][0] + transformMatrix.M[2][1] *
-        inverseInertiaTensorLocal.M[1][0]
-        + transformMatrix.M[2][2] * inverseInertiaTensorLocal.M[2][0];
-
-    const auto t57 = transformMatrix.M[2][0] * inverseInertiaTensorLocal.M[0][1] + transformMatrix.M[2][1] *
-        inverseInertiaTensorLocal.M[1][1]
-        + transformMatrix.M[2][2] * inverseInertiaTensorLocal.M[2][1];
-
-    const auto t62 = transformMatrix.M[2][0] * inverseInertiaTensorLocal.M[0][2] + transformMatrix.M[2][1] *
-        inverseInertiaTensorLocal.M[1][2]
-        + transformMatrix.M[2][2] * inverseInertiaTensorLocal.M[2][2];
-
-    inverseInertiaTensorWorld.M[0][0] = t4 * transformMatrix.M[0][0] + t9 * transformMatrix.M[0][1] + t14 *
-        transformMatrix.M[0][2];
-
-    inverseInertiaTensorWorld.M[0][1] = t4 * transformMatrix.M[1][0] + t9 * transformMatrix.M[1][1] + t14 *
-        transformMatrix.M[1][2];
-
-    inverseInertiaTensorWorld.M[0][2] = t4 * transformMatrix.M[2][0] + t9 * transformMatrix.M[2][1] + t14 *
-        transformMatrix.M[2][2];
-
-    inverseInertiaTensorWorld.M[1][0] = t28 * transformMatrix.M[0][0] + t33 * transformMatrix.M[0][1] + t38 *
-        transformMatrix.M[0][2];
-
-    inverseInertiaTensorWorld.M[1][1] = t28 * transformMatrix.M[1][0] + t33 * transformMatrix.M[1][1] + t38 *
-        transformMatrix.M[1][2];
-
-    inverseInertiaTensorWorld.M[1][2] = t28 * transformMatrix.M[2][0] + t33 * transformMatrix.M[2][1] + t38 *
-        transformMatrix.M[2][2];
+    for (auto i = 0; i < 3; ++i)
+    {
+        for (auto j = 0; j < 3; ++j)
+        {
+            T[i][j] = R[i][0] * I[0][j] + R[i][1] * I[1][j] + R[i][2] * I[2][j];
+        }
+    }
 
-    inverseInertiaTensorWorld.M[2][0] = t52 * transformMatrix.M[0][0] + t57 * transformMatrix.M[0][1] + t62 *
-        transformMatrix.M[0][2];
+    // Then the columns: T * R^T. The result is symmetric, so only the
+    // upper triangle is worked out and mirrored into the lower one.
+    auto& W = inverseInertiaTensorWorld.M;
 
-    inverseInertiaTensorWorld.M[2][1] = t52 * transformMatrix.M[1][0] + t57 * transformMatrix.M[1][1] + t62 *
-        transformMatrix.M[1][2];
+    for (auto i = 0; i < 3; ++i)
+    {
+        for (auto j = i; j < 3; ++j)
+        {
+            W[i][j] = T[i][0] * R[j][0] + T[i][1] * R[j][1] + T[i][2] * R[j][2];
 
-    inverseInertiaTensorWorld.M[2][2] = t52 * transformMatrix.M[2][0] + t57 * transformMatrix.M[2][1] + t62 *
-        transformMatrix.M[2][2];
+            W[j][i] = W[i][j];
+        }
+    }
 }
@@ -0,0 +1,1178 @@
+#include "RigidBody/World.h"
+#include "RigidBody/FineCollision/IntersectionTests.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace cyclone;
+
+namespace
+{
+    /**
+    * Adds the bytes of a value to a 64 bit FNV-1a hash.
+    */
+    template <class Type>
+    void HashBytes(std::uint64_t& hash, const Type& value)
+    {
+        unsigned char bytes[sizeof(Type)];
+
+        std::memcpy(bytes, &value, sizeof(Type));
+
+        for (const auto byte : bytes)
+        {
+            hash = (hash ^ byte) * 1099511628211ull;
+        }
+    }
+
+    /**
+    * Adds the components of a vector to a hash, leaving out the padding.
+    */
+    void HashVector(std::uint64_t& hash, const Vector3& vector)
+    {
+        HashBytes(hash, vector.x);
+
+        HashBytes(hash, vector.y);
+
+        HashBytes(hash, vector.z);
+    }
+
+    /**
+    * The flags kept for each island while the islands are sorted out:
+    * whether its head has been seen, whether any of its bodies is asleep,
+    * and whether any of them is still moving.
+    */
+    constexpr unsigned char IslandSeen = 1;
+
+    constexpr unsigned char IslandAsleep = 2;
+
+    constexpr unsigned char IslandMoving = 4;
+
+    /**
+    * The bit the plane index starts at in the feature of a contact with
+    * a plane, above every feature number the box tests give.
+    */
+    constexpr unsigned PlaneFeatureShift = 16;
+}
+
+World::World(const unsigned maxBodies, const unsigned maxContacts, const unsigned iterations):
+    threadPool(nullptr),
+    bCalculateIterations(iterations == 0),
+    resolver(iterations),
+    contacts(new Contact[maxContacts]),
+    maxContacts(maxContacts), bPersistentContacts(true)
+{
+    bodies.reserve(maxBodies);
+
+    primitives.reserve(maxBodies);
+
+    proxies.reserve(maxBodies);
+
+    awakeBodies.reserve(maxBodies);
+
+    awakeFlags.reserve(maxBodies);
+
+    sleepingNext.reserve(maxBodies);
+
+    sleepingParents.reserve(maxBodies);
+
+    islandParents.reserve(maxBodies);
+
+    islandStates.reserve(maxBodies);
+
+    islandBodies.reserve(maxBodies);
+
+    bulletFlags.reserve(maxBodies);
+
+    queryProxies.resize(maxBodies);
+
+    boxes.reserve(maxBodies);
+
+    spheres.reserve(maxBodies);
+
+    planes.reserve(MaxPlanes);
+
+    collisionData.contactHead = contacts;
+
+    collisionData.friction = 0.9f;
+
+    collisionData.restitution = 0.2f;
+
+    collisionData.tolerance = 0.1f;
+
+    collisionData.Reset(maxContacts);
+}
+
+World::~World()
+{
+    if (contacts)
+    {
+        delete[] contacts;
+
+        contacts = nullptr;
+    }
+}
+
+RigidBody* World::AddBody()
+{
+    // Growing the array would move the bodies and invalidate the
+    // pointers held by primitives and force generators.
+    if (bodies.size() == bodies.capacity())
+    {
+        return nullptr;
+    }
+
+    bodies.emplace_back();
+
+    primitives.push_back(nullptr);
+
+    proxies.push_back(DynamicAABBTree::NullNode);
+
+    const auto index = static_cast<unsigned>(bodies.size() - 1);
+
+    awakeFlags.push_back(0);
+
+    sleepingNext.push_back(index);
+
+    sleepingParents.push_back(index);
+
+    islandParents.push_back(index);
+
+    islandStates.push_back(0);
+
+    bulletFlags.push_back(0);
+
+    return &bodies.back();
+}
+
+CollisionBox* World::AddBox(RigidBody* body, const Vector3& halfSize)
+{
+    const auto index = GetBodyIndex(body);
+
+    if (index == bodies.size() || primitives[index] != nullptr)
+    {
+        return nullptr;
+    }
+
+    boxes.emplace_back();
+
+    auto& box = boxes.back();
+
+    box.body = body;
+
+    box.offset.SetIdentity();
+
+    box.halfSize = halfSize;
+
+    box.CalculateInternals();
+
+    primitives[index] = &box;
+
+    proxies[index] = broadphase.Insert(body, BoundingBox::Enclosing(box), &box);
+
+    return &box;
+}
+
+CollisionSphere* World::AddSphere(RigidBody* body, const real radius)
+{
+    const auto index = GetBodyIndex(body);
+
+    if (index == bodies.size() || primitives[index] != nullptr)
+    {
+        return nullptr;
+    }
+
+    spheres.emplace_back();
+
+    auto& sphere = spheres.back();
+
+    sphere.body = body;
+
+    sphere.offset.SetIdentity();
+
+    sphere.radius = radius;
+
+    sphere.CalculateInternals();
+
+    primitives[index] = &sphere;
+
+    proxies[index] = broadphase.Insert(body, BoundingBox::Enclosing(sphere), &sphere);
+
+    return &sphere;
+}
+
+CollisionPlane* World::AddPlane(const Vector3& direction, const real offset)
+{
+    // As with the bodies, growing the array would move the planes and
+    // invalidate the pointers held by contacts and the manifold cache.
+    if (planes.size() == MaxPlanes)
+    {
+        return nullptr;
+    }
+
+    planes.emplace_back();
+
+    auto& plane = planes.back();
+
+    plane.body = nullptr;
+
+    plane.direction = direction;
+
+    plane.offset = offset;
+
+    return &plane;
+}
+
+void World::SetContactProperties(const real friction, const real restitution, const real tolerance)
+{
+    collisionData.friction = friction;
+
+    collisionData.restitution = restitution;
+
+    collisionData.tolerance = tolerance;
+}
+
+void World::SetBullet(RigidBody* body, const bool bBullet)
+{
+    const auto index = GetBodyIndex(body);
+
+    if (index < bodies.size())
+    {
+        bulletFlags[index] = bBullet;
+    }
+}
+
+void World::SetThreadPool(ThreadPool* threadPool)
+{
+    World::threadPool = threadPool;
+
+    resolver.SetThreadPool(threadPool);
+}
+
+void World::SetPersistentContacts(const bool bPersistentContacts)
+{
+    World::bPersistentContacts = bPersistentContacts;
+
+    manifolds.Clear();
+}
+
+void World::StartFrame()
+{
+    ParallelFor(static_cast<unsigned>(bodies.size()), [this](const unsigned i)
+    {
+        // Remove all forces from the accumulator
+        bodies[i].ClearAccumulators();
+
+        bodies[i].CalculateDerivedData();
+    });
+
+    UpdateBoxes();
+
+    UpdateSpheres();
+}
+
+void World::Integrate(const real deltaTime)
+{
+    UpdateAwakeBodies();
+
+    RecordBulletSweeps();
+
+    IntegrateBodies(deltaTime);
+
+    // Bring the primitives up to date with their bodies.
+    UpdateAwakePrimitives();
+
+    UpdateBroadphase(deltaTime);
+
+    SweepBullets(deltaTime);
+}
+
+unsigned World::GeneratePotentialContacts()
+{
+    potentialContacts.resize(maxContacts);
+
+    auto count = 0u;
+
+    // Two sleeping bodies cannot generate a contact that matters. When
+    // most of the world is asleep it is cheaper to look around each
+    // awake body than to walk every branch of the tree.
+    if (awakeBodies.size() * AwakeQueryRatio < bodies.size())
+    {
+        for (const auto index : awakeBodies)
+        {
+            if (primitives[index] == nullptr)
+            {
+                continue;
+            }
+
+            const auto found = broadphase.Query(broadphase.GetFatVolume(proxies[index]), queryProxies.data(),
+                                                static_cast<unsigned>(queryProxies.size()));
+
+            for (auto i = 0u; i < found && count < maxContacts; ++i)
+            {
+                const auto proxy = queryProxies[i];
+
+                const auto other = GetBodyIndex(broadphase.GetBody(proxy));
+
+                // Pairs of awake bodies are taken from the lower body.
+                if (other == index || (awakeFlags[other] && other < index))
+                {
+                    continue;
+                }
+
+                auto& potentialContact = potentialContacts[count++];
+
+                potentialContact.body[0] = &bodies[index];
+
+                potentialContact.body[1] = &bodies[other];
+
+                potentialContact.primitive[0] = primitives[index];
+
+                potentialContact.primitive[1] = broadphase.GetPrimitive(proxy);
+            }
+        }
+    }
+    else
+    {
+        const auto found = broadphase.GetPotentialContacts(potentialContacts.data(), maxContacts);
+
+        for (auto i = 0u; i < found; ++i)
+        {
+            const auto& potentialContact = potentialContacts[i];
+
+            if (!awakeFlags[GetBodyIndex(potentialContact.body[0])] &&
+                !awakeFlags[GetBodyIndex(potentialContact.body[1])])
+            {
+                continue;
+            }
+
+            potentialContacts[count++] = potentialContact;
+        }
+    }
+
+    potentialContacts.resize(count);
+
+    return count;
+}
+
+unsigned World::GenerateContacts()
+{
+    collisionData.Reset(maxContacts);
+
+    manifolds.BeginFrame();
+
+    RunCollisionTests();
+
+    // Forget the pairs that are no longer touching.
+    manifolds.EndFrame();
+
+    return collisionData.contactCount;
+}
+
+void World::Step(const real deltaTime)
+{
+    stepGraph.Clear();
+
+    // First apply the force generators
+    const auto forces = stepGraph.AddTask([this, deltaTime] { registry.UpdateForces(deltaTime, threadPool); });
+
+    // Then integrate the objects that are awake, including those the
+    // forces have just woken.
+    const auto integrate = stepGraph.AddTask([this, deltaTime]
+    {
+        UpdateAwakeBodies();
+
+        RecordBulletSweeps();
+
+        IntegrateBodies(deltaTime);
+    }, { forces });
+
+    const auto updatePrimitives = stepGraph.AddTask([this] { UpdateAwakePrimitives(); }, { integrate });
+
+    const auto updateBroadphase = stepGraph.AddTask([this, deltaTime] { UpdateBroadphase(deltaTime); },
+                                                    { updatePrimitives });
+
+    // Stop the bullets where they first hit something
+    const auto sweepBullets = stepGraph.AddTask([this, deltaTime] { SweepBullets(deltaTime); },
+                                                { updateBroadphase });
+
+    // Generate contacts
+    const auto generate = stepGraph.AddTask([this] { GenerateContacts(); }, { sweepBullets });
+
+    // Process them
+    const auto resolve = stepGraph.AddTask([this, deltaTime]
+    {
+        const auto usedContacts = GetContactCount();
+
+        if (usedContacts)
+        {
+            if (bCalculateIterations)
+            {
+                resolver.SetIterations(usedContacts * 4);
+            }
+
+            resolver.ResolveContacts(contacts, usedContacts, deltaTime);
+        }
+    }, { generate });
+
+    // And put the islands that have settled to sleep
+    stepGraph.AddTask([this] { UpdateSleepingIslands(); }, { resolve });
+
+    stepGraph.Run(threadPool);
+}
+
+World::Bodies& World::GetBodies()
+{
+    return bodies;
+}
+
+World::Boxes& World::GetBoxes()
+{
+    return boxes;
+}
+
+World::Spheres& World::GetSpheres()
+{
+    return spheres;
+}
+
+World::Planes& World::GetPlanes()
+{
+    return planes;
+}
+
+World::ContactGenerators& World::GetContactGenerators()
+{
+    return contactGenerators;
+}
+
+ForceRegistry& World::GetForceRegistry()
+{
+    return registry;
+}
+
+ContactResolver& World::GetContactResolver()
+{
+    return resolver;
+}
+
+std::uint64_t World::GetStateHash() const
+{
+    std::uint64_t hash = 14695981039346656037ull;
+
+    for (const auto& body : bodies)
+    {
+        HashVector(hash, body.GetPosition());
+
+        const auto orientation = body.GetOrientation();
+
+        HashBytes(hash, orientation.a);
+
+        HashBytes(hash, orientation.i);
+
+        HashBytes(hash, orientation.j);
+
+        HashBytes(hash, orientation.k);
+
+        HashVector(hash, body.GetVelocity());
+
+        HashVector(hash, body.GetRotation());
+
+        HashBytes(hash, body.GetAwake());
+    }
+
+    return hash;
+}
+
+unsigned World::GetAwakeBodyCount() const
+{
+    return static_cast<unsigned>(awakeBodies.size());
+}
+
+unsigned World::RaycastAll(const Ray* rays, const unsigned count, RayHit* hits) const
+{
+    if (rays == nullptr || hits == nullptr)
+    {
+        return 0;
+    }
+
+    auto hitCount = broadphase.RaycastAll(rays, count, hits);
+
+    // The planes aren't in the broadphase, so are only tested against
+    // what is left of each ray.
+    for (auto i = 0u; i < count; ++i)
+    {
+        auto ray = rays[i];
+
+        ray.maxDistance = hits[i].distance;
+
+        const auto bHit = hits[i].primitive != nullptr;
+
+        auto bPlaneHit = false;
+
+        for (const auto& plane : planes)
+        {
+            if (IntersectionTests::RayAndHalfSpace(ray, plane, &hits[i]))
+            {
+                ray.maxDistance = hits[i].distance;
+
+                bPlaneHit = true;
+            }
+        }
+
+        hitCount += bPlaneHit && !bHit ? 1 : 0;
+    }
+
+    return hitCount;
+}
+
+unsigned World::Overlap(const CollisionPrimitive& shape, RigidBody** bodies, const unsigned limit) const
+{
+    return broadphase.Overlap(shape, bodies, limit);
+}
+
+unsigned World::Sweep(const CollisionPrimitive& shape, const Vector3& motion, SweepHit* hits,
+                      const unsigned limit) const
+{
+    return broadphase.Sweep(shape, motion, hits, limit);
+}
+
+Contact* World::GetContacts() const
+{
+    return contacts;
+}
+
+unsigned World::GetContactCount() const
+{
+    return collisionData.contactCount;
+}
+
+unsigned World::GetBodyIndex(const RigidBody* body) const
+{
+    if (body == nullptr || bodies.empty() || body < bodies.data() || body >= bodies.data() + bodies.size())
+    {
+        return static_cast<unsigned>(bodies.size());
+    }
+
+    return static_cast<unsigned>(body - bodies.data());
+}
+
+BoundingBox World::GetBoundingVolume(const CollisionPrimitive& primitive)
+{
+    if (primitive.GetType() == PrimitiveType::Box)
+    {
+        return BoundingBox::Enclosing(static_cast<const CollisionBox&>(primitive));
+    }
+
+    return BoundingBox::Enclosing(static_cast<const CollisionSphere&>(primitive));
+}
+
+void World::ParallelFor(const unsigned count, const ThreadPool::Task& task)
+{
+    if (threadPool == nullptr)
+    {
+        for (auto i = 0u; i < count; ++i)
+        {
+            task(i);
+        }
+
+        return;
+    }
+
+    threadPool->ParallelFor(count, task, BodiesPerJob);
+}
+
+void World::UpdateAwakeBodies()
+{
+    const auto count = static_cast<unsigned>(bodies.size());
+
+    // A body woken on its own, by a force or a contact, takes the rest of
+    // its island with it.
+    for (auto i = 0u; i < count; ++i)
+    {
+        if (bodies[i].GetAwake() && sleepingNext[i] != i)
+        {
+            WakeIsland(i);
+        }
+    }
+
+    awakeBodies.clear();
+
+    for (auto i = 0u; i < count; ++i)
+    {
+        awakeFlags[i] = bodies[i].GetAwake();
+
+        if (awakeFlags[i])
+        {
+            awakeBodies.push_back(i);
+        }
+    }
+}
+
+void World::WakeIsland(const unsigned index)
+{
+    auto body = index;
+
+    do
+    {
+        const auto next = sleepingNext[body];
+
+        sleepingNext[body] = body;
+
+        sleepingParents[body] = body;
+
+        if (!bodies[body].GetAwake())
+        {
+            bodies[body].SetAwake();
+        }
+
+        body = next;
+    }
+    while (body != index);
+}
+
+unsigned World::FindSleepingIsland(unsigned index)
+{
+    while (sleepingParents[index] != index)
+    {
+        // Halve the path on the way up.
+        sleepingParents[index] = sleepingParents[sleepingParents[index]];
+
+        index = sleepingParents[index];
+    }
+
+    return index;
+}
+
+void World::JoinSleepingIslands(const unsigned one, const unsigned another)
+{
+    const auto oneIsland = FindSleepingIsland(one);
+
+    const auto anotherIsland = FindSleepingIsland(another);
+
+    if (oneIsland == anotherIsland)
+    {
+        return;
+    }
+
+    // Swapping the links of a body in each of two rings makes one ring.
+    std::swap(sleepingNext[one], sleepingNext[another]);
+
+    sleepingParents[oneIsland] = anotherIsland;
+}
+
+unsigned World::FindIsland(unsigned index)
+{
+    while (islandParents[index] != index)
+    {
+        islandParents[index] = islandParents[islandParents[index]];
+
+        index = islandParents[index];
+    }
+
+    return index;
+}
+
+void World::UpdateSleepingIslands()
+{
+    const auto count = static_cast<unsigned>(bodies.size());
+
+    const auto usedContacts = GetContactCount();
+
+    // Join the bodies touching each other. Bodies that can't move don't
+    // join anything, or everything resting on the ground would be one
+    // island.
+    for (auto i = 0u; i < usedContacts; ++i)
+    {
+        const auto& contact = contacts[i];
+
+        const auto one = GetBodyIndex(contact.body[0]);
+
+        const auto another = GetBodyIndex(contact.body[1]);
+
+        if (one == count || another == count || !bodies[one].HasFiniteMass() || !bodies[another].HasFiniteMass())
+        {
+            continue;
+        }
+
+        for (const auto index : { one, another })
+        {
+            if (islandStates[index] == 0)
+            {
+                islandStates[index] = IslandSeen;
+
+                islandBodies.push_back(index);
+            }
+        }
+
+        const auto oneIsland = FindIsland(one);
+
+        const auto anotherIsland = FindIsland(another);
+
+        if (oneIsland != anotherIsland)
+        {
+            islandParents[oneIsland] = anotherIsland;
+        }
+    }
+
+    // A woken body starts with twice the sleep epsilon of motion, so a
+    // body is still moving if it has picked up more than that since.
+    const auto movingMotion = RigidBody::GetSleepEpsilon() * 2.f;
+
+    for (const auto index : islandBodies)
+    {
+        const auto& body = bodies[index];
+
+        auto& state = islandStates[FindIsland(index)];
+
+        if (!body.GetAwake())
+        {
+            state |= IslandAsleep;
+        }
+        else if (!body.GetCanSleep() || body.GetMotion() >= movingMotion)
+        {
+            state |= IslandMoving;
+        }
+    }
+
+    // Wake the sleeping bodies of the islands still moving, along with
+    // the rest of their sleeping islands.
+    for (const auto index : islandBodies)
+    {
+        const auto state = islandStates[FindIsland(index)];
+
+        if ((state & IslandMoving) && !bodies[index].GetAwake())
+        {
+            WakeIsland(index);
+        }
+    }
+
+    // Then put the islands where a body has fallen asleep and the rest
+    // are settling to sleep, joining them with the sleeping islands they
+    // touch. Islands that are all awake are left to the bodies' own
+    // sleep tests until one of them drops off.
+    for (const auto index : islandBodies)
+    {
+        const auto island = FindIsland(index);
+
+        if (islandStates[island] != (IslandSeen | IslandAsleep))
+        {
+            continue;
+        }
+
+        if (bodies[index].GetAwake())
+        {
+            bodies[index].SetAwake(false);
+        }
+
+        JoinSleepingIslands(index, island);
+    }
+
+    for (const auto index : islandBodies)
+    {
+        islandParents[index] = index;
+
+        islandStates[index] = 0;
+    }
+
+    islandBodies.clear();
+}
+
+void World::RecordBulletSweeps()
+{
+    bulletBodies.clear();
+
+    bulletSweeps.clear();
+
+    for (const auto index : awakeBodies)
+    {
+        if (!bulletFlags[index] || primitives[index] == nullptr)
+        {
+            continue;
+        }
+
+        BodySweep sweep;
+
+        sweep.position = bodies[index].GetPosition();
+
+        sweep.orientation = bodies[index].GetOrientation();
+
+        bulletBodies.push_back(index);
+
+        bulletSweeps.push_back(sweep);
+    }
+}
+
+void World::SweepBullets(const real deltaTime)
+{
+    for (auto i = 0u; i < bulletBodies.size(); ++i)
+    {
+        const auto index = bulletBodies[i];
+
+        auto& body = bodies[index];
+
+        auto& primitive = *primitives[index];
+
+        if (!body.GetAwake())
+        {
+            continue;
+        }
+
+        // The integrator moves the body with the velocity it ends with.
+        auto& sweep = bulletSweeps[i];
+
+        sweep.velocity = body.GetVelocity();
+
+        sweep.rotation = body.GetRotation();
+
+        sweep.duration = deltaTime;
+
+        const auto displacement = sweep.velocity * deltaTime;
+
+        const auto spin = (sweep.rotation * deltaTime).Size() * TimeOfImpact::GetMotionRadius(primitive);
+
+        auto first = static_cast<real>(1.f);
+
+        auto bHit = false;
+
+        // Anything the bullet is already touching is left to the
+        // contacts, so only impacts after the start count.
+        const auto sweepAgainst = [&](const CollisionPrimitive& other)
+        {
+            real fraction;
+
+            if (TimeOfImpact::Sweep(primitive, sweep, other, -BulletPenetration, BulletPenetration * 0.5f,
+                                    &fraction) && fraction > 0 && fraction < first)
+            {
+                first = fraction;
+
+                bHit = true;
+            }
+        };
+
+        for (const auto& plane : planes)
+        {
+            sweepAgainst(plane);
+        }
+
+        const auto path = GetBoundingVolume(primitive).Swept(-displacement).Expanded(spin);
+
+        const auto found = broadphase.Query(path, queryProxies.data(), static_cast<unsigned>(queryProxies.size()));
+
+        for (auto j = 0u; j < found; ++j)
+        {
+            if (broadphase.GetBody(queryProxies[j]) != &body)
+            {
+                sweepAgainst(*broadphase.GetPrimitive(queryProxies[j]));
+            }
+        }
+
+        if (!bHit)
+        {
+            continue;
+        }
+
+        body.SetPosition(sweep.GetPosition(first));
+
+        body.SetOrientation(sweep.GetOrientation(first));
+
+        body.CalculateDerivedData();
+
+        primitive.CalculateInternals();
+
+        broadphase.Move(proxies[index], GetBoundingVolume(primitive), displacement);
+    }
+}
+
+void World::IntegrateBodies(const real deltaTime)
+{
+    const auto count = static_cast<unsigned>(awakeBodies.size());
+
+    const auto jobCount = (count + BodiesPerJob - 1) / BodiesPerJob;
+
+    // Each job integrates its bodies as one batch, sharing the damping
+    // factors between them.
+    const auto integrateJob = [this, count, deltaTime](const unsigned job)
+    {
+        const auto first = job * BodiesPerJob;
+
+        const auto last = std::min(first + BodiesPerJob, count);
+
+        RigidBody::IntegrateBodies(bodies.data(), awakeBodies.data() + first, last - first, deltaTime);
+    };
+
+    if (threadPool != nullptr)
+    {
+        threadPool->ParallelFor(jobCount, integrateJob);
+    }
+    else
+    {
+        for (auto job = 0u; job < jobCount; ++job)
+        {
+            integrateJob(job);
+        }
+    }
+}
+
+void World::UpdateAwakePrimitives()
+{
+    ParallelFor(static_cast<unsigned>(awakeBodies.size()), [this](const unsigned i)
+    {
+        const auto primitive = primitives[awakeBodies[i]];
+
+        if (primitive != nullptr)
+        {
+            primitive->CalculateInternals();
+        }
+    });
+}
+
+void World::UpdateBoxes()
+{
+    ParallelFor(static_cast<unsigned>(boxes.size()), [this](const unsigned i)
+    {
+        boxes[i].CalculateInternals();
+    });
+}
+
+void World::UpdateSpheres()
+{
+    ParallelFor(static_cast<unsigned>(spheres.size()), [this](const unsigned i)
+    {
+        spheres[i].CalculateInternals();
+    });
+}
+
+void World::UpdateBroadphase(const real deltaTime)
+{
+    // Keep the broadphase in step, predicting where each body is headed.
+    // Leaves that still fit their fat boxes are left alone.
+    // Sleeping bodies don't move, so their leaves are left alone too.
+    for (const auto i : awakeBodies)
+    {
+        if (primitives[i] == nullptr)
+        {
+            continue;
+        }
+
+        broadphase.Move(proxies[i], GetBoundingVolume(*primitives[i]), bodies[i].GetVelocity() * deltaTime);
+    }
+}
+
+void World::RunCollisionTests()
+{
+    GatherCollisionPairs();
+
+    CollidePairs();
+
+    // Finally let the contact generators (joints, etc) add theirs.
+    for (const auto& contactGenerator : contactGenerators)
+    {
+        if (!collisionData.HasMoreContacts())
+        {
+            return;
+        }
+
+        const auto used = contactGenerator->AddContact(collisionData.contacts,
+                                                      static_cast<unsigned>(collisionData.contactsLeft));
+
+        collisionData.AddContacts(used);
+    }
+}
+
+void World::GatherCollisionPairs()
+{
+    collisionPairs.clear();
+
+    // Collide every awake primitive with the immovable scenery.
+    for (const auto index : awakeBodies)
+    {
+        const auto primitive = primitives[index];
+
+        if (primitive == nullptr)
+        {
+            continue;
+        }
+
+        for (auto& plane : planes)
+        {
+            PotentialContact pair;
+
+            pair.body[0] = primitive->body;
+
+            pair.body[1] = nullptr;
+
+            pair.primitive[0] = primitive;
+
+            pair.primitive[1] = &plane;
+
+            collisionPairs.push_back(pair);
+        }
+    }
+
+    // Then run the fine tests on the pairs that survived the coarse pass.
+    GeneratePotentialContacts();
+
+    collisionPairs.insert(collisionPairs.end(), potentialContacts.begin(), potentialContacts.end());
+
+    pairManifolds.resize(collisionPairs.size());
+
+    for (auto i = 0u; i < pairManifolds.size(); ++i)
+    {
+        const auto& pair = collisionPairs[i];
+
+        pairManifolds[i] = bPersistentContacts ? &manifolds.Find(pair.primitive[0], pair.primitive[1]) : nullptr;
+    }
+}
+
+void World::CollidePairs()
+{
+    const auto count = static_cast<unsigned>(collisionPairs.size());
+
+    const auto slabCount = (count + PairsPerSlab - 1) / PairsPerSlab;
+
+    slabs.resize(slabCount, collisionData);
+
+    slabContacts.resize(static_cast<size_t>(count) * MaxContactsPerPair);
+
+    const auto collideSlab = [this, count](const unsigned slab)
+    {
+        const auto first = slab * PairsPerSlab;
+
+        const auto last = std::min(first + PairsPerSlab, count);
+
+        auto& data = slabs[slab];
+
+        data = collisionData;
+
+        data.contactHead = &slabContacts[static_cast<size_t>(first) * MaxContactsPerPair];
+
+        data.Reset((last - first) * MaxContactsPerPair);
+
+        for (auto i = first; i < last; ++i)
+        {
+            const auto& pair = collisionPairs[i];
+
+            CollidePair(*pair.primitive[0], *pair.primitive[1], pairManifolds[i], &data);
+        }
+    };
+
+    if (threadPool != nullptr)
+    {
+        threadPool->ParallelFor(slabCount, collideSlab);
+    }
+    else
+    {
+        for (auto slab = 0u; slab < slabCount; ++slab)
+        {
+            collideSlab(slab);
+        }
+    }
+
+    // Copy the slabs in pair order, dropping what doesn't fit. Every
+    // pair is tested even so, which keeps the manifolds the same
+    // however the pairs are spread over the threads.
+    for (const auto& data : slabs)
+    {
+        const auto used = std::min(data.contactCount, static_cast<unsigned>(collisionData.contactsLeft));
+
+        std::copy(data.contactHead, data.contactHead + used, collisionData.contacts);
+
+        collisionData.AddContacts(used);
+    }
+}
+
+void World::CollidePair(const CollisionPrimitive& one, const CollisionPrimitive& two, ContactManifold* manifold,
+                        CollisionData* data) const
+{
+    if (manifold == nullptr)
+    {
+        CollidePrimitives(one, two, data);
+
+        return;
+    }
+
+    manifold->Refresh();
+
+    // Only test again once the bodies have moved, merging what the test
+    // finds into the points already held.
+    if (!manifold->CanReuse())
+    {
+        Contact found[MaxContactsPerPair];
+
+        auto foundData = *data;
+
+        foundData.contactHead = found;
+
+        foundData.Reset(MaxContactsPerPair);
+
+        CollidePrimitives(one, two, &foundData);
+
+        manifold->Merge(found, foundData.contactCount);
+    }
+
+    manifold->WriteContacts(data);
+}
+
+unsigned World::CollidePrimitives(const CollisionPrimitive& one, const CollisionPrimitive& two,
+                                  CollisionData* data) const
+{
+    if (two.GetType() == PrimitiveType::Plane)
+    {
+        const auto& plane = static_cast<const CollisionPlane&>(two);
+
+        const auto first = data->contacts;
+
+        auto count = 0u;
+
+        if (one.GetType() == PrimitiveType::Box)
+        {
+            count = CollisionDetector::BoxAndHalfSpace(static_cast<const CollisionBox&>(one), plane, data);
+        }
+        else if (one.GetType() == PrimitiveType::Sphere)
+        {
+            count = CollisionDetector::SphereAndHalfSpace(static_cast<const CollisionSphere&>(one), plane, data);
+        }
+
+        // Every plane leaves the second body null, so the plane is put
+        // into the feature to keep a body resting on two planes from
+        // warm starting one contact with the other's impulse.
+        const auto planeFeature = static_cast<unsigned>(&plane - planes.data() + 1) << PlaneFeatureShift;
+
+        for (auto i = 0u; i < count; ++i)
+        {
+            first[i].feature += planeFeature;
+        }
+
+        return count;
+    }
+
+    if (one.GetType() == PrimitiveType::Box)
+    {
+        if (two.GetType() == PrimitiveType::Box)
+        {
+            return CollisionDetector::BoxAndBox(static_cast<const CollisionBox&>(one),
+                                                static_cast<const CollisionBox&>(two), data);
+        }
+
+        if (two.GetType() == PrimitiveType::Sphere)
+        {
+            return CollisionDetector::BoxAndSphere(static_cast<const CollisionBox&>(one),
+                                                   static_cast<const CollisionSphere&>(two), data);
+        }
+    }
+    else if (one.GetType() == PrimitiveType::Sphere)
+    {
+        if (two.GetType() == PrimitiveType::Box)
+        {
+            return CollisionDetector::BoxAndSphere(static_cast<const CollisionBox&>(two),
+                                                   static_cast<const CollisionSphere&>(one), data);
+        }
+
+        if (two.GetType() == PrimitiveType::Sphere)
+        {
+            return CollisionDetector::SphereAndSphere(static_cast<const CollisionSphere&>(one),
+                                                      static_cast<const CollisionSphere&>(two), data);
+        }
+    }
+
+    return 0;
+}
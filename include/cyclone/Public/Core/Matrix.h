@@ -11,6 +11,10 @@ namespace cyclone
     * in other words, Res = Mat1.operator*(Mat2) means Res = Mat2^T * Mat1, as
     * opposed to Res = Mat1 * Mat2.
     * Matrix elements are accessed with M[RowIndex][ColumnIndex].
+    *
+    * Each row is four contiguous reals, so the products and the inverse
+    * transforms below are carried out on whole rows at a time in SIMD
+    * lanes.
     */
     class Matrix
     {
@@ -63,12 +67,12 @@ namespace cyclone
         * This isn't applying SCALE,
         * just multiplying the value to all members
         */
-        Matrix operator*(float scale);
+        Matrix operator*(real scale) const;
 
         /**
         * Multiply this matrix by a weighting factor.
         */
-        void operator*=(float scale);
+        void operator*=(real scale);
 
         /**
         * Checks whether two matrix are identical.
@@ -129,4 +133,74 @@ namespace cyclone
         */
         static void VectorMatrixInverse(void* dstMatrix, const void* srcMatrix);
     };
+
+    inline Matrix Matrix::operator*(const Matrix& m) const
+    {
+        const auto m0 = simd::Load(m.M[0]);
+
+        const auto m1 = simd::Load(m.M[1]);
+
+        const auto m2 = simd::Load(m.M[2]);
+
+        const auto m3 = simd::Load(m.M[3]);
+
+        Matrix result;
+
+        // Each row of the result is the rows of the other matrix weighted
+        // by the same row of this one.
+        for (auto i = 0; i < 4; ++i)
+        {
+            auto row = simd::Mul(simd::Splat(M[i][0]), m0);
+
+            row = simd::Add(row, simd::Mul(simd::Splat(M[i][1]), m1));
+
+            row = simd::Add(row, simd::Mul(simd::Splat(M[i][2]), m2));
+
+            row = simd::Add(row, simd::Mul(simd::Splat(M[i][3]), m3));
+
+            simd::Store(result.M[i], row);
+        }
+
+        return result;
+    }
+
+    inline Vector3 Matrix::operator*(const Vector3& v) const
+    {
+        return TransformPosition(v);
+    }
+
+    inline Vector3 Matrix::TransformVector(const Vector3& v) const
+    {
+        // Each component is a dot product with a row, and summing the
+        // lanes across costs what multiplying them together saves, so the
+        // forward transforms stay scalar.
+        return Vector3(v.x * M[0][0] + v.y * M[0][1] + v.z * M[0][2],
+                       v.x * M[1][0] + v.y * M[1][1] + v.z * M[1][2],
+                       v.x * M[2][0] + v.y * M[2][1] + v.z * M[2][2]);
+    }
+
+    inline Vector3 Matrix::InverseTransformVector(const Vector3& v) const
+    {
+#if defined(CYCLONE_SIMD_SCALAR_VECTOR3)
+        return Vector3(v.x * M[0][0] + v.y * M[1][0] + v.z * M[2][0],
+                       v.x * M[0][1] + v.y * M[1][1] + v.z * M[2][1],
+                       v.x * M[0][2] + v.y * M[1][2] + v.z * M[2][2]);
+#else
+        // The transpose of the rotation is applied by weighting its rows.
+        auto result = simd::Mul(simd::Splat(v.x), simd::Load(M[0]));
+
+        result = simd::Add(result, simd::Mul(simd::Splat(v.y), simd::Load(M[1])));
+
+        result = simd::Add(result, simd::Mul(simd::Splat(v.z), simd::Load(M[2])));
+
+        return Vector3::Store(result);
+#endif
+    }
+
+    inline Vector3 Matrix::TransformPosition(const Vector3& v) const
+    {
+        return Vector3(v.x * M[0][0] + v.y * M[0][1] + v.z * M[0][2] + M[0][3],
+                       v.x * M[1][0] + v.y * M[1][1] + v.z * M[1][2] + M[1][3],
+                       v.x * M[2][0] + v.y * M[2][1] + v.z * M[2][2] + M[2][3]);
+    }
 }
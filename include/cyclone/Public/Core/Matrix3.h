@@ -0,0 +1,138 @@
+#pragma once
+
+#include "Precision.h"
+#include "Vector3.h"
+
+namespace cyclone
+{
+    /**
+    * 3x3 matrix of floating point values, used for inertia tensors
+    * and changes of basis where a full 4x4 matrix is wasted space.
+    * Matrix elements are accessed with M[RowIndex][ColumnIndex].
+    */
+    class Matrix3
+    {
+    public:
+        /**
+        * Holds the tensor matrix data in array form.
+        */
+        real M[3][3];
+
+    public:
+        /**
+        * Constructs a matrix from its rows.
+        */
+        Matrix3(const Vector3& InX, const Vector3& InY, const Vector3& InZ);
+
+        /**
+        * Constructors. The default is the zero matrix.
+        */
+        Matrix3(real x0 = 0.f, real x1 = 0.f, real x2 = 0.f,
+                real y0 = 0.f, real y1 = 0.f, real y2 = 0.f,
+                real z0 = 0.f, real z1 = 0.f, real z2 = 0.f);
+
+        /**
+        * Set this to the identity matrix
+        */
+        void SetIdentity();
+
+        /**
+        * Sets the matrix to be a skew symmetric matrix based on
+        * the given vector. The skew symmetric matrix is the equivalent
+        * of the vector product. So if a,b are vectors. a x b = A_s b
+        * where A_s is the skew symmetric form of a.
+        */
+        void SetSkewSymmetric(const Vector3& v);
+
+        /**
+        * Gets the result of multiplying a Matrix3 to this.
+        */
+        Matrix3 operator*(const Matrix3& m) const;
+
+        /**
+        * Multiply this by a matrix.
+        */
+        void operator*=(const Matrix3& m);
+
+        /**
+        * Gets the result of adding a matrix to this.
+        */
+        Matrix3 operator+(const Matrix3& m) const;
+
+        /**
+        * Adds to this matrix.
+        */
+        void operator+=(const Matrix3& m);
+
+        /**
+        * Gets the result of multiplying every member by a value.
+        */
+        Matrix3 operator*(real scale) const;
+
+        /**
+        * Multiply this matrix by a weighting factor.
+        */
+        void operator*=(real scale);
+
+        /**
+        * Checks whether two matrix are identical.
+        */
+        bool operator==(const Matrix3& m) const;
+
+        /**
+        * Checks whether another Matrix3 is not equal to this.
+        */
+        bool operator!=(const Matrix3& m) const;
+
+        /**
+        * Transform the given vector by this matrix.
+        */
+        Vector3 operator*(const Vector3& v) const;
+
+        /**
+        * Transform the given vector by this matrix.
+        */
+        Vector3 TransformVector(const Vector3& v) const;
+
+        /**
+        * Transform the given vector by the transpose of this matrix,
+        * which is its inverse when the matrix is a rotation.
+        */
+        Vector3 InverseTransformVector(const Vector3& v) const;
+
+        /**
+        * Transpose.
+        */
+        Matrix3 Transposed() const;
+
+        /**
+        * Return determinant of this matrix.
+        */
+        real Determinant() const;
+
+        /**
+        * Returns a new matrix containing the inverse of this matrix,
+        * or the identity if it has none.
+        */
+        Matrix3 Inverse() const;
+    };
+
+    inline Vector3 Matrix3::operator*(const Vector3& v) const
+    {
+        return TransformVector(v);
+    }
+
+    inline Vector3 Matrix3::TransformVector(const Vector3& v) const
+    {
+        return Vector3(v.x * M[0][0] + v.y * M[0][1] + v.z * M[0][2],
+                       v.x * M[1][0] + v.y * M[1][1] + v.z * M[1][2],
+                       v.x * M[2][0] + v.y * M[2][1] + v.z * M[2][2]);
+    }
+
+    inline Vector3 Matrix3::InverseTransformVector(const Vector3& v) const
+    {
+        return Vector3(v.x * M[0][0] + v.y * M[1][0] + v.z * M[2][0],
+                       v.x * M[0][1] + v.y * M[1][1] + v.z * M[2][1],
+                       v.x * M[0][2] + v.y * M[1][2] + v.z * M[2][2]);
+    }
+}
@@ -139,7 +139,7 @@ namespace cyclone
         /**
         * Checks whether two quaternions are identical.
         */
-        bool operator=(const Quaternion& q) const;
+        bool operator==(const Quaternion& q) const;
 
         /**
         * Checks whether two quaternions are not identical.
@@ -204,4 +204,25 @@ namespace cyclone
 
         static real RadiansToDegrees(real rad);
     };
+
+    inline Vector3 Quaternion::RotateVector(const Vector3& v) const
+    {
+#if defined(CYCLONE_SIMD_SCALAR_VECTOR3)
+        const Vector3 q(i, j, k);
+
+        const auto t = 2.f * Vector3::CrossProduct(q, v);
+
+        return v + a * t + Vector3::CrossProduct(q, t);
+#else
+        // The quaternion is laid out as (i, j, k, a), so its vector part
+        // sits in the first three lanes.
+        const auto q = simd::Load(&i);
+
+        const auto lanes = v.Load();
+
+        const auto t = simd::Mul(simd::Splat(2.f), simd::Cross(q, lanes));
+
+        return Vector3::Store(simd::Add(simd::Add(lanes, simd::Mul(simd::Splat(a), t)), simd::Cross(q, t)));
+#endif
+    }
 }
@@ -0,0 +1,447 @@
+#pragma once
+
+/**
+* @file
+*
+* This file selects the vector instruction set used by the inline math
+* kernels, and wraps it in a small set of functions over four lanes of
+* reals. The selection is made at compile time:
+*
+* - CYCLONE_SIMD_AVX2 when the compiler targets AVX2 (/arch:AVX2 or
+*   -mavx2),
+* - CYCLONE_SIMD_SSE2 when it targets SSE2, which every x64 compiler does,
+* - CYCLONE_SIMD_SCALAR otherwise, or when CYCLONE_NO_SIMD is defined.
+*
+* Every operation is carried out in the same order as the scalar code
+* and without fused multiply-adds, so all three give identical results.
+*
+* CYCLONE_SIMD_SCALAR_VECTOR3 is defined when the four lanes are not one
+* register: on the scalar path, and for doubles under SSE2, which split
+* them across two. Moving a single Vector3 in and out of the lanes then
+* costs more than it saves, so the kernels that work on one vector at a
+* time, Quaternion::RotateVector and the inverse transforms, keep to
+* plain scalar code.
+*/
+
+#include "Precision.h"
+
+#if !defined(CYCLONE_NO_SIMD) && defined(__AVX2__)
+    #define CYCLONE_SIMD_AVX2 true
+    #include <immintrin.h>
+#elif !defined(CYCLONE_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define CYCLONE_SIMD_SSE2 true
+    #include <emmintrin.h>
+#else
+    #define CYCLONE_SIMD_SCALAR true
+#endif
+
+#if defined(CYCLONE_SIMD_SCALAR) || (defined(CYCLONE_SIMD_SSE2) && !defined(SINGLE_PRECISION))
+    #define CYCLONE_SIMD_SCALAR_VECTOR3 true
+#endif
+
+namespace cyclone
+{
+    namespace simd
+    {
+#if defined(CYCLONE_SIMD_SCALAR)
+        /**
+        * Holds four reals, operated on one at a time.
+        */
+        struct Lanes
+        {
+            real v[4];
+        };
+
+        inline Lanes Load(const real* values)
+        {
+            return {{values[0], values[1], values[2], values[3]}};
+        }
+
+        inline void Store(real* values, const Lanes& lanes)
+        {
+            for (auto i = 0; i < 4; ++i)
+            {
+                values[i] = lanes.v[i];
+            }
+        }
+
+        inline Lanes Splat(const real value)
+        {
+            return {{value, value, value, value}};
+        }
+
+        inline Lanes Add(const Lanes& a, const Lanes& b)
+        {
+            return {{a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3]}};
+        }
+
+        inline Lanes Sub(const Lanes& a, const Lanes& b)
+        {
+            return {{a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3]}};
+        }
+
+        inline Lanes Mul(const Lanes& a, const Lanes& b)
+        {
+            return {{a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3]}};
+        }
+
+        /**
+        * Rotates the first three lanes, giving (y, z, x, w).
+        */
+        inline Lanes RotateLeft(const Lanes& a)
+        {
+            return {{a.v[1], a.v[2], a.v[0], a.v[3]}};
+        }
+
+        /**
+        * Rotates the first three lanes, giving (z, x, y, w).
+        */
+        inline Lanes RotateRight(const Lanes& a)
+        {
+            return {{a.v[2], a.v[0], a.v[1], a.v[3]}};
+        }
+
+        inline real Sum3(const Lanes& a)
+        {
+            return a.v[0] + a.v[1] + a.v[2];
+        }
+
+        inline Lanes Min(const Lanes& a, const Lanes& b)
+        {
+            Lanes result;
+
+            for (auto i = 0; i < 4; ++i)
+            {
+                result.v[i] = a.v[i] < b.v[i] ? a.v[i] : b.v[i];
+            }
+
+            return result;
+        }
+
+        inline Lanes Max(const Lanes& a, const Lanes& b)
+        {
+            Lanes result;
+
+            for (auto i = 0; i < 4; ++i)
+            {
+                result.v[i] = a.v[i] > b.v[i] ? a.v[i] : b.v[i];
+            }
+
+            return result;
+        }
+
+        /**
+        * Returns a mask with bit i set where lane i of a is no greater
+        * than lane i of b.
+        */
+        inline int LessEqual(const Lanes& a, const Lanes& b)
+        {
+            auto mask = 0;
+
+            for (auto i = 0; i < 4; ++i)
+            {
+                mask |= a.v[i] <= b.v[i] ? 1 << i : 0;
+            }
+
+            return mask;
+        }
+
+        inline void Transpose(Lanes& r0, Lanes& r1, Lanes& r2, Lanes& r3)
+        {
+            Lanes* rows[4] = {&r0, &r1, &r2, &r3};
+
+            for (auto i = 0; i < 4; ++i)
+            {
+                for (auto j = i + 1; j < 4; ++j)
+                {
+                    const auto swap = rows[i]->v[j];
+
+                    rows[i]->v[j] = rows[j]->v[i];
+
+                    rows[j]->v[i] = swap;
+                }
+            }
+        }
+#elif defined(SINGLE_PRECISION)
+        /**
+        * Holds four floats in one SSE register.
+        */
+        typedef __m128 Lanes;
+
+        inline Lanes Load(const real* values)
+        {
+            return _mm_loadu_ps(values);
+        }
+
+        inline void Store(real* values, const Lanes lanes)
+        {
+            _mm_storeu_ps(values, lanes);
+        }
+
+        inline Lanes Splat(const real value)
+        {
+            return _mm_set1_ps(value);
+        }
+
+        inline Lanes Add(const Lanes a, const Lanes b)
+        {
+            return _mm_add_ps(a, b);
+        }
+
+        inline Lanes Sub(const Lanes a, const Lanes b)
+        {
+            return _mm_sub_ps(a, b);
+        }
+
+        inline Lanes Mul(const Lanes a, const Lanes b)
+        {
+            return _mm_mul_ps(a, b);
+        }
+
+        inline Lanes RotateLeft(const Lanes a)
+        {
+            return _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+        }
+
+        inline Lanes RotateRight(const Lanes a)
+        {
+            return _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 1, 0, 2));
+        }
+
+        inline real Sum3(const Lanes a)
+        {
+            const auto y = _mm_shuffle_ps(a, a, _MM_SHUFFLE(1, 1, 1, 1));
+
+            const auto z = _mm_movehl_ps(a, a);
+
+            return _mm_cvtss_f32(_mm_add_ss(_mm_add_ss(a, y), z));
+        }
+
+        inline Lanes Min(const Lanes a, const Lanes b)
+        {
+            return _mm_min_ps(a, b);
+        }
+
+        inline Lanes Max(const Lanes a, const Lanes b)
+        {
+            return _mm_max_ps(a, b);
+        }
+
+        inline int LessEqual(const Lanes a, const Lanes b)
+        {
+            return _mm_movemask_ps(_mm_cmple_ps(a, b));
+        }
+
+        inline void Transpose(Lanes& r0, Lanes& r1, Lanes& r2, Lanes& r3)
+        {
+            _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+        }
+#elif defined(CYCLONE_SIMD_AVX2)
+        /**
+        * Holds four doubles in one AVX register.
+        */
+        typedef __m256d Lanes;
+
+        inline Lanes Load(const real* values)
+        {
+            return _mm256_loadu_pd(values);
+        }
+
+        inline void Store(real* values, const Lanes lanes)
+        {
+            _mm256_storeu_pd(values, lanes);
+        }
+
+        inline Lanes Splat(const real value)
+        {
+            return _mm256_set1_pd(value);
+        }
+
+        inline Lanes Add(const Lanes a, const Lanes b)
+        {
+            return _mm256_add_pd(a, b);
+        }
+
+        inline Lanes Sub(const Lanes a, const Lanes b)
+        {
+            return _mm256_sub_pd(a, b);
+        }
+
+        inline Lanes Mul(const Lanes a, const Lanes b)
+        {
+            return _mm256_mul_pd(a, b);
+        }
+
+        inline Lanes RotateLeft(const Lanes a)
+        {
+            return _mm256_permute4x64_pd(a, _MM_SHUFFLE(3, 0, 2, 1));
+        }
+
+        inline Lanes RotateRight(const Lanes a)
+        {
+            return _mm256_permute4x64_pd(a, _MM_SHUFFLE(3, 1, 0, 2));
+        }
+
+        inline real Sum3(const Lanes a)
+        {
+            const auto xy = _mm256_castpd256_pd128(a);
+
+            const auto zw = _mm256_extractf128_pd(a, 1);
+
+            return _mm_cvtsd_f64(_mm_add_sd(_mm_add_sd(xy, _mm_unpackhi_pd(xy, xy)), zw));
+        }
+
+        inline Lanes Min(const Lanes a, const Lanes b)
+        {
+            return _mm256_min_pd(a, b);
+        }
+
+        inline Lanes Max(const Lanes a, const Lanes b)
+        {
+            return _mm256_max_pd(a, b);
+        }
+
+        inline int LessEqual(const Lanes a, const Lanes b)
+        {
+            return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_LE_OQ));
+        }
+
+        inline void Transpose(Lanes& r0, Lanes& r1, Lanes& r2, Lanes& r3)
+        {
+            const auto t0 = _mm256_unpacklo_pd(r0, r1);
+
+            const auto t1 = _mm256_unpackhi_pd(r0, r1);
+
+            const auto t2 = _mm256_unpacklo_pd(r2, r3);
+
+            const auto t3 = _mm256_unpackhi_pd(r2, r3);
+
+            r0 = _mm256_permute2f128_pd(t0, t2, 0x20);
+
+            r1 = _mm256_permute2f128_pd(t1, t3, 0x20);
+
+            r2 = _mm256_permute2f128_pd(t0, t2, 0x31);
+
+            r3 = _mm256_permute2f128_pd(t1, t3, 0x31);
+        }
+#else
+        /**
+        * Holds four doubles in a pair of SSE2 registers.
+        */
+        struct Lanes
+        {
+            __m128d xy;
+
+            __m128d zw;
+        };
+
+        inline Lanes Load(const real* values)
+        {
+            return {_mm_loadu_pd(values), _mm_loadu_pd(values + 2)};
+        }
+
+        inline void Store(real* values, const Lanes& lanes)
+        {
+            _mm_storeu_pd(values, lanes.xy);
+
+            _mm_storeu_pd(values + 2, lanes.zw);
+        }
+
+        inline Lanes Splat(const real value)
+        {
+            const auto lanes = _mm_set1_pd(value);
+
+            return {lanes, lanes};
+        }
+
+        inline Lanes Add(const Lanes& a, const Lanes& b)
+        {
+            return {_mm_add_pd(a.xy, b.xy), _mm_add_pd(a.zw, b.zw)};
+        }
+
+        inline Lanes Sub(const Lanes& a, const Lanes& b)
+        {
+            return {_mm_sub_pd(a.xy, b.xy), _mm_sub_pd(a.zw, b.zw)};
+        }
+
+        inline Lanes Mul(const Lanes& a, const Lanes& b)
+        {
+            return {_mm_mul_pd(a.xy, b.xy), _mm_mul_pd(a.zw, b.zw)};
+        }
+
+        inline Lanes RotateLeft(const Lanes& a)
+        {
+            return {_mm_shuffle_pd(a.xy, a.zw, 1), _mm_shuffle_pd(a.xy, a.zw, 2)};
+        }
+
+        inline Lanes RotateRight(const Lanes& a)
+        {
+            return {_mm_shuffle_pd(a.zw, a.xy, 0), _mm_shuffle_pd(a.xy, a.zw, 3)};
+        }
+
+        inline real Sum3(const Lanes& a)
+        {
+            return _mm_cvtsd_f64(_mm_add_sd(_mm_add_sd(a.xy, _mm_unpackhi_pd(a.xy, a.xy)), a.zw));
+        }
+
+        inline Lanes Min(const Lanes& a, const Lanes& b)
+        {
+            return {_mm_min_pd(a.xy, b.xy), _mm_min_pd(a.zw, b.zw)};
+        }
+
+        inline Lanes Max(const Lanes& a, const Lanes& b)
+        {
+            return {_mm_max_pd(a.xy, b.xy), _mm_max_pd(a.zw, b.zw)};
+        }
+
+        inline int LessEqual(const Lanes& a, const Lanes& b)
+        {
+            return _mm_movemask_pd(_mm_cmple_pd(a.xy, b.xy)) | _mm_movemask_pd(_mm_cmple_pd(a.zw, b.zw)) << 2;
+        }
+
+        inline void Transpose(Lanes& r0, Lanes& r1, Lanes& r2, Lanes& r3)
+        {
+            const Lanes t0 = {_mm_unpacklo_pd(r0.xy, r1.xy), _mm_unpacklo_pd(r2.xy, r3.xy)};
+
+            const Lanes t1 = {_mm_unpackhi_pd(r0.xy, r1.xy), _mm_unpackhi_pd(r2.xy, r3.xy)};
+
+            const Lanes t2 = {_mm_unpacklo_pd(r0.zw, r1.zw), _mm_unpacklo_pd(r2.zw, r3.zw)};
+
+            const Lanes t3 = {_mm_unpackhi_pd(r0.zw, r1.zw), _mm_unpackhi_pd(r2.zw, r3.zw)};
+
+            r0 = t0;
+
+            r1 = t1;
+
+            r2 = t2;
+
+            r3 = t3;
+        }
+#endif
+
+        /**
+        * Returns the cross product of the first three lanes of each, with
+        * the same rounding as the scalar cross product.
+        */
+        inline Lanes Cross(const Lanes& a, const Lanes& b)
+        {
+            return Sub(Mul(RotateLeft(a), RotateRight(b)), Mul(RotateRight(a), RotateLeft(b)));
+        }
+
+        /**
+        * Returns the dot product of the first three lanes of each.
+        */
+        inline real Dot3(const Lanes& a, const Lanes& b)
+        {
+            return Sum3(Mul(a, b));
+        }
+
+        /**
+        * Returns the absolute value of each lane.
+        */
+        inline Lanes Abs(const Lanes& a)
+        {
+            return Max(a, Sub(Splat(0), a));
+        }
+    }
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+/**
+* @file
+*
+* This file contains the definitions for a graph of tasks that depend on
+* each other, run by a thread pool.
+*/
+
+#include <atomic>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <vector>
+
+namespace cyclone
+{
+    class ThreadPool;
+
+    /**
+    * A set of tasks, each of which may depend on tasks added before it.
+    * When the graph is run each task starts once the tasks it depends on
+    * have finished, and tasks that don't depend on each other may run at
+    * the same time. A task can itself run loops on the same pool.
+    *
+    * As a task can only depend on earlier tasks, the graph can't have a
+    * cycle, and running the tasks in the order they were added always
+    * meets their dependencies. That is how the graph is run without a
+    * pool, or on a pool of one thread.
+    */
+    class TaskGraph
+    {
+    public:
+        /**
+        * The work done by one task.
+        */
+        typedef std::function<void()> Task;
+
+    public:
+        TaskGraph();
+
+        /**
+        * Adds a task that runs after the given tasks, which must have
+        * been added already, and returns its index.
+        */
+        unsigned AddTask(const Task& task, std::initializer_list<unsigned> dependencies = {});
+
+        /**
+        * Removes every task, keeping the storage.
+        */
+        void Clear();
+
+        /**
+        * Returns the number of tasks.
+        */
+        unsigned GetTaskCount() const;
+
+        /**
+        * Runs every task on the given pool, or in the order they were
+        * added if there is no pool, and returns when they have finished.
+        */
+        void Run(ThreadPool* threadPool);
+
+    protected:
+        friend class ThreadPool;
+
+        /**
+        * A task and the tasks waiting on it.
+        */
+        struct Node
+        {
+            Task task;
+
+            /**
+            * Holds the tasks that depend on this one.
+            */
+            std::vector<unsigned> successors;
+
+            /**
+            * Holds the number of tasks this one depends on.
+            */
+            unsigned dependencyCount;
+        };
+
+    protected:
+        /**
+        * Holds the tasks, in the order they were added.
+        */
+        std::vector<Node> nodes;
+
+        /**
+        * Holds the number of unfinished dependencies of each task while
+        * the graph runs.
+        */
+        std::unique_ptr<std::atomic<unsigned>[]> remaining;
+
+        /**
+        * Holds the size of the remaining array.
+        */
+        unsigned remainingSize;
+    };
+}
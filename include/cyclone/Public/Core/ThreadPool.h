@@ -0,0 +1,204 @@
+#pragma once
+
+/**
+* @file
+*
+* This file contains the definitions for a small work-stealing scheduler
+* used to spread independent pieces of work across cores.
+*/
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cyclone
+{
+    class TaskGraph;
+
+    /**
+    * A fixed set of worker threads that run jobs, each thread with its
+    * own queue of jobs. A thread takes the newest job from its own queue,
+    * and when that is empty steals the oldest job from another thread's.
+    * The thread waiting on some work takes part in it rather than
+    * blocking, so loops and graphs can be started from inside a job, and
+    * a pool of one thread has no workers and runs everything inline.
+    *
+    * Loops are split in half again and again as they are run, and the
+    * halves left over are there for idle threads to steal, so uneven
+    * pieces of work are balanced without any tuning.
+    */
+    class ThreadPool
+    {
+    public:
+        /**
+        * The work done for one iteration, given its index.
+        */
+        typedef std::function<void(unsigned)> Task;
+
+    public:
+        /**
+        * Creates a pool running work on the given number of threads,
+        * counting the calling thread. If no count is given, one thread
+        * per hardware core is used.
+        */
+        explicit ThreadPool(unsigned threadCount = 0);
+
+        /**
+        * Stops and joins the worker threads.
+        */
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        /**
+        * Returns the number of threads work is run on, counting the
+        * calling thread.
+        */
+        unsigned GetThreadCount() const;
+
+        /**
+        * Runs the task once for each index from zero up to the given
+        * count, and returns when every iteration has finished. Ranges of
+        * up to the given grain size are run together on one thread. The
+        * iterations may run in any order and at the same time, so they
+        * must not write to any shared data.
+        */
+        void ParallelFor(unsigned count, const Task& task, unsigned grainSize = 1);
+
+        /**
+        * Runs every task of the graph, each once all the tasks it
+        * depends on have finished, and returns when they all have.
+        */
+        void Run(TaskGraph& graph);
+
+    protected:
+        /**
+        * A piece of work held in a queue. Jobs are small and held by
+        * value, so queuing them needs no allocation.
+        */
+        struct Job
+        {
+            /**
+            * Holds the function that does the work.
+            */
+            void (*function)(ThreadPool& pool, const Job& job);
+
+            /**
+            * Holds what the work is done on: the task of a loop, or
+            * a graph.
+            */
+            void* context;
+
+            /**
+            * Holds the range of iterations of a loop, or the index of
+            * a graph's task in begin.
+            */
+            unsigned begin;
+
+            unsigned end;
+
+            /**
+            * Holds the iterations of a loop run together.
+            */
+            unsigned grainSize;
+
+            /**
+            * Counts the jobs of the loop or graph still to finish.
+            */
+            std::atomic<unsigned>* pending;
+        };
+
+        /**
+        * The queue of jobs of one thread.
+        */
+        struct JobQueue
+        {
+            std::mutex mutex;
+
+            std::deque<Job> jobs;
+        };
+
+        /**
+        * Queues a job on the calling thread's queue and wakes a worker.
+        */
+        void Push(const Job& job);
+
+        /**
+        * Takes the newest job from the calling thread's queue, or steals
+        * the oldest from another's. Returns false if every queue is empty.
+        */
+        bool Pop(Job& job);
+
+        /**
+        * Runs a job and marks it finished.
+        */
+        void Execute(const Job& job);
+
+        /**
+        * Runs jobs until the given count of jobs reaches zero.
+        */
+        void WaitFor(const std::atomic<unsigned>& pending);
+
+        /**
+        * Returns the queue of the calling thread. Threads outside the
+        * pool share the first queue.
+        */
+        unsigned GetQueueIndex() const;
+
+        /**
+        * The loop run by each worker thread.
+        */
+        void WorkerLoop(unsigned queueIndex);
+
+        /**
+        * Runs a range of iterations of a loop, leaving its upper halves
+        * for other threads until it is no bigger than the grain size.
+        */
+        static void RunRange(ThreadPool& pool, const Job& job);
+
+        /**
+        * Runs a task of a graph, then queues the tasks depending on it
+        * that have nothing left to wait for.
+        */
+        static void RunGraphTask(ThreadPool& pool, const Job& job);
+
+    protected:
+        /**
+        * Holds the worker threads.
+        */
+        std::vector<std::thread> workers;
+
+        /**
+        * Holds one queue per thread. The first belongs to the threads
+        * outside the pool.
+        */
+        std::vector<std::unique_ptr<JobQueue>> queues;
+
+        /**
+        * Holds the number of jobs in all the queues.
+        */
+        std::atomic<unsigned> queuedJobs;
+
+        /**
+        * Guards the workers going to sleep.
+        */
+        std::mutex sleepMutex;
+
+        /**
+        * Wakes the workers when a job is queued or the pool stops.
+        */
+        std::condition_variable wakeCondition;
+
+        /**
+        * True once the pool is being destroyed.
+        */
+        bool bStopping;
+    };
+}
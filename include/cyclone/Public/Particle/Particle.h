@@ -356,5 +356,12 @@ namespace cyclone
         Vector3 acceleration;
 
         /*@}*/
+
+    private:
+        /**
+        * The particle set copies whole particles in and out of its
+        * arrays, so it needs access to the accumulated force.
+        */
+        friend class ParticleSet;
     };
 }
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <vector>
+#include "ParticleContactGenerator.h"
+
+namespace cyclone
+{
+    /**
+    * A contact generator that treats every particle as a sphere of the
+    * same radius, and collides them with each other and, optionally,
+    * with the ground.
+    *
+    * Particles are bucketed into a uniform grid of cells, hashed into a
+    * table so the grid needs no bounds. The buckets are rebuilt each
+    * frame with a counting sort, then each particle is only checked
+    * against the particles in its own and neighbouring cells. For a
+    * cell size of at least twice the radius that finds every contact.
+    */
+    class ParticleGrid : public ParticleContactGenerator
+    {
+    public:
+        typedef std::vector<Particle*> Particles;
+
+    public:
+        ParticleGrid();
+
+        /**
+        * Sets the particles to collide, the radius of each particle and
+        * the size of the grid cells. Contacts are created with the given
+        * restitution. If bGround is set, the particles are also collided
+        * with the ground at y = 0.
+        */
+        void Init(Particles* particles, real radius, real cellSize, real restitution = 0.2f, bool bGround = false);
+
+        /**
+        * Buckets the particles by their current positions. This must be
+        * called after the particles move and before contacts are added.
+        */
+        void Rebuild();
+
+        /**
+        * Fills the given contact array with the contacts between the
+        * particles found in the last rebuild.
+        */
+        unsigned AddContact(ParticleContact* contact, unsigned limit) const override;
+
+    protected:
+        /**
+        * Returns the bucket that holds the cell at the given coordinates.
+        */
+        unsigned GetBucket(int x, int y, int z) const;
+
+        /**
+        * Returns the coordinate of the cell that holds the given value.
+        */
+        int GetCell(real value) const;
+
+    protected:
+        /**
+        * Holds the particles to collide.
+        */
+        Particles* particles;
+
+        /**
+        * Holds the radius of every particle.
+        */
+        real radius;
+
+        /**
+        * Holds the size of each cell along every axis.
+        */
+        real cellSize;
+
+        /**
+        * Holds the restitution of the generated contacts.
+        */
+        real restitution;
+
+        /**
+        * True if the particles should be collided with the ground.
+        */
+        bool bGround;
+
+        /**
+        * Holds the number of buckets less one. The table size is always
+        * a power of two.
+        */
+        unsigned bucketMask;
+
+        /**
+        * Holds the index of the first sorted particle of each bucket,
+        * plus one past the last.
+        */
+        std::vector<unsigned> bucketStart;
+
+        /**
+        * Holds the particle indices sorted by bucket.
+        */
+        std::vector<unsigned> sortedParticles;
+
+        /**
+        * Holds the positions in the same order as the sorted particles.
+        */
+        std::vector<Vector3> sortedPositions;
+
+        /**
+        * Holds the bucket of each particle, in particle order.
+        */
+        std::vector<unsigned> particleBuckets;
+    };
+}
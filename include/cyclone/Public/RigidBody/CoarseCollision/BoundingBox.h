@@ -0,0 +1,97 @@
+#pragma once
+
+#include "Core/Vector3.h"
+
+namespace cyclone
+{
+    /*
+    * Forward declarations, the primitives are only used to build boxes.
+    */
+    class CollisionBox;
+
+    class CollisionSphere;
+
+    /**
+    * Represents an axis aligned bounding box that can be tested for
+    * overlap. It offers the same interface as BoundingSphere, so either
+    * can be used to build a bounding volume hierarchy.
+    */
+    struct BoundingBox
+    {
+    public:
+        /**
+        * Creates an empty bounding box at the origin.
+        */
+        BoundingBox();
+
+        /**
+        * Creates a new bounding box from its lowest and highest corners.
+        */
+        BoundingBox(const Vector3& minimum, const Vector3& maximum);
+
+        /**
+        * Creates a bounding box to enclose the two given bounding
+        * boxes.
+        */
+        BoundingBox(const BoundingBox& one, const BoundingBox& another);
+
+        /**
+        * Creates the tightest bounding box around the given oriented box.
+        * The box's internals must be up to date.
+        */
+        static BoundingBox Enclosing(const CollisionBox& box);
+
+        /**
+        * Creates the tightest bounding box around the given sphere.
+        * The sphere's internals must be up to date.
+        */
+        static BoundingBox Enclosing(const CollisionSphere& sphere);
+
+        /**
+        * Checks if the bounding box overlaps with the other given
+        * bounding box.
+        */
+        bool Overlaps(const BoundingBox& other) const;
+
+        /**
+        * Checks if the bounding box fully encloses the other given
+        * bounding box.
+        */
+        bool Contains(const BoundingBox& other) const;
+
+        /**
+        * Reports how much this bounding box would have to grow by to
+        * incorporate the given bounding box, as the change in its
+        * surface area.
+        */
+        real GetGrowth(const BoundingBox& other) const;
+
+        /**
+        * Returns the volume of this bounding box. This is used to
+        * calculate how to recurse into the bounding volume tree.
+        */
+        real Size() const;
+
+        /**
+        * Returns the surface area of this bounding box.
+        */
+        real GetSurfaceArea() const;
+
+        /**
+        * Returns a copy of this bounding box grown by the given margin
+        * along every axis.
+        */
+        BoundingBox Expanded(real margin) const;
+
+        /**
+        * Returns a copy of this bounding box stretched to also cover
+        * itself moved by the given displacement.
+        */
+        BoundingBox Swept(const Vector3& displacement) const;
+
+    public:
+        Vector3 minimum;
+
+        Vector3 maximum;
+    };
+}
@@ -0,0 +1,301 @@
+#pragma once
+
+#include <vector>
+#include "RigidBody/CoarseCollision/BVHNode.h"
+#include "RigidBody/CoarseCollision/BoundingBox.h"
+#include "RigidBody/FineCollision/Ray.h"
+#include "RigidBody/FineCollision/TimeOfImpact.h"
+
+namespace cyclone
+{
+    /**
+    * A bounding volume hierarchy of axis aligned boxes that is kept
+    * up to date as the bodies move, rather than rebuilt every frame.
+    *
+    * Each leaf stores a fattened box around its primitive, so small
+    * movements don't touch the tree at all. When a body escapes its fat
+    * box the leaf is removed and inserted again, and the branches above
+    * it are refitted and rebalanced with tree rotations. New leaves are
+    * placed with the same heuristic as BVHNode: descend into the child
+    * that would grow the least.
+    *
+    * The nodes live in a single array and refer to each other by index,
+    * so the tree never allocates once it has reached its working size.
+    * Leaves are identified by proxies, which stay valid until removed.
+    */
+    class DynamicAABBTree
+    {
+    public:
+        /**
+        * Marks a missing node.
+        */
+        static constexpr unsigned NullNode = 0xffffffff;
+
+        /**
+        * The number of rays traced through the tree together by
+        * RaycastAll, one to each SIMD lane.
+        */
+        static constexpr unsigned RaysPerPacket = 4;
+
+        /**
+        * The deepest tree RaycastAll can walk. The tree is kept
+        * balanced, so this is far more than any tree that fits in
+        * memory needs.
+        */
+        static constexpr unsigned MaxRayDepth = 64;
+
+        /**
+        * How close a swept shape has to come to a primitive for Sweep
+        * to count it as touching.
+        */
+        static constexpr real SweepTolerance = 0.001f;
+
+    public:
+        /**
+        * Creates an empty tree. The margin is added around every leaf
+        * box, and the displacement multiplier is used to stretch it in
+        * the direction the body is moving.
+        */
+        DynamicAABBTree(real margin = 0.1f, real displacementMultiplier = 2.f);
+
+        /**
+        * Inserts the given rigid body, with the given bounding volume and
+        * the primitive that represents it, into the tree. Returns the
+        * proxy used to refer to the new leaf.
+        */
+        unsigned Insert(RigidBody* body, const BoundingBox& volume, CollisionPrimitive* primitive = nullptr);
+
+        /**
+        * Removes the leaf with the given proxy from the tree.
+        */
+        void Remove(unsigned proxy);
+
+        /**
+        * Updates the leaf with the given proxy to a new bounding volume.
+        * The displacement is how far the body is expected to move before
+        * the next update. Returns true if the leaf had to be reinserted.
+        */
+        bool Move(unsigned proxy, const BoundingBox& volume, const Vector3& displacement);
+
+        /**
+        * Checks the potential contacts between all the leaves in the
+        * tree, writing them to the given array (up to the given limit).
+        * Returns the number of potential contacts it found.
+        */
+        unsigned GetPotentialContacts(PotentialContact* contacts, unsigned limit) const;
+
+        /**
+        * Finds the leaves whose fat volumes overlap the given volume,
+        * writing their proxies to the given array (up to the given
+        * limit). Returns the number of proxies it found.
+        */
+        unsigned Query(const BoundingBox& volume, unsigned* proxies, unsigned limit) const;
+
+        /**
+        * Casts each of the given rays against the primitives of the
+        * leaves, writing the closest hit of each to the matching entry of
+        * the given hits. Leaves without a primitive are skipped. Returns
+        * the number of rays that hit something.
+        *
+        * The rays are traced in packets of RaysPerPacket, each branch
+        * being tested against the whole packet at once, and a packet
+        * only goes on down the branches that at least one of its rays
+        * still reaches before its closest hit so far. Nothing but the
+        * hits is written to, so any number of threads can cast rays at
+        * the same time, as long as the tree isn't changed meanwhile.
+        */
+        unsigned RaycastAll(const Ray* rays, unsigned count, RayHit* hits) const;
+
+        /**
+        * Finds the bodies whose primitives overlap the given box or
+        * sphere, writing them to the given array (up to the given
+        * limit). Returns the number of bodies it found. Only the leaves
+        * whose fat volumes overlap the shape are tested, and a body made
+        * of several primitives is listed once for each.
+        *
+        * The shape's internals must be up to date. It can belong to a
+        * body in the tree, whose own leaves are then skipped, or have no
+        * body and be placed by its offset. Nothing is allocated, and the
+        * tree is only read, so queries can run on several threads at
+        * once.
+        */
+        unsigned Overlap(const CollisionPrimitive& shape, RigidBody** bodies, unsigned limit) const;
+
+        /**
+        * Sweeps the given box or sphere along the given motion, without
+        * turning, and finds the primitives it touches on the way, as
+        * Overlap. The hits are written to the given array nearest first,
+        * and if there are more than the limit, only the nearest are
+        * kept. Returns the number of hits written.
+        */
+        unsigned Sweep(const CollisionPrimitive& shape, const Vector3& motion, SweepHit* hits, unsigned limit) const;
+
+        /**
+        * Removes every leaf from the tree.
+        */
+        void Clear();
+
+        /**
+        * Returns the fattened bounding volume stored for the given proxy.
+        */
+        const BoundingBox& GetFatVolume(unsigned proxy) const;
+
+        /**
+        * Returns the body stored for the given proxy.
+        */
+        RigidBody* GetBody(unsigned proxy) const;
+
+        /**
+        * Returns the primitive stored for the given proxy.
+        */
+        CollisionPrimitive* GetPrimitive(unsigned proxy) const;
+
+        /**
+        * Returns the height of the tree, zero when it is empty or holds
+        * a single leaf.
+        */
+        unsigned GetHeight() const;
+
+    protected:
+        /**
+        * A node in the tree. Branches have two children, leaves have
+        * none and hold a body.
+        */
+        struct Node
+        {
+            /**
+            * Holds a single bounding volume encompassing all the
+            * descendants of this node.
+            */
+            BoundingBox volume;
+
+            /**
+            * Holds the rigid body at this node of the hierarchy.
+            * Only leaf nodes can have a rigid body defined.
+            */
+            RigidBody* body;
+
+            /**
+            * Holds the primitive representing the body, if any.
+            */
+            CollisionPrimitive* primitive;
+
+            /**
+            * Holds the parent of this node while it is in the tree, or
+            * the next free node while it is in the free list.
+            */
+            unsigned parent;
+
+            /**
+            * Holds the child nodes of this node.
+            */
+            unsigned children[2];
+
+            /**
+            * Holds the height of the subtree below this node, zero for
+            * leaves and -1 for free nodes.
+            */
+            int height;
+
+            /**
+            * Checks if this node is at the bottom of the hierarchy.
+            */
+            bool IsLeaf() const;
+        };
+
+        /**
+        * Takes a node from the free list, growing the pool if needed.
+        */
+        unsigned AllocateNode();
+
+        /**
+        * Returns a node to the free list.
+        */
+        void FreeNode(unsigned node);
+
+        /**
+        * Links the given leaf into the tree.
+        */
+        void InsertLeaf(unsigned leaf);
+
+        /**
+        * Unlinks the given leaf from the tree, without freeing it.
+        */
+        void RemoveLeaf(unsigned leaf);
+
+        /**
+        * Walks from the given node up to the root, refitting the
+        * volumes and rebalancing the branches on the way.
+        */
+        void Refit(unsigned node);
+
+        /**
+        * Rotates the given branch if its children are unbalanced.
+        * Returns the node that now sits where the branch was.
+        */
+        unsigned Balance(unsigned node);
+
+        /**
+        * Writes the potential contacts between the two given subtrees,
+        * up to the given limit. Returns the number written.
+        */
+        unsigned GetPotentialContactsWith(unsigned one, unsigned another,
+                                          PotentialContact* contacts, unsigned limit) const;
+
+        /**
+        * Writes the proxies of the leaves below the given node that
+        * overlap the given volume, up to the given limit. Returns the
+        * number written.
+        */
+        unsigned QueryNode(unsigned node, const BoundingBox& volume, unsigned* proxies, unsigned limit) const;
+
+        /**
+        * Casts the given packet of up to RaysPerPacket rays through the
+        * tree, writing the closest hit of each. Returns the number of
+        * rays that hit something.
+        */
+        unsigned RaycastPacket(const Ray* rays, unsigned count, RayHit* hits) const;
+
+        /**
+        * Writes the bodies of the leaves below the given node that
+        * overlap the given shape, up to the given limit. Returns the
+        * number written.
+        */
+        unsigned OverlapNode(unsigned node, const CollisionPrimitive& shape, const BoundingBox& volume,
+                             RigidBody** bodies, unsigned limit) const;
+
+        /**
+        * Adds the hits of the given sweep against the leaves below the
+        * given node to the sorted list of hits, keeping the nearest
+        * when it is full.
+        */
+        void SweepNode(unsigned node, const CollisionPrimitive& shape, const BodySweep& sweep,
+                       const BoundingBox& volume, SweepHit* hits, unsigned limit, unsigned* count) const;
+
+    protected:
+        /**
+        * Holds every node, in use or free.
+        */
+        std::vector<Node> nodes;
+
+        /**
+        * Holds the root of the tree.
+        */
+        unsigned root;
+
+        /**
+        * Holds the first node of the free list.
+        */
+        unsigned freeList;
+
+        /**
+        * Holds the margin added around every leaf volume.
+        */
+        real margin;
+
+        /**
+        * Holds how much the predicted displacement stretches a leaf.
+        */
+        real displacementMultiplier;
+    };
+}
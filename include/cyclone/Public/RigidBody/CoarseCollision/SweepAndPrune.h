@@ -0,0 +1,182 @@
+#pragma once
+
+#include <unordered_set>
+#include <vector>
+#include "RigidBody/CoarseCollision/BVHNode.h"
+#include "RigidBody/CoarseCollision/BoundingBox.h"
+
+namespace cyclone
+{
+    /**
+    * A broadphase that keeps the extents of every bounding box sorted
+    * along each world axis, and tracks the pairs that overlap on all
+    * three.
+    *
+    * The sorted endpoint lists persist between frames and are re-sorted
+    * with an insertion sort, which is close to linear when the bodies
+    * only move a little. Every swap of two endpoints is the moment a
+    * pair starts or stops overlapping on that axis, so the set of
+    * overlapping pairs is updated as the sort runs, and the pairs that
+    * were added and removed by the last update are available.
+    */
+    class SweepAndPrune
+    {
+    public:
+        /**
+        * Identifies a pair of proxies, with the lower proxy first.
+        */
+        struct ProxyPair
+        {
+            unsigned proxy[2];
+        };
+
+        typedef std::vector<ProxyPair> ProxyPairs;
+
+    public:
+        /**
+        * Creates an empty broadphase.
+        */
+        SweepAndPrune();
+
+        /**
+        * Inserts the given rigid body, with the given bounding volume and
+        * the primitive that represents it. Returns the proxy used to refer
+        * to it. The body is sorted into place by the next update.
+        */
+        unsigned Insert(RigidBody* body, const BoundingBox& volume, CollisionPrimitive* primitive = nullptr);
+
+        /**
+        * Removes the given proxy. Its pairs are reported as removed by the
+        * next update.
+        */
+        void Remove(unsigned proxy);
+
+        /**
+        * Sets a new bounding volume for the given proxy. The endpoints are
+        * sorted by the next update.
+        */
+        void Move(unsigned proxy, const BoundingBox& volume);
+
+        /**
+        * Re-sorts the endpoints along each axis and updates the set of
+        * overlapping pairs.
+        */
+        void Update();
+
+        /**
+        * Writes the overlapping pairs to the given array (up to the given
+        * limit). Returns the number of potential contacts written.
+        */
+        unsigned GetPotentialContacts(PotentialContact* contacts, unsigned limit) const;
+
+        /**
+        * Returns the pairs that started overlapping in the last update.
+        */
+        const ProxyPairs& GetAddedPairs() const;
+
+        /**
+        * Returns the pairs that stopped overlapping in the last update,
+        * including the pairs of proxies removed before it.
+        */
+        const ProxyPairs& GetRemovedPairs() const;
+
+        /**
+        * Returns the number of overlapping pairs.
+        */
+        unsigned GetPairCount() const;
+
+        /**
+        * Removes every proxy.
+        */
+        void Clear();
+
+    protected:
+        /**
+        * The data stored for each proxy.
+        */
+        struct Proxy
+        {
+            BoundingBox volume;
+
+            RigidBody* body;
+
+            CollisionPrimitive* primitive;
+
+            /**
+            * Holds the next free proxy while this one is unused.
+            */
+            unsigned next;
+        };
+
+        /**
+        * The lower or upper end of a proxy's extent along an axis.
+        */
+        struct Endpoint
+        {
+            real value;
+
+            unsigned proxy;
+
+            bool bIsMaximum;
+        };
+
+        /**
+        * Re-sorts the endpoints of the given axis, updating the pairs
+        * as endpoints pass each other.
+        */
+        void SortAxis(unsigned axis);
+
+        /**
+        * Adds the pair to the overlapping set if it isn't there already.
+        */
+        void AddPair(unsigned one, unsigned other);
+
+        /**
+        * Removes the pair from the overlapping set if it is there.
+        */
+        void RemovePair(unsigned one, unsigned other);
+
+        /**
+        * Builds the key used to store a pair in the overlapping set.
+        */
+        static unsigned long long GetPairKey(unsigned one, unsigned other);
+
+    protected:
+        /**
+        * Holds every proxy, in use or free.
+        */
+        std::vector<Proxy> proxies;
+
+        /**
+        * Holds the first free proxy.
+        */
+        unsigned freeList;
+
+        /**
+        * Holds the sorted endpoints for each axis.
+        */
+        std::vector<Endpoint> endpoints[3];
+
+        /**
+        * Holds the pairs that overlap on all three axes.
+        */
+        std::unordered_set<unsigned long long> pairs;
+
+        /**
+        * Holds the pairs added by the last update.
+        */
+        ProxyPairs addedPairs;
+
+        /**
+        * Holds the pairs removed by the last update and the removals
+        * that led up to it.
+        */
+        ProxyPairs removedPairs;
+
+        /**
+        * True if the removed pairs should be cleared when the next
+        * update starts.
+        */
+        bool bClearRemovedPairs;
+    };
+}
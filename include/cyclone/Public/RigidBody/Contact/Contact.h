@@ -35,9 +35,10 @@ namespace cyclone
     public:
         /**
         * Sets the data that does not normally depend on the position
-        * of the contact (i.e. the bodies, and their material properties).
+        * of the contact (i.e. the bodies, and their material properties),
+        * and the features of the bodies that produced it.
         */
-        void SetBodyData(RigidBody* one, RigidBody* two, real friction, real restitution);
+        void SetBodyData(RigidBody* one, RigidBody* two, real friction, real restitution, unsigned feature = 0);
 
     protected:
         /**
@@ -100,7 +101,7 @@ namespace cyclone
         * save calculation time: the calling function has access to
         * these anyway.
         */
-        Vector3 CalculateFrictionlessImpulse(Matrix* inverseInertiaTensor);
+        Vector3 CalculateFrictionlessImpulse(Matrix3* inverseInertiaTensor);
 
         /**
         * Calculates the impulse needed to resolve this contact,
@@ -109,7 +110,26 @@ namespace cyclone
         * object - is specified to save calculation time: the calling
         * function has access to these anyway.
         */
-        Vector3 CalculateFrictionImpulse(Matrix* inverseInertiaTensor);
+        Vector3 CalculateFrictionImpulse(Matrix3* inverseInertiaTensor);
+
+        /**
+        * Calculates and returns the relative velocity of the bodies at
+        * the contact point, in contact coordinates, from their current
+        * velocities alone.
+        */
+        Vector3 CalculateRelativeVelocity() const;
+
+        /**
+        * Calculates the change in relative velocity along the given world
+        * direction that a unit impulse along it would make.
+        */
+        real CalculateVelocityPerImpulse(const Vector3& axis) const;
+
+        /**
+        * Applies the given impulse, in contact coordinates, to the bodies:
+        * as given to the first body and reversed to the second.
+        */
+        void ApplyImpulse(const Vector3& impulseContact);
 
     protected:
         /**
@@ -117,7 +137,7 @@ namespace cyclone
         * frame of reference to world co-ordinates. The columns of this
         * matrix form an orthonormal set of vectors.
         */
-        Matrix contactToWorld;
+        Matrix3 contactToWorld;
 
         /**
         * Holds the closing velocity at the point of contact. This is set
@@ -172,6 +192,16 @@ namespace cyclone
         */
         real penetration;
 
+        /**
+        * Identifies the features of the two bodies (the vertex, edge or
+        * face of each) that produced the contact. Together with the
+        * bodies it recognises the same contact from one frame to the
+        * next. Contacts whose generator can't tell features apart use 0.
+        * The world adds the index of the plane to those of contacts with
+        * its planes, as they all leave the second body null.
+        */
+        unsigned feature;
+
     private:
         /**
         * The contact resolver object needs access into the contacts to
@@ -1,10 +1,35 @@
 #pragma once
 
+#include <utility>
+#include <vector>
 #include "Contact.h"
+#include "Core/ThreadPool.h"
 #include "RigidBody/RigidBody.h"
 
 namespace cyclone
 {
+    /**
+    * Selects how a contact resolver removes the closing velocities at
+    * its contacts. Interpenetration is resolved the same way by both.
+    */
+    enum class ResolutionMode : unsigned char
+    {
+        /**
+        * Resolves the contact with the worst closing velocity at each
+        * iteration, as described for the contact resolver.
+        */
+        WorstFirst,
+
+        /**
+        * Sweeps over every contact at each iteration, accumulating the
+        * impulse at each and clamping the total so it never pulls the
+        * bodies together or exceeds the friction limit (projected
+        * Gauss-Seidel). The impulses are kept from one frame to the next
+        * and used as the starting point for the same contacts.
+        */
+        SequentialImpulse
+    };
+
     /**
      * The contact resolution routine. One resolver instance
      * can be shared for the whole simulation, as long as you need
@@ -52,6 +77,31 @@ namespace cyclone
      * In general this resolver is not suitable for stacks of bodies,
      * but is perfect for handling impact, explosive, and flat resting
      * situations.
+     *
+     * @section islands Islands
+     *
+     * Before resolving, the contacts are split into islands: groups
+     * that share no body with any other group, so resolving one can
+     * never change another. Each island is resolved on its own, which
+     * makes the cost of a frame the sum of the cost of its islands
+     * rather than growing with the total number of contacts. Given a
+     * thread pool, the islands are resolved in parallel. The islands,
+     * their order, their contacts and the iterations each is given
+     * depend only on the contacts, never on the threads, so the result
+     * is the same on any number of threads.
+     *
+     * Contacts with a missing second body (against the scenery) do not
+     * join islands together, but a body given infinite mass does, so
+     * static geometry is best represented without a body.
+     *
+     * @section sequential Sequential Impulses
+     *
+     * In the SequentialImpulse mode velocities are resolved by sweeping
+     * over all the contacts of an island instead, which converges much
+     * faster on stacks. Each contact keeps the total impulse applied to
+     * it, and at the start of the next frame the contact with the same
+     * bodies and feature gets that impulse back (warm starting), so a
+     * resting stack starts out almost resolved.
      */
     class ContactResolver
     {
@@ -89,14 +139,37 @@ namespace cyclone
         */
         void SetEpsilon(real velocityEpsilon, real positionEpsilon);
 
+        /**
+        * Sets the thread pool the islands are resolved on, or NULL to
+        * resolve them all on the calling thread. The pool is not owned
+        * by the resolver.
+        */
+        void SetThreadPool(ThreadPool* threadPool);
+
+        /**
+        * Sets the way the closing velocities are resolved.
+        */
+        void SetMode(ResolutionMode mode);
+
+        /**
+        * Returns the way the closing velocities are resolved.
+        */
+        ResolutionMode GetMode() const;
+
+        /**
+        * Sets the number of sweeps over each island's contacts made in
+        * the SequentialImpulse mode, and whether they start from last
+        * frame's impulses.
+        */
+        void SetImpulseIterations(unsigned impulseIterations, bool bWarmStarting = true);
+
         /**
         * Resolves a set of contacts for both penetration and velocity.
         *
-        * Contacts that cannot interact with
-        * each other should be passed to separate calls to resolveContacts,
-        * as the resolution algorithm takes much longer for lots of
-        * contacts than it does for the same number of contacts in small
-        * sets.
+        * Contacts that cannot interact with each other are found and
+        * resolved as separate islands, as the resolution algorithm takes
+        * much longer for lots of contacts than it does for the same
+        * number of contacts in small sets.
         *
         * @param contacts Pointer to an array of contact objects.
         *
@@ -114,6 +187,9 @@ namespace cyclone
         *
         * @param deltaTime The duration of the previous integration step.
         * This is used to compensate for forces applied.
+        *
+        * The iterations are shared out between the islands in proportion
+        * to their number of contacts.
         */
         void ResolveContacts(Contact* contacts, unsigned numContacts, real deltaTime);
 
@@ -121,21 +197,112 @@ namespace cyclone
         /**
         * Sets up contacts ready for processing. This makes sure their
         * internal data is configured correctly and the correct set of bodies
-        * is made alive.
+        * is made alive. It also links each body to the contacts it takes
+        * part in, and splits the contacts into islands. Returns the number
+        * of islands.
+        */
+        unsigned PrepareContacts(Contact* contacts, unsigned numContacts, real deltaTime);
+
+        /**
+        * Splits the contacts into islands of contacts sharing bodies,
+        * using the body adjacency, and fills the island arrays. Returns
+        * the number of islands.
+        */
+        unsigned BuildIslands(unsigned numContacts);
+
+        /**
+        * Returns the root of the island holding the given contact,
+        * flattening the path to it on the way.
+        */
+        unsigned FindIsland(unsigned index);
+
+        /**
+        * Resolves the contacts of the given island for penetration and
+        * velocity, recording the iterations used.
+        */
+        void ResolveIsland(Contact* contacts, unsigned numContacts, unsigned island, real deltaTime);
+
+        /**
+        * Resolves the velocity issues with the constraints of the given
+        * island, using up to the given number of iterations. Returns
+        * the number of iterations used.
+        */
+        unsigned AdjustVelocities(Contact* contacts, unsigned island, unsigned iterations, real deltaTime);
+
+        /**
+        * Resolves the positional issues with the constraints of the given
+        * island, using up to the given number of iterations. Returns
+        * the number of iterations used.
+        */
+        unsigned AdjustPositions(Contact* contacts, unsigned island, unsigned iterations);
+
+        /**
+        * Works out the velocity each contact should be left with and its
+        * response to impulses, and takes the impulse of the matching
+        * contact of the last frame as its starting impulse.
+        */
+        void PrepareImpulses(const Contact* contacts, unsigned numContacts);
+
+        /**
+        * Resolves the velocity issues with the constraints of the given
+        * island by sequential impulses, sweeping up to the given number
+        * of times. Returns the number of sweeps made.
         */
-        static void PrepareContacts(Contact* contacts, unsigned numContacts, real deltaTime);
+        unsigned SolveImpulses(Contact* contacts, unsigned island, unsigned iterations);
 
         /**
-        * Resolves the velocity issues with the given array of constraints,
-        * using the given number of iterations.
+        * Keeps the impulse of every contact for the next frame.
         */
-        void AdjustVelocities(Contact* contacts, unsigned numContacts, real deltaTime);
+        void StoreImpulses(const Contact* contacts, unsigned numContacts);
+
+    protected:
+        /**
+        * The state of one contact while sequential impulses are applied.
+        */
+        struct ContactImpulse
+        {
+            /**
+            * Holds the total impulse applied, in contact coordinates.
+            */
+            Vector3 impulse;
+
+            /**
+            * Holds the change in relative velocity along each contact
+            * axis per unit of impulse along it.
+            */
+            Vector3 velocityPerImpulse;
+
+            /**
+            * Holds the closing velocity the contact should be left with.
+            */
+            real targetVelocity;
+        };
 
         /**
-        * Resolves the positional issues with the given array of constraints,
-        * using the given number of iterations.
+        * An impulse kept from one frame for the same contact in the next.
         */
-        void AdjustPositions(Contact* contacts, unsigned numContacts, real deltaTime);
+        struct CachedImpulse
+        {
+            /**
+            * Holds the bodies of the contact.
+            */
+            const RigidBody* body[2];
+
+            /**
+            * Holds the feature of the contact.
+            */
+            unsigned feature;
+
+            /**
+            * Holds the total impulse, in world coordinates.
+            */
+            Vector3 impulse;
+
+            /**
+            * Orders impulses by bodies then feature.
+            */
+            bool operator<(const CachedImpulse& other) const;
+        };
 
     public:
         /**
@@ -180,5 +347,79 @@ namespace cyclone
         * the default of0.01.
         */
         real positionEpsilon;
+
+        /**
+        * Holds the thread pool the islands are resolved on, if any.
+        */
+        ThreadPool* threadPool;
+
+        /**
+        * Holds the way closing velocities are resolved.
+        */
+        ResolutionMode mode;
+
+        /**
+        * Holds the number of sweeps over an island in the
+        * SequentialImpulse mode.
+        */
+        unsigned impulseIterations;
+
+        /**
+        * True if sequential impulses start from last frame's impulses.
+        */
+        bool bWarmStarting;
+
+        /**
+        * Holds the union-find parent of each contact while the islands
+        * are built.
+        */
+        std::vector<unsigned> islandParents;
+
+        /**
+        * Holds each body of each contact with the contact's index times
+        * two plus the side of the contact the body is on, sorted by body
+        * so the contacts sharing a body sit next to each other.
+        */
+        std::vector<std::pair<const RigidBody*, unsigned>> bodyContacts;
+
+        /**
+        * Holds, for each side of each contact, the range of entries in
+        * the body contacts sharing the body on that side. The range is
+        * empty if there is no body.
+        */
+        std::vector<std::pair<unsigned, unsigned>> contactAdjacency;
+
+        /**
+        * Holds the contact indices grouped by island. While an island is
+        * being resolved, its part of the array is kept as a max-heap on
+        * the value being resolved.
+        */
+        std::vector<unsigned> islandContacts;
+
+        /**
+        * Holds where each island starts in the grouped contact indices,
+        * with one extra entry marking the end of the last.
+        */
+        std::vector<unsigned> islandStarts;
+
+        /**
+        * Holds the velocity and position iterations used by each island.
+        */
+        std::vector<std::pair<unsigned, unsigned>> islandIterationsUsed;
+
+        /**
+        * Holds the place of each contact in its island's heap.
+        */
+        std::vector<unsigned> heapPositions;
+
+        /**
+        * Holds the sequential impulse state of each contact.
+        */
+        std::vector<ContactImpulse> contactImpulses;
+
+        /**
+        * Holds the impulses of the last frame's contacts, sorted.
+        */
+        std::vector<CachedImpulse> impulseCache;
     };
 }
@@ -10,6 +10,12 @@ namespace cyclone
     */
     class CollisionBox : public CollisionPrimitive
     {
+    public:
+        /**
+        * Creates a new box.
+        */
+        CollisionBox();
+
     public:
         /**
         * Holds the half-sizes of the box along each of its local axes.
@@ -0,0 +1,260 @@
+#pragma once
+
+/**
+* @file
+*
+* This file contains the persistent contact manifolds, which keep the
+* contacts between a pair of primitives from one frame to the next.
+*/
+
+#include <unordered_map>
+#include <utility>
+#include "CollisionDetector.h"
+
+namespace cyclone
+{
+    /**
+    * One contact point kept in a manifold. The point is held on each
+    * body in its own coordinates, so it can be brought up to date as the
+    * bodies move without running the collision test again.
+    */
+    struct ManifoldPoint
+    {
+        /**
+        * Holds the contact point on each body, in that body's coordinates,
+        * or in world coordinates if there is no body. The point on the
+        * second body lies the penetration depth along the normal from
+        * the point on the first.
+        */
+        Vector3 localPoint[2];
+
+        /**
+        * Holds the contact normal in world coordinates, as it was when
+        * the point was found.
+        */
+        Vector3 normal;
+
+        /**
+        * Holds the feature of the bodies that produced the point.
+        */
+        unsigned feature;
+
+        /**
+        * Holds the contact point on the first body in world coordinates,
+        * as of the last refresh.
+        */
+        Vector3 worldPoint;
+
+        /**
+        * Holds the penetration depth as of the last refresh.
+        */
+        real penetration;
+    };
+
+    /**
+    * Keeps up to four contact points between two primitives across
+    * frames. Each frame the points are refreshed from the bodies' new
+    * positions and dropped once the bodies have moved apart or slid too
+    * far; new contacts from the collision tests are merged in, replacing
+    * the point with the same feature. Resting bodies therefore build up
+    * a full set of points even from tests that find one point a frame,
+    * and the points keep their features for warm starting.
+    *
+    * The manifold also remembers where the bodies were when it last ran
+    * the collision tests. While neither body has moved noticeably since,
+    * the refreshed points can be used in place of running the tests.
+    */
+    class ContactManifold
+    {
+    public:
+        /**
+        * The most points a manifold keeps.
+        */
+        static constexpr unsigned MaxPoints = 4;
+
+        /**
+        * How far, in world units, a point may drift apart or sideways
+        * before it is dropped.
+        */
+        static constexpr real BreakingThreshold = 0.02f;
+
+        /**
+        * How far, in world units, a body may move before the collision
+        * tests are run again.
+        */
+        static constexpr real ReuseDistance = 0.005f;
+
+        /**
+        * The lowest cosine of half the angle a body may turn through
+        * before the collision tests are run again.
+        */
+        static constexpr real ReuseAlignment = 0.99999f;
+
+    public:
+        /**
+        * Creates an empty manifold between the two primitives.
+        */
+        ContactManifold(const CollisionPrimitive* one, const CollisionPrimitive* two);
+
+        /**
+        * Returns true if neither body has moved noticeably since the
+        * collision tests were last run for this manifold, so its points
+        * can be used as they are.
+        */
+        bool CanReuse() const;
+
+        /**
+        * Brings the points up to date with the bodies, dropping those
+        * that are no longer valid.
+        */
+        void Refresh();
+
+        /**
+        * Merges the contacts found by a collision test into the manifold,
+        * and remembers where the bodies were.
+        */
+        void Merge(const Contact* contacts, unsigned count);
+
+        /**
+        * Writes the points into the given collision data as contacts.
+        * Returns the number of contacts written.
+        */
+        unsigned WriteContacts(CollisionData* data) const;
+
+        /**
+        * Returns the number of points held.
+        */
+        unsigned GetPointCount() const;
+
+        /**
+        * Returns the point at the given index.
+        */
+        const ManifoldPoint& GetPoint(unsigned index) const;
+
+    protected:
+        /**
+        * Adds a new point, making room for it if the manifold is full.
+        */
+        void AddPoint(const ManifoldPoint& point);
+
+        /**
+        * Returns the index of the point to drop so that the remaining
+        * points keep the deepest one and cover the largest area.
+        */
+        unsigned FindPointToDrop(const ManifoldPoint& point) const;
+
+        /**
+        * Moves a world point onto the given body's coordinates.
+        */
+        static Vector3 ToLocal(const RigidBody* body, const Vector3& point);
+
+        /**
+        * Moves a point in the given body's coordinates into the world.
+        */
+        static Vector3 ToWorld(const RigidBody* body, const Vector3& point);
+
+    public:
+        /**
+        * Holds the primitives in contact.
+        */
+        const CollisionPrimitive* primitive[2];
+
+        /**
+        * Holds the frame the manifold was last used in, so manifolds of
+        * pairs that are no longer touching can be found and removed.
+        */
+        unsigned lastFrame;
+
+    protected:
+        /**
+        * Holds the bodies the points are held on, in the order the
+        * collision tests give them.
+        */
+        RigidBody* body[2];
+
+        /**
+        * Holds the points.
+        */
+        ManifoldPoint points[MaxPoints];
+
+        /**
+        * Holds the number of points held.
+        */
+        unsigned pointCount;
+
+        /**
+        * True once the collision tests have been run for this manifold.
+        */
+        bool bTested;
+
+        /**
+        * Holds the position of each body when the collision tests were
+        * last run.
+        */
+        Vector3 testedPosition[2];
+
+        /**
+        * Holds the orientation of each body when the collision tests were
+        * last run.
+        */
+        Quaternion testedOrientation[2];
+    };
+
+    /**
+    * Holds the manifolds of every pair of primitives in contact, keyed
+    * by the pair. Manifolds not used during a frame are removed at its
+    * end.
+    */
+    class ContactManifoldCache
+    {
+    public:
+        ContactManifoldCache();
+
+        /**
+        * Starts a new frame of manifold use.
+        */
+        void BeginFrame();
+
+        /**
+        * Removes the manifolds that were not used during the frame.
+        */
+        void EndFrame();
+
+        /**
+        * Returns the manifold of the given pair of primitives, creating
+        * it if needed, and marks it as used this frame.
+        */
+        ContactManifold& Find(const CollisionPrimitive* one, const CollisionPrimitive* two);
+
+        /**
+        * Removes all the manifolds.
+        */
+        void Clear();
+
+        /**
+        * Returns the number of manifolds held.
+        */
+        unsigned GetManifoldCount() const;
+
+    protected:
+        typedef std::pair<const CollisionPrimitive*, const CollisionPrimitive*> Key;
+
+        /**
+        * Hashes a pair of primitives.
+        */
+        struct KeyHash
+        {
+            size_t operator()(const Key& key) const;
+        };
+
+        /**
+        * Holds the manifolds.
+        */
+        std::unordered_map<Key, ContactManifold, KeyHash> manifolds;
+
+        /**
+        * Holds the number of the current frame.
+        */
+        unsigned frame;
+    };
+}
@@ -3,6 +3,7 @@
 #include "RigidBody/FineCollision/CollisionSphere.h"
 #include "RigidBody/FineCollision/CollisionPlane.h"
 #include "RigidBody/FineCollision/CollisionBox.h"
+#include "RigidBody/FineCollision/Ray.h"
 
 namespace cyclone
 {
@@ -20,6 +21,18 @@ namespace cyclone
 
         static bool BoxAndBox(const CollisionBox& one, const CollisionBox& two);
 
+        /**
+        * Checks if the sphere reaches the point of the box nearest to
+        * its centre.
+        */
+        static bool BoxAndSphere(const CollisionBox& box, const CollisionSphere& sphere);
+
+        /**
+        * Runs whichever of the tests above matches the types of the two
+        * primitives, which must each be a box or a sphere.
+        */
+        static bool PrimitiveAndPrimitive(const CollisionPrimitive& one, const CollisionPrimitive& two);
+
         /**
         * Does an intersection test on an arbitrarily aligned box and a
         * half-space.
@@ -33,5 +46,32 @@ namespace cyclone
         * direction.
         */
         static bool BoxAndHalfSpace(const CollisionBox& box, const CollisionPlane& plane);
+
+        /**
+        * Casts the ray against the sphere. If the ray meets it within its
+        * maximum distance, writes where into the given hit and returns
+        * true. The primitives are solid, so a ray starting inside one
+        * hits it straight away, facing back along the ray.
+        */
+        static bool RayAndSphere(const Ray& ray, const CollisionSphere& sphere, RayHit* hit);
+
+        /**
+        * Casts the ray against the box, as RayAndSphere. The ray is
+        * taken into the box's coordinates and clipped against the three
+        * pairs of faces.
+        */
+        static bool RayAndBox(const Ray& ray, const CollisionBox& box, RayHit* hit);
+
+        /**
+        * Casts the ray against the half-space behind the plane, as
+        * RayAndSphere.
+        */
+        static bool RayAndHalfSpace(const Ray& ray, const CollisionPlane& plane, RayHit* hit);
+
+        /**
+        * Casts the ray against whichever of the tests above matches the
+        * primitive's type.
+        */
+        static bool RayAndPrimitive(const Ray& ray, const CollisionPrimitive& primitive, RayHit* hit);
     };
 }
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "Core/Vector3.h"
+
+namespace cyclone
+{
+    /*
+    * Forward declarations, the hit only refers to what it found.
+    */
+    class RigidBody;
+
+    class CollisionPrimitive;
+
+    /**
+    * A ray to cast into the world: it starts at the origin and runs
+    * along the direction, which must be a unit vector, for at most the
+    * maximum distance.
+    */
+    struct Ray
+    {
+        Vector3 origin;
+
+        Vector3 direction;
+
+        real maxDistance;
+    };
+
+    /**
+    * Holds the closest point at which a ray meets a primitive.
+    */
+    struct RayHit
+    {
+        /**
+        * Holds the body of the primitive that was hit, or NULL for
+        * planes and for rays that hit nothing.
+        */
+        RigidBody* body;
+
+        /**
+        * Holds the primitive that was hit, or NULL if the ray hit nothing.
+        */
+        CollisionPrimitive* primitive;
+
+        /**
+        * Holds how far along the ray the hit is.
+        */
+        real distance;
+
+        /**
+        * Holds the point of the hit in world coordinates.
+        */
+        Vector3 point;
+
+        /**
+        * Holds the normal of the surface at the hit, facing the ray.
+        */
+        Vector3 normal;
+    };
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "RigidBody/FineCollision/CollisionBox.h"
+#include "RigidBody/FineCollision/CollisionPlane.h"
+#include "RigidBody/FineCollision/CollisionSphere.h"
+
+namespace cyclone
+{
+    /**
+    * The motion of a body over one step: from the given position and
+    * orientation, at the given velocity and rotation, for the given
+    * time. The body moves along the path the integrator takes, so the
+    * end of the sweep is where the integrator puts the body.
+    */
+    struct BodySweep
+    {
+        Vector3 position;
+
+        Quaternion orientation;
+
+        Vector3 velocity;
+
+        Vector3 rotation;
+
+        real duration;
+
+        /**
+        * Returns the position of the body the given fraction of the way
+        * through the sweep.
+        */
+        Vector3 GetPosition(real fraction) const;
+
+        /**
+        * Returns the orientation of the body the given fraction of the
+        * way through the sweep.
+        */
+        Quaternion GetOrientation(real fraction) const;
+
+        /**
+        * Returns the transform of the body the given fraction of the
+        * way through the sweep.
+        */
+        Matrix3x4 GetTransform(real fraction) const;
+    };
+
+    /**
+    * Holds a primitive met by a shape swept along a path, and the
+    * fraction of the path at which the shape first touches it.
+    */
+    struct SweepHit
+    {
+        RigidBody* body;
+
+        CollisionPrimitive* primitive;
+
+        real fraction;
+    };
+
+    /**
+    * A wrapper class that holds the time of impact queries, which find
+    * where a moving primitive first reaches another rather than only
+    * checking where it ends up, so fast bodies can't pass through thin
+    * ones between two steps.
+    *
+    * The queries use conservative advancement: the primitive is moved
+    * on by the distance between the two, divided by how fast it is
+    * heading towards the other plus the most spinning can add to that,
+    * which can never carry it past the point of impact. Spheres moving
+    * in a straight line get there in one or two moves, and spinning
+    * boxes take a few more.
+    */
+    class TimeOfImpact
+    {
+    public:
+        /**
+        * The most moves a query makes before settling for where it is.
+        */
+        static constexpr unsigned MaxIterations = 32;
+
+        /**
+        * Returns the distance between the two primitives placed with the
+        * given transforms, or how deep they overlap as a negative number.
+        * For two boxes it is the widest gap along the separating axes,
+        * which may be less than the true distance but never more. The
+        * transform of a plane is not used. If a normal is given, it is
+        * set to the direction in which moving the first primitive opens
+        * the gap fastest.
+        */
+        static real GetSeparation(const CollisionPrimitive& one, const Matrix3x4& oneTransform,
+                                  const CollisionPrimitive& two, const Matrix3x4& twoTransform,
+                                  Vector3* normal = nullptr);
+
+        /**
+        * Returns how far any point of the given primitive can be from the
+        * centre of its body, for bounding how fast it moves as it spins.
+        */
+        static real GetMotionRadius(const CollisionPrimitive& primitive);
+
+        /**
+        * Sweeps the given box or sphere, attached to a body making the
+        * given sweep, against the other primitive where it is now. Writes
+        * the fraction of the sweep at which the two first come within
+        * the given tolerance of the target separation, and returns true,
+        * if they do. A negative target finds the point where they overlap
+        * by that much, which the fine collision tests are sure to pick
+        * up. A sweep still closing in after MaxIterations moves is only
+        * grazing the other, and is taken as a hit where it got to, so
+        * a bullet skimming a wall stops rather than passing through.
+        */
+        static bool Sweep(const CollisionPrimitive& moving, const BodySweep& sweep, const CollisionPrimitive& other,
+                          real targetSeparation, real tolerance, real* fraction);
+    };
+}
@@ -17,6 +17,9 @@ namespace cyclone
         /** Applies the gravitational force to the given rigid body. */
         void UpdateForce(RigidBody* body, real deltaTime) override;
 
+        /** Applies the buoyancy force to each of the given rigid bodies. */
+        void UpdateForces(RigidBody* const* bodies, unsigned count, real deltaTime) override;
+
     private:
         /**
         * The maximum submersion depth of the object before
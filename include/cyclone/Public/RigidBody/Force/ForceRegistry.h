@@ -1,22 +1,65 @@
 #pragma once
 
 #include "ForceGenerator.h"
+#include "Core/ThreadPool.h"
 #include "RigidBody/RigidBody.h"
+#include <unordered_map>
 #include <vector>
 
 namespace cyclone
 {
     /**
     * Holds all the force generators and the bodies they apply to.
+    *
+    * The registrations are grouped into one batch per generator, kept up
+    * to date as they are added and removed, and each generator is handed
+    * all of its bodies at once. A generator registered against hundreds
+    * of bodies, such as gravity, then makes one call running a tight loop
+    * rather than one virtual call per body.
+    *
+    * Each registration has a handle it can be removed by in constant
+    * time, which keeps bodies that come and go cheap to register.
     */
     class ForceRegistry
     {
     public:
+        /**
+        * The number of bodies handed to a generator as one job when the
+        * forces are updated on a thread pool.
+        */
+        static constexpr unsigned BodiesPerJob = 64;
+
+    public:
+        /**
+        * Identifies a registration. The low half holds the slot the
+        * registration is found through, and the high half how many times
+        * that slot had been reused when the handle was handed out. Once
+        * the registration is removed the handle identifies nothing, even
+        * after its slot is reused.
+        */
+        typedef unsigned long long Handle;
+
+        /**
+        * A handle that never identifies a registration.
+        */
+        static constexpr Handle InvalidHandle = ~0ull;
+
+    public:
+        ForceRegistry();
+
         /**
         * Registers the given force generator to apply to the
-        * given body.
+        * given body, and returns the handle of the registration.
+        */
+        Handle Add(RigidBody* body, ForceGenerator* forceGenerator);
+
+        /**
+        * Removes the registration with the given handle in constant
+        * time, by moving the last registration into its place. If the
+        * handle doesn't identify a registration, including one that has
+        * already been removed, this method will have no effect.
         */
-        void Add(RigidBody* body, ForceGenerator* forceGenerator);
+        void Remove(Handle handle);
 
         /**
         * Removes the given registered pair from the registry.
@@ -25,6 +68,12 @@ namespace cyclone
         */
         void Remove(RigidBody* body, ForceGenerator* forceGenerator);
 
+        /**
+        * Removes every registration of the given body, in one pass over
+        * the registrations.
+        */
+        void RemoveAllFor(const RigidBody* body);
+
         /**
         * Clears all registrations from the registry. This will
         * not delete the bodies or the force generators
@@ -34,9 +83,15 @@ namespace cyclone
 
         /**
         * Calls all the force generators to update the forces of
-        * their corresponding bodies.
+        * their corresponding bodies, one batch after another. If a
+        * thread pool is given, the bodies of each batch are shared out
+        * between its threads. Each body still sees its forces added in
+        * the order of the batches, so they add up to exactly the same
+        * sums on any number of threads. Each generator must only add
+        * forces to the bodies it is given, as all of those in the
+        * library do.
         */
-        void UpdateForces(real deltaTime);
+        void UpdateForces(real deltaTime, ThreadPool* threadPool = nullptr);
 
     protected:
         /**
@@ -49,17 +104,124 @@ namespace cyclone
 
             ForceGenerator* forceGenerator;
 
+            /**
+            * Holds the index of the registration's batch, or InvalidIndex
+            * if it has no generator, and its place in the batch.
+            */
+            unsigned batch;
+
+            unsigned member;
+
             ForceRegistration(RigidBody* body, ForceGenerator* forceGenerator): body(body),
-                forceGenerator(forceGenerator)
+                forceGenerator(forceGenerator), batch(0), member(0)
             {
             }
         };
 
+        /**
+        * Removes the registration at the given index, moving the last
+        * registration into its place.
+        */
+        void RemoveAt(unsigned index);
+
         /**
         * Holds the list of registrations.
         */
         typedef std::vector<ForceRegistration> Registry;
 
         Registry registrations;
+
+        /**
+        * Holds the handle of each registration, in the same order.
+        */
+        std::vector<Handle> handles;
+
+        /**
+        * Leads from a handle to its registration.
+        */
+        struct HandleSlot
+        {
+            /**
+            * Holds the index of the registration, or InvalidIndex if the
+            * slot is not in use.
+            */
+            unsigned index;
+
+            /**
+            * Holds the number of times the slot has been freed.
+            */
+            unsigned generation;
+        };
+
+        /**
+        * The index of a slot not in use.
+        */
+        static constexpr unsigned InvalidIndex = ~0u;
+
+        /**
+        * Frees the slot of the given handle, so the handle no longer
+        * identifies anything and the slot can be handed out again.
+        */
+        void FreeSlot(Handle handle);
+
+        /**
+        * Holds the slot of every handle handed out.
+        */
+        std::vector<HandleSlot> slots;
+
+        /**
+        * Holds the slots not in use, to be handed out again.
+        */
+        std::vector<unsigned> freeSlots;
+
+        /**
+        * The bodies a generator is registered for. Removing one moves the
+        * last into its place, so a batch is kept up to date in constant
+        * time as registrations come and go.
+        */
+        struct ForceBatch
+        {
+            ForceGenerator* forceGenerator;
+
+            std::vector<RigidBody*> bodies;
+
+            /**
+            * Holds the index of the registration of each of the bodies.
+            */
+            std::vector<unsigned> registrations;
+
+            /**
+            * Holds how many times each of the bodies appears.
+            */
+            std::unordered_map<const RigidBody*, unsigned> counts;
+
+            /**
+            * Holds the number of bodies that appear more than once. A
+            * batch with any can't be split between threads.
+            */
+            unsigned repeats;
+        };
+
+        /**
+        * Adds the registration at the given index to its generator's
+        * batch, starting a batch if the generator has none.
+        */
+        void AddToBatch(unsigned index);
+
+        /**
+        * Takes the registration at the given index out of its batch,
+        * dropping the batch once it is empty.
+        */
+        void RemoveFromBatch(unsigned index);
+
+        /**
+        * Holds one batch per generator.
+        */
+        std::vector<ForceBatch> batches;
+
+        /**
+        * Holds the index of the batch of each generator.
+        */
+        std::unordered_map<const ForceGenerator*, unsigned> batchIndices;
     };
 }
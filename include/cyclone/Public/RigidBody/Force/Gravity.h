@@ -14,9 +14,12 @@ namespace cyclone
         /** Creates the generator with the given acceleration. */
         Gravity(const Vector3& gravity);
 
-        /** Applies the gravitational force to the given rigid body. */
+        /** Applies the gravitational force to the given rigid body, unless it is asleep. */
         void UpdateForce(RigidBody* body, real deltaTime) override;
 
+        /** Applies the gravitational force to each of the given rigid bodies that is awake. */
+        void UpdateForces(RigidBody* const* bodies, unsigned count, real deltaTime) override;
+
     private:
         /** Holds the acceleration due to gravity. */
         Vector3 gravity;
@@ -0,0 +1,619 @@
+#pragma once
+
+/**
+* @file
+*
+* This file contains the definitions for a structure to hold any number of
+* rigid bodies, the primitives that represent them for collision detection,
+* and the step that moves them all forward in time.
+*/
+
+#include <cstdint>
+#include <vector>
+#include "RigidBody.h"
+#include "Core/TaskGraph.h"
+#include "CoarseCollision/DynamicAABBTree.h"
+#include "Contact/ContactGenerator.h"
+#include "Contact/ContactResolver.h"
+#include "FineCollision/CollisionDetector.h"
+#include "FineCollision/ContactManifold.h"
+#include "FineCollision/TimeOfImpact.h"
+#include "Force/ForceRegistry.h"
+
+namespace cyclone
+{
+    /**
+    * The rigid body counterpart of ParticleWorld. Keeps track of a set of
+    * rigid bodies and their collision primitives, and provides the means
+    * to step them all through integration, coarse collision detection,
+    * fine collision detection and contact resolution.
+    *
+    * Bodies and primitives are stored by value in arrays that are sized
+    * when the world is created, so the pointers handed out by the world
+    * stay valid for its whole life. The world has no rendering
+    * dependencies and can be run headless.
+    */
+    class World
+    {
+    public:
+        typedef std::vector<RigidBody> Bodies;
+
+        typedef std::vector<CollisionBox> Boxes;
+
+        typedef std::vector<CollisionSphere> Spheres;
+
+        typedef std::vector<CollisionPlane> Planes;
+
+        typedef std::vector<ContactGenerator*> ContactGenerators;
+
+        typedef std::vector<PotentialContact> PotentialContacts;
+
+        /**
+        * The number of pairs whose collision tests run as one piece of
+        * work when the tests are spread over a thread pool.
+        */
+        static constexpr unsigned PairsPerSlab = 32;
+
+        /**
+        * The most contacts the collision tests can find for one pair.
+        */
+        static constexpr unsigned MaxContactsPerPair = 8;
+
+        /**
+        * The number of bodies, or primitives, updated as one job when
+        * the work is spread over a thread pool.
+        */
+        static constexpr unsigned BodiesPerJob = 64;
+
+        /**
+        * While fewer than one body in this many is awake, the potential
+        * contacts are found by querying the broadphase around each awake
+        * body, rather than by walking the whole tree.
+        */
+        static constexpr unsigned AwakeQueryRatio = 4;
+
+        /**
+        * How deep a bullet is left in what it hits, so the collision
+        * tests pick the contact up.
+        */
+        static constexpr real BulletPenetration = 0.01f;
+
+        /**
+        * The most planes the world can hold.
+        */
+        static constexpr unsigned MaxPlanes = 16;
+
+    public:
+        /**
+        * Creates a new simulator that can hold up to the given number of
+        * bodies and handle up to the given number of contacts per frame.
+        * You can also optionally give a number of contact-resolution
+        * iterations to use. If you don't give a number of iterations,
+        * then four times the number of contacts will be used.
+        */
+        World(unsigned maxBodies, unsigned maxContacts, unsigned iterations = 0);
+
+        /**
+        * Deletes the simulator.
+        */
+        ~World();
+
+        World(const World&) = delete;
+
+        World& operator=(const World&) = delete;
+
+        /**
+        * Adds a new rigid body to the world and returns it, ready to have
+        * its mass, inertia and state set up. Returns NULL if the world
+        * is already holding its maximum number of bodies.
+        */
+        RigidBody* AddBody();
+
+        /**
+        * Adds a box primitive with the given half-sizes to represent the
+        * given body, which must belong to this world. Each body can be
+        * represented by at most one primitive.
+        */
+        CollisionBox* AddBox(RigidBody* body, const Vector3& halfSize);
+
+        /**
+        * Adds a sphere primitive with the given radius to represent the
+        * given body, which must belong to this world. Each body can be
+        * represented by at most one primitive.
+        */
+        CollisionSphere* AddSphere(RigidBody* body, real radius);
+
+        /**
+        * Adds an immovable half-space to the world and returns it.
+        * Returns NULL if the world is already holding MaxPlanes planes.
+        */
+        CollisionPlane* AddPlane(const Vector3& direction, real offset);
+
+        /**
+        * Sets the material values written into every contact the world
+        * generates.
+        */
+        void SetContactProperties(real friction, real restitution, real tolerance = 0.1f);
+
+        /**
+        * Sets whether the given body, which must belong to this world,
+        * is a bullet. Bullets are swept from where they start each step
+        * to where they end it, against the planes and every primitive
+        * the broadphase finds along the way, and stopped at the first
+        * impact, so a fast body can't pass through a thin one between
+        * two steps. Whatever motion a bullet has left after the impact
+        * is lost for that step. The other bodies are taken where they
+        * end the step.
+        */
+        void SetBullet(RigidBody* body, bool bBullet = true);
+
+        /**
+        * Sets the thread pool the world spreads its work over, or NULL
+        * to run on the calling thread. The pool is not owned by the world.
+        * Every stage of a step is spread over it in a fixed order: the
+        * forces of each body add up in the order of the force batches,
+        * the contacts come out in the order of the pairs, and each island
+        * of contacts is resolved on its own. The bodies therefore end up
+        * in bitwise the same state on any number of threads, which
+        * GetStateHash can be used to check.
+        */
+        void SetThreadPool(ThreadPool* threadPool);
+
+        /**
+        * Sets whether the contacts of each pair of primitives are kept
+        * in a manifold from one frame to the next. They are by default.
+        * Kept contacts build up several points for resting bodies, keep
+        * their features for warm starting, and let the collision tests
+        * be skipped for pairs that haven't moved.
+        */
+        void SetPersistentContacts(bool bPersistentContacts);
+
+        /**
+        * Initializes the world for a simulation frame. This clears
+        * the force accumulators and updates the derived data of the
+        * bodies in the world. After calling this, the bodies can have
+        * their forces for this frame added.
+        */
+        void StartFrame();
+
+        /**
+        * Integrates the awake bodies in this world forward in time
+        * by the given deltaTime, and updates their primitives.
+        * Sleeping bodies are left where they are.
+        */
+        void Integrate(real deltaTime);
+
+        /**
+        * Finds the pairs of bodies whose primitives may be touching, of
+        * which at least one was awake when the last integration began.
+        * Returns the number of potential contacts found.
+        */
+        unsigned GeneratePotentialContacts();
+
+        /**
+        * Runs the fine collision tests on the potential contacts, the
+        * planes and the registered contact generators. Returns the
+        * number of generated contacts.
+        */
+        unsigned GenerateContacts();
+
+        /**
+        * Processes all the physics for the world: applies the force
+        * generators, integrates, detects collisions, resolves them and
+        * puts the islands that have come to rest to sleep. The stages are
+        * run as a graph of tasks on the thread pool.
+        *
+        * Bodies touching each other form an island, which goes to sleep
+        * as a whole once one of its bodies falls asleep and none of the
+        * others is moving more than it was when woken, and is woken as a
+        * whole when any of its bodies is.
+        * Sleeping bodies are skipped by the integration, the broadphase
+        * and the collision tests, so a settled pile costs next to
+        * nothing until something disturbs it.
+        */
+        void Step(real deltaTime);
+
+        /**
+        * Returns the number of bodies that were awake when the last
+        * integration began.
+        */
+        unsigned GetAwakeBodyCount() const;
+
+        /**
+        * Casts each of the given rays into the world, writing the closest
+        * hit of each, against the planes and the primitives of every body,
+        * to the matching entry of the given hits. Returns the number of
+        * rays that hit something.
+        *
+        * The primitives are found by tracing the rays through the
+        * broadphase in SIMD packets, so a batch costs far less than
+        * casting the rays one at a time. The world is only read, so any
+        * number of threads can cast rays at the same time between steps,
+        * as long as none of them changes or steps the world meanwhile.
+        */
+        unsigned RaycastAll(const Ray* rays, unsigned count, RayHit* hits) const;
+
+        /**
+        * Finds the bodies whose primitives overlap the given box or
+        * sphere, writing them to the given array (up to the given limit).
+        * Returns the number of bodies found. The shape's internals must
+        * be up to date, and a shape without a body is placed by its
+        * offset. See DynamicAABBTree::Overlap.
+        */
+        unsigned Overlap(const CollisionPrimitive& shape, RigidBody** bodies, unsigned limit) const;
+
+        /**
+        * Sweeps the given box or sphere along the given motion, writing
+        * the bodies it touches on the way to the given array, nearest
+        * first (up to the given limit). Returns the number of hits
+        * written. See DynamicAABBTree::Sweep.
+        */
+        unsigned Sweep(const CollisionPrimitive& shape, const Vector3& motion, SweepHit* hits, unsigned limit) const;
+
+        /**
+        * Returns the list of bodies.
+        */
+        Bodies& GetBodies();
+
+        /**
+        * Returns the list of box primitives.
+        */
+        Boxes& GetBoxes();
+
+        /**
+        * Returns the list of sphere primitives.
+        */
+        Spheres& GetSpheres();
+
+        /**
+        * Returns the list of planes.
+        */
+        Planes& GetPlanes();
+
+        /**
+        * Returns the list of contact generators.
+        */
+        ContactGenerators& GetContactGenerators();
+
+        /**
+        * Returns the force registry.
+        */
+        ForceRegistry& GetForceRegistry();
+
+        /**
+        * Returns the contact resolver, to pick its resolution mode.
+        */
+        ContactResolver& GetContactResolver();
+
+        /**
+        * Returns a hash of the position, orientation, velocity, rotation
+        * and awake state of every body, in body order. Two runs that
+        * agree on it are in bitwise the same state, so it can be used to
+        * check replays and lockstep simulations against each other.
+        */
+        std::uint64_t GetStateHash() const;
+
+        /**
+        * Returns the contacts generated in the last frame.
+        */
+        Contact* GetContacts() const;
+
+        /**
+        * Returns the number of contacts generated in the last frame.
+        */
+        unsigned GetContactCount() const;
+
+    protected:
+        /**
+        * Returns the index of the given body in the body array.
+        */
+        unsigned GetBodyIndex(const RigidBody* body) const;
+
+        /**
+        * Returns the world space box enclosing the given primitive.
+        */
+        static BoundingBox GetBoundingVolume(const CollisionPrimitive& primitive);
+
+        /**
+        * Runs the task once for each index up to the given count, in
+        * jobs of BodiesPerJob on the thread pool if there is one.
+        */
+        void ParallelFor(unsigned count, const ThreadPool::Task& task);
+
+        /**
+        * Wakes the whole sleeping island of every body that has been
+        * woken on its own, then lists the bodies that are awake.
+        */
+        void UpdateAwakeBodies();
+
+        /**
+        * Wakes every body of the sleeping island of the given body.
+        */
+        void WakeIsland(unsigned index);
+
+        /**
+        * Returns the body heading the sleeping island of the given body.
+        */
+        unsigned FindSleepingIsland(unsigned index);
+
+        /**
+        * Joins the sleeping islands of the two given bodies into one.
+        */
+        void JoinSleepingIslands(unsigned one, unsigned another);
+
+        /**
+        * Returns the body heading the island of the given body among the
+        * islands formed by this frame's contacts.
+        */
+        unsigned FindIsland(unsigned index);
+
+        /**
+        * Groups the bodies touching each other through this frame's
+        * contacts into islands. An island still moving wakes any of its
+        * bodies that are asleep, and one where a body has fallen asleep
+        * while the rest are settling is put to sleep as a whole.
+        */
+        void UpdateSleepingIslands();
+
+        /**
+        * Notes where each awake bullet starts the step.
+        */
+        void RecordBulletSweeps();
+
+        /**
+        * Moves each awake bullet back to its first impact of the step,
+        * if it had one.
+        */
+        void SweepBullets(real deltaTime);
+
+        /**
+        * Integrates every awake body forward in time.
+        */
+        void IntegrateBodies(real deltaTime);
+
+        /**
+        * Brings the primitives of the awake bodies up to date.
+        */
+        void UpdateAwakePrimitives();
+
+        /**
+        * Brings the box primitives up to date with their bodies.
+        */
+        void UpdateBoxes();
+
+        /**
+        * Brings the sphere primitives up to date with their bodies.
+        */
+        void UpdateSpheres();
+
+        /**
+        * Moves each awake body's leaf in the broadphase, predicting where
+        * the body is headed over the given time.
+        */
+        void UpdateBroadphase(real deltaTime);
+
+        /**
+        * Runs the fine collision tests on everything in the world,
+        * stopping when the contacts run out.
+        */
+        void RunCollisionTests();
+
+        /**
+        * Lists the pairs of primitives to run the fine collision tests
+        * on: every awake primitive against every plane, then the potential
+        * contacts. The manifold of each pair is found here too, as the
+        * manifold cache can't be changed while the tests run in parallel.
+        */
+        void GatherCollisionPairs();
+
+        /**
+        * Runs the fine collision tests on the listed pairs in slabs of
+        * PairsPerSlab pairs, spread over the thread pool if there is one.
+        * Each slab writes into its own part of the slab contacts, and the
+        * slabs are then copied into the contact array in pair order, so
+        * the result is the same on any number of threads.
+        */
+        void CollidePairs();
+
+        /**
+        * Writes the contacts between the two primitives, through the
+        * given manifold if there is one. Only the manifold and the data
+        * are written to, so pairs with different manifolds and data can
+        * be run at the same time.
+        */
+        void CollidePair(const CollisionPrimitive& one, const CollisionPrimitive& two, ContactManifold* manifold,
+                         CollisionData* data) const;
+
+        /**
+        * Runs the fine collision test matching the two primitives.
+        * Returns the number of contacts written. The feature of a contact
+        * with a plane has the plane's index, plus one, added from bit 16
+        * up, as the plane has no body to tell it apart from the others.
+        */
+        unsigned CollidePrimitives(const CollisionPrimitive& one, const CollisionPrimitive& two,
+                                   CollisionData* data) const;
+
+    protected:
+        /**
+        * Holds the rigid bodies.
+        */
+        Bodies bodies;
+
+        /**
+        * Holds the primitive representing each body, in body order, or
+        * NULL for bodies without one.
+        */
+        std::vector<CollisionPrimitive*> primitives;
+
+        /**
+        * Holds the broadphase proxy of each primitive, in body order.
+        */
+        std::vector<unsigned> proxies;
+
+        /**
+        * Holds the indices of the bodies that were awake when the last
+        * integration began, in body order.
+        */
+        std::vector<unsigned> awakeBodies;
+
+        /**
+        * Holds a flag for each body, set if it is in the awake list.
+        */
+        std::vector<unsigned char> awakeFlags;
+
+        /**
+        * Holds, for each body, the next body of its sleeping island. The
+        * bodies of an island are linked in a ring, so it can be woken
+        * from any of them, and a body on its own links to itself.
+        */
+        std::vector<unsigned> sleepingNext;
+
+        /**
+        * Holds, for each body, the body it was joined to when its
+        * sleeping island formed, leading to the head of the island.
+        */
+        std::vector<unsigned> sleepingParents;
+
+        /**
+        * Holds, for each body, the body it was joined to through this
+        * frame's contacts, leading to the head of its island.
+        */
+        std::vector<unsigned> islandParents;
+
+        /**
+        * Holds what is known about the island headed by each body while
+        * the islands are sorted out, and zero for the rest.
+        */
+        std::vector<unsigned char> islandStates;
+
+        /**
+        * Holds the bodies touched by this frame's contacts.
+        */
+        std::vector<unsigned> islandBodies;
+
+        /**
+        * Holds a flag for each body, set if it is a bullet.
+        */
+        std::vector<unsigned char> bulletFlags;
+
+        /**
+        * Holds the awake bullets of the current step.
+        */
+        std::vector<unsigned> bulletBodies;
+
+        /**
+        * Holds the sweep of each awake bullet over the current step.
+        */
+        std::vector<BodySweep> bulletSweeps;
+
+        /**
+        * Holds the proxies found by broadphase queries.
+        */
+        std::vector<unsigned> queryProxies;
+
+        /**
+        * Holds the box primitives.
+        */
+        Boxes boxes;
+
+        /**
+        * Holds the sphere primitives.
+        */
+        Spheres spheres;
+
+        /**
+        * Holds the planes.
+        */
+        Planes planes;
+
+        /**
+        * Holds the tree used for the coarse collision detection.
+        */
+        DynamicAABBTree broadphase;
+
+        /**
+        * Holds the pairs found by the coarse collision detection.
+        */
+        PotentialContacts potentialContacts;
+
+        /**
+        * Holds the pairs to run the fine collision tests on this frame.
+        */
+        PotentialContacts collisionPairs;
+
+        /**
+        * Holds the manifold of each pair to test, or NULL for each pair
+        * if contacts are not kept between frames.
+        */
+        std::vector<ContactManifold*> pairManifolds;
+
+        /**
+        * Holds the collision data each slab of pairs writes into.
+        */
+        std::vector<CollisionData> slabs;
+
+        /**
+        * Holds the contacts found by the slabs, MaxContactsPerPair for
+        * each pair, before they are copied into the contact array.
+        */
+        std::vector<Contact> slabContacts;
+
+        /**
+        * Holds the thread pool the world's work is spread over, or NULL
+        * to run it on the calling thread.
+        */
+        ThreadPool* threadPool;
+
+        /**
+        * Holds the stages of a step, built again for each step.
+        */
+        TaskGraph stepGraph;
+
+        /**
+        * True if the world should calculate the number of iterations
+        * to give the contact resolver at each frame.
+        */
+        bool bCalculateIterations;
+
+        /**
+        * Holds the force generators for the bodies in this world.
+        */
+        ForceRegistry registry;
+
+        /**
+        * Holds the resolver for contacts.
+        */
+        ContactResolver resolver;
+
+        /**
+        * Contact generators.
+        */
+        ContactGenerators contactGenerators;
+
+        /**
+        * Holds the list of contacts.
+        */
+        Contact* contacts;
+
+        /**
+        * Holds the maximum number of contacts allowed (i.e. the
+        * size of the contacts array).
+        */
+        unsigned maxContacts;
+
+        /**
+        * Holds the collision data structure for collision detection.
+        */
+        CollisionData collisionData;
+
+        /**
+        * True if contacts are kept in manifolds between frames.
+        */
+        bool bPersistentContacts;
+
+        /**
+        * Holds the manifold of each pair of primitives in contact.
+        */
+        ContactManifoldCache manifolds;
+    };
+}
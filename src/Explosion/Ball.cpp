@@ -71,7 +71,7 @@ void Ball::SetState(const cyclone::Vector3& position, const cyclone::Quaternion&
 
     body->SetMass(mass);
 
-    cyclone::Matrix tensor;
+    cyclone::Matrix3 tensor;
 
     const auto coefficient = 0.4f * mass * radius * radius;
 
@@ -87,8 +87,6 @@ void Ball::SetState(const cyclone::Vector3& position, const cyclone::Quaternion&
 
     tensor.M[2][2] = coefficient;
 
-    tensor.M[3][3] = 1.f;
-
     body->SetInertiaTensor(tensor);
 
     body->SetLinearDamping(0.95f);
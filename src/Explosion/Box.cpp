@@ -79,7 +79,7 @@ void Box::SetState(const cyclone::Vector3& position, const cyclone::Quaternion&
 
     body->SetMass(mass);
 
-    cyclone::Matrix tensor;
+    cyclone::Matrix3 tensor;
 
     const auto squares = halfSize * halfSize;
 
@@ -95,8 +95,6 @@ void Box::SetState(const cyclone::Vector3& position, const cyclone::Quaternion&
 
     tensor.M[2][2] = 0.3f * mass * (squares.x + squares.y);
 
-    tensor.M[3][3] = 1.f;
-
     body->SetInertiaTensor(tensor);
 
     body->SetLinearDamping(0.95f);
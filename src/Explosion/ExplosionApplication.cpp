@@ -1,6 +1,8 @@
 #include "ExplosionApplication.h"
 #include "gl/glut.h"
+#include <algorithm>
 #include <cmath>
+#include <utility>
 #include "cyclone/RigidBody/FineCollision/IntersectionTests.h"
 
 
@@ -58,6 +60,13 @@ void ExplosionApplication::Key(const unsigned char key)
 
             editMode = false;
 
+            return;
+        }
+    case 'f':
+    case 'F':
+        {
+            Fire();
+
             return;
         }
     case 'w':
@@ -256,11 +265,40 @@ void ExplosionApplication::MouseDrag(const int x, const int y)
 
 void ExplosionApplication::Fire() const
 {
-    auto position = ballData[0].body->GetPosition();
+    // The blast is centred on the ground below the first ball.
+    auto centre = ballData[0].body->GetPosition();
+
+    centre.y = 0.f;
+
+    cyclone::CollisionSphere blast;
+
+    blast.offset = cyclone::Matrix3x4(cyclone::Matrix3(1.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 1.f), centre);
+
+    blast.radius = blastRadius;
+
+    blast.CalculateInternals();
 
-    position.Normalize();
+    // Only the bodies the blast reaches are pushed.
+    cyclone::RigidBody* bodies[boxes + balls];
 
-    ballData[0].body->AddForce(position * -1000.f);
+    const auto found = broadphase.Overlap(blast, bodies, boxes + balls);
+
+    for (auto body = bodies; body < bodies + found; ++body)
+    {
+        auto direction = (*body)->GetPosition() - centre;
+
+        const auto distance = direction.Size();
+
+        direction.Normalize();
+
+        // Bodies reaching into the blast from beyond its radius aren't
+        // pulled towards it.
+        const auto falloff = std::max<cyclone::real>(0.f, 1.f - distance / blastRadius);
+
+        (*body)->AddVelocity(direction * (blastSpeed * falloff));
+
+        (*body)->SetAwake();
+    }
 }
 
 void ExplosionApplication::GenerateContacts()
@@ -294,54 +332,61 @@ void ExplosionApplication::GenerateContacts()
         }
 
         cyclone::CollisionDetector::BoxAndHalfSpace(*box, plane, &collisionData);
+    }
 
-        // Check for collisions with each other box
-        for (auto other = box + 1; other < boxData + boxes; ++other)
+    for (auto ball = ballData; ball < ballData + balls; ++ball)
+    {
+        // Check for collisions with the ground plane
+        if (!collisionData.HasMoreContacts())
         {
-            if (!collisionData.HasMoreContacts())
-            {
-                return;
-            }
-
-            cyclone::CollisionDetector::BoxAndBox(*box, *other, &collisionData);
-
-            if (cyclone::IntersectionTests::BoxAndBox(*box, *other))
-            {
-                box->bIsOverlapping = other->bIsOverlapping = true;
-            }
+            return;
         }
 
-        // Check for collisions with each ball
-        for (auto other = ballData; other < ballData + balls; ++other)
-        {
-            if (!collisionData.HasMoreContacts())
-            {
-                return;
-            }
-
-            cyclone::CollisionDetector::BoxAndSphere(*box, *other, &collisionData);
-        }
+        cyclone::CollisionDetector::SphereAndHalfSpace(*ball, plane, &collisionData);
     }
 
-    for (auto ball = ballData; ball < ballData + balls; ++ball)
+    // Only check the objects whose bounding boxes overlap
+    const auto found = broadphase.GetPotentialContacts(potentialContacts, maxContacts);
+
+    for (auto potentialContact = potentialContacts; potentialContact < potentialContacts + found; ++potentialContact)
     {
-        // Check for collisions with the ground plane
         if (!collisionData.HasMoreContacts())
         {
             return;
         }
 
-        cyclone::CollisionDetector::SphereAndHalfSpace(*ball, plane, &collisionData);
+        auto one = potentialContact->primitive[0];
+
+        auto other = potentialContact->primitive[1];
+
+        // Boxes always go first
+        if (one->GetType() == cyclone::PrimitiveType::Sphere)
+        {
+            std::swap(one, other);
+        }
 
-        for (auto other = ball + 1; other < ballData + balls; ++other)
+        if (one->GetType() == cyclone::PrimitiveType::Sphere)
+        {
+            cyclone::CollisionDetector::SphereAndSphere(*static_cast<Ball*>(one), *static_cast<Ball*>(other),
+                                                        &collisionData);
+        }
+        else if (other->GetType() == cyclone::PrimitiveType::Sphere)
         {
-            // Check for collisions with the ground plane
-            if (!collisionData.HasMoreContacts())
+            cyclone::CollisionDetector::BoxAndSphere(*static_cast<Box*>(one), *static_cast<Ball*>(other),
+                                                     &collisionData);
+        }
+        else
+        {
+            const auto box = static_cast<Box*>(one);
+
+            const auto otherBox = static_cast<Box*>(other);
+
+            cyclone::CollisionDetector::BoxAndBox(*box, *otherBox, &collisionData);
+
+            if (cyclone::IntersectionTests::BoxAndBox(*box, *otherBox))
             {
-                return;
+                box->bIsOverlapping = otherBox->bIsOverlapping = true;
             }
-
-            cyclone::CollisionDetector::SphereAndSphere(*ball, *other, &collisionData);
         }
     }
 }
@@ -357,6 +402,10 @@ void ExplosionApplication::UpdateObjects(const cyclone::real deltaTime)
         box->CalculateInternals();
 
         box->bIsOverlapping = false;
+
+        // Keep the broadphase up to date
+        broadphase.Move(boxProxies[box - boxData], cyclone::BoundingBox::Enclosing(*box),
+                        box->body->GetVelocity() * deltaTime);
     }
 
     // Update the physics of each ball in turn
@@ -366,6 +415,9 @@ void ExplosionApplication::UpdateObjects(const cyclone::real deltaTime)
         ball->body->Integrate(deltaTime);
 
         ball->CalculateInternals();
+
+        broadphase.Move(ballProxies[ball - ballData], cyclone::BoundingBox::Enclosing(*ball),
+                        ball->body->GetVelocity() * deltaTime);
     }
 }
 
@@ -395,6 +447,23 @@ void ExplosionApplication::Reset()
         ball->Random(&random);
     }
 
+    // Rebuild the broadphase around the new positions
+    broadphase.Clear();
+
+    for (box = boxData; box < boxData + boxes; ++box)
+    {
+        box->CalculateInternals();
+
+        boxProxies[box - boxData] = broadphase.Insert(box->body, cyclone::BoundingBox::Enclosing(*box), box);
+    }
+
+    for (auto ball = ballData; ball < ballData + balls; ++ball)
+    {
+        ball->CalculateInternals();
+
+        ballProxies[ball - ballData] = broadphase.Insert(ball->body, cyclone::BoundingBox::Enclosing(*ball), ball);
+    }
+
     // Reset the contacts
     collisionData.contactCount = 0;
 }
@@ -5,6 +5,7 @@
 #include "Ball.h"
 #include "Box.h"
 #include "RigidBodyApplication.h"
+#include "cyclone/RigidBody/CoarseCollision/DynamicAABBTree.h"
 
 class ExplosionApplication : public RigidBodyApplication
 {
@@ -28,7 +29,7 @@ public:
     void MouseDrag(int x, int y) override;
 
 private:
-    /** Detonates the explosion. */
+    /** Detonates the explosion, pushing the objects it reaches. */
     void Fire() const;
 
     /** Processes the contact generation code. */
@@ -45,6 +46,12 @@ private:
 
     bool upMode;
 
+    /** Holds how far the explosion reaches. */
+    constexpr static cyclone::real blastRadius = 10.f;
+
+    /** Holds how fast the explosion pushes an object at its centre. */
+    constexpr static cyclone::real blastSpeed = 20.f;
+
     /**
     * Holds the number of boxes in the simulation.
     */
@@ -60,4 +67,16 @@ private:
 
     /** Holds the ball data. */
     Ball ballData[balls];
+
+    /** Holds the broadphase proxy of each box. */
+    unsigned boxProxies[boxes];
+
+    /** Holds the broadphase proxy of each ball. */
+    unsigned ballProxies[balls];
+
+    /** Holds the tree used to find the objects that may be touching. */
+    cyclone::DynamicAABBTree broadphase;
+
+    /** Holds the pairs found by the broadphase. */
+    cyclone::PotentialContact potentialContacts[maxContacts];
 };
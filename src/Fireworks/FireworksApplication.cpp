@@ -204,7 +204,7 @@ void FireworksApplication::InitFireworkRules()
         0.5f, 1.4f, // age range
         cyclone::Vector3(-5, 25, -5), // min velocity
         cyclone::Vector3(5, 28, 5), // max velocity
-        0.1 // damping
+        0.1f // damping
     );
     rules[0].payloads[0].Set(3, 5);
     rules[0].payloads[1].Set(5, 5);
@@ -215,7 +215,7 @@ void FireworksApplication::InitFireworkRules()
         0.5f, 1.0f, // age range
         cyclone::Vector3(-5, 10, -5), // min velocity
         cyclone::Vector3(5, 20, 5), // max velocity
-        0.8 // damping
+        0.8f // damping
     );
     rules[1].payloads[0].Set(4, 2);
 
@@ -225,7 +225,7 @@ void FireworksApplication::InitFireworkRules()
         0.5f, 1.5f, // age range
         cyclone::Vector3(-5, -5, -5), // min velocity
         cyclone::Vector3(5, 5, 5), // max velocity
-        0.1 // damping
+        0.1f // damping
     );
 
     rules[3].Init(0);
@@ -234,7 +234,7 @@ void FireworksApplication::InitFireworkRules()
         0.25f, 0.5f, // age range
         cyclone::Vector3(-20, 5, -5), // min velocity
         cyclone::Vector3(20, 5, 5), // max velocity
-        0.2 // damping
+        0.2f // damping
     );
 
     rules[4].Init(1);
@@ -243,7 +243,7 @@ void FireworksApplication::InitFireworkRules()
         0.5f, 1.0f, // age range
         cyclone::Vector3(-20, 2, -5), // min velocity
         cyclone::Vector3(20, 18, 5), // max velocity
-        0.01 // damping
+        0.01f // damping
     );
     rules[4].payloads[0].Set(3, 5);
 
@@ -253,7 +253,7 @@ void FireworksApplication::InitFireworkRules()
         3, 5, // age range
         cyclone::Vector3(-5, 5, -5), // min velocity
         cyclone::Vector3(5, 10, 5), // max velocity
-        0.95 // damping
+        0.95f // damping
     );
 
     rules[6].Init(1);
@@ -262,7 +262,7 @@ void FireworksApplication::InitFireworkRules()
         4, 5, // age range
         cyclone::Vector3(-5, 50, -5), // min velocity
         cyclone::Vector3(5, 60, 5), // max velocity
-        0.01 // damping
+        0.01f // damping
     );
     rules[6].payloads[0].Set(8, 10);
 
@@ -272,7 +272,7 @@ void FireworksApplication::InitFireworkRules()
         0.25f, 0.5f, // age range
         cyclone::Vector3(-1, -1, -1), // min velocity
         cyclone::Vector3(1, 1, 1), // max velocity
-        0.01 // damping
+        0.01f // damping
     );
 
     rules[8].Init(0);
@@ -281,7 +281,7 @@ void FireworksApplication::InitFireworkRules()
         3, 5, // age range
         cyclone::Vector3(-15, 10, -5), // min velocity
         cyclone::Vector3(15, 15, 5), // max velocity
-        0.95 // damping
+        0.95f // damping
     );
     // ... and so on for other firework types ...
 }
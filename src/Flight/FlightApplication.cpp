@@ -129,7 +129,7 @@ FlightApplication::FlightApplication(): Application(),
 
     aircraft.SetMass(2.5f);
 
-    cyclone::Matrix inertiaTensor;
+    cyclone::Matrix3 inertiaTensor;
 
     const auto halfSizes = cyclone::Vector3(2.f, 1.f, 1.f);
 
@@ -149,8 +149,6 @@ FlightApplication::FlightApplication(): Application(),
 
     inertiaTensor.M[2][2] = 0.3f * mass * (squares.x + squares.y);
 
-    inertiaTensor.M[3][3] = 1.f;
-
     aircraft.SetInertiaTensor(inertiaTensor);
     
     aircraft.SetDamping(0.8f, 0.8f);
@@ -55,7 +55,7 @@ void Block::SetState(const cyclone::Vector3& position, const cyclone::Quaternion
 
     body->SetMass(mass);
 
-    cyclone::Matrix tensor;
+    cyclone::Matrix3 tensor;
 
     const auto squares = halfSize * halfSize;
 
@@ -71,8 +71,6 @@ void Block::SetState(const cyclone::Vector3& position, const cyclone::Quaternion
 
     tensor.M[2][2] = 0.3f * mass * (squares.x + squares.y);
 
-    tensor.M[3][3] = 1.f;
-
     body->SetInertiaTensor(tensor);
 
     body->SetLinearDamping(0.95f);
@@ -96,7 +94,7 @@ void Block::CalculateMassProperties(const cyclone::real inverseDensity) const
         // Just set zeros for both mass and inertia tensor
         body->SetInverseMass(0.f);
 
-        body->SetInverseInertiaTensor(cyclone::Matrix());
+        body->SetInverseInertiaTensor(cyclone::Matrix3());
     }
     else
     {
@@ -108,7 +106,7 @@ void Block::CalculateMassProperties(const cyclone::real inverseDensity) const
         body->SetMass(mass);
 
         // And calculate the inertia tensor from the mass and size
-        cyclone::Matrix tensor;
+        cyclone::Matrix3 tensor;
 
         tensor.M[0][0] = 0.333f * mass * halfSize.y * halfSize.y + halfSize.z * halfSize.z;
 
@@ -122,8 +120,6 @@ void Block::CalculateMassProperties(const cyclone::real inverseDensity) const
 
         tensor.M[2][2] = 0.333f * mass * halfSize.y * halfSize.x + halfSize.z * halfSize.y;
 
-        tensor.M[3][3] = 1.f;
-
         body->SetInertiaTensor(tensor);
     }
 }
@@ -266,7 +262,7 @@ void Block::DivideBlock(const cyclone::Contact& contact, Block* target, Block* b
 
         blocks[i].body->CalculateDerivedData();
 
-        blocks[i].offset = cyclone::Matrix();
+        blocks[i].offset = cyclone::Matrix3x4();
 
         blocks[i].exists = true;
 
@@ -2,6 +2,7 @@
 #include "Ragdoll/Bone.h"
 #include "gl/glut.h"
 #include <cmath>
+#include <utility>
 
 /**
 * Called by the common demo framework to create an application
@@ -12,7 +13,8 @@ Application* GetApplication()
     return new FractureApplication();
 }
 
-FractureApplication::FractureApplication(): RigidBodyApplication(), hit(false), ball_active(false), fracture_contact(0)
+FractureApplication::FractureApplication(): RigidBodyApplication(), hit(false), ball_active(false), fracture_contact(0),
+    ballProxy(cyclone::DynamicAABBTree::NullNode)
 {
     // Create the ball.
     ball.body = new cyclone::RigidBody();
@@ -23,7 +25,7 @@ FractureApplication::FractureApplication(): RigidBodyApplication(), hit(false),
 
     ball.body->SetDamping(0.9f, 0.9f);
 
-    cyclone::Matrix inertiaTensor;
+    cyclone::Matrix3 inertiaTensor;
 
     inertiaTensor.M[0][0] = 5.f;
 
@@ -37,8 +39,6 @@ FractureApplication::FractureApplication(): RigidBodyApplication(), hit(false),
 
     inertiaTensor.M[2][2] = 5.f;
 
-    inertiaTensor.M[3][3] = 1.f;
-
     ball.body->SetInertiaTensor(inertiaTensor);
 
     ball.body->SetAcceleration(cyclone::Vector3::Gravity);
@@ -171,37 +171,42 @@ void FractureApplication::GenerateContacts()
         }
 
         cyclone::CollisionDetector::BoxAndHalfSpace(*block, plane, &collisionData);
+    }
+
+    // Only check the objects whose bounding boxes overlap
+    const auto found = broadphase.GetPotentialContacts(potentialContacts, maxContacts);
 
-        if (ball_active)
+    for (auto potentialContact = potentialContacts; potentialContact < potentialContacts + found; ++potentialContact)
+    {
+        if (!collisionData.HasMoreContacts())
         {
-            // And with the sphere
-            if (!collisionData.HasMoreContacts())
-            {
-                return;
-            }
+            return;
+        }
 
-            if (cyclone::CollisionDetector::BoxAndSphere(*block, ball, &collisionData))
-            {
-                hit = true;
+        auto one = potentialContact->primitive[0];
 
-                fracture_contact = collisionData.contactCount - 1;
-            }
+        auto other = potentialContact->primitive[1];
+
+        // The block always goes first
+        if (one->GetType() == cyclone::PrimitiveType::Sphere)
+        {
+            std::swap(one, other);
         }
 
-        // Check for collisions with each other box
-        for (auto other = block + 1; other < blocks + MAX_BLOCKS; ++other)
+        if (other->GetType() == cyclone::PrimitiveType::Sphere)
         {
-            if (!other->exists)
+            // Hitting a block with the ball breaks it
+            if (cyclone::CollisionDetector::BoxAndSphere(*static_cast<Block*>(one), ball, &collisionData))
             {
-                continue;
-            }
+                hit = true;
 
-            if (!collisionData.HasMoreContacts())
-            {
-                return;
+                fracture_contact = collisionData.contactCount - 1;
             }
-
-            cyclone::CollisionDetector::BoxAndBox(*block, *other, &collisionData);
+        }
+        else
+        {
+            cyclone::CollisionDetector::BoxAndBox(*static_cast<Block*>(one), *static_cast<Block*>(other),
+                                                  &collisionData);
         }
     }
 
@@ -226,6 +231,10 @@ void FractureApplication::UpdateObjects(const cyclone::real deltaTime)
             block->body->Integrate(deltaTime);
 
             block->CalculateInternals();
+
+            // Keep the broadphase up to date
+            broadphase.Move(blockProxies[block - blocks], cyclone::BoundingBox::Enclosing(*block),
+                            block->body->GetVelocity() * deltaTime);
         }
     }
 
@@ -234,6 +243,8 @@ void FractureApplication::UpdateObjects(const cyclone::real deltaTime)
         ball.body->Integrate(deltaTime);
 
         ball.CalculateInternals();
+
+        broadphase.Move(ballProxy, cyclone::BoundingBox::Enclosing(ball), ball.body->GetVelocity() * deltaTime);
     }
 }
 
@@ -264,7 +275,7 @@ void FractureApplication::Reset()
 
     const auto squares = blocks[0].halfSize * blocks[0].halfSize;
 
-    cyclone::Matrix inertiaTensor;
+    cyclone::Matrix3 inertiaTensor;
 
     inertiaTensor.M[0][0] = 0.3f * mass * (squares.y + squares.z);
 
@@ -278,8 +289,6 @@ void FractureApplication::Reset()
 
     inertiaTensor.M[2][2] = 0.3f * mass * (squares.x + squares.y);
 
-    inertiaTensor.M[3][3] = 1.f;
-
     blocks[0].body->SetInertiaTensor(inertiaTensor);
 
     blocks[0].body->SetDamping(0.9f, 0.9f);
@@ -313,6 +322,8 @@ void FractureApplication::Reset()
 
     hit = false;
 
+    RebuildBroadphase();
+
     // Reset the contacts
     collisionData.contactCount = 0;
 }
@@ -327,5 +338,36 @@ void FractureApplication::Update()
         blocks[0].DivideBlock(collisionData.contactHead[fracture_contact], blocks, blocks + 1);
 
         ball_active = false;
+
+        RebuildBroadphase();
+    }
+}
+
+void FractureApplication::RebuildBroadphase()
+{
+    broadphase.Clear();
+
+    for (auto block = blocks; block < blocks + MAX_BLOCKS; ++block)
+    {
+        if (block->exists)
+        {
+            block->CalculateInternals();
+
+            blockProxies[block - blocks] = broadphase.Insert(block->body, cyclone::BoundingBox::Enclosing(*block),
+                                                             block);
+        }
+        else
+        {
+            blockProxies[block - blocks] = cyclone::DynamicAABBTree::NullNode;
+        }
+    }
+
+    ballProxy = cyclone::DynamicAABBTree::NullNode;
+
+    if (ball_active)
+    {
+        ball.CalculateInternals();
+
+        ballProxy = broadphase.Insert(ball.body, cyclone::BoundingBox::Enclosing(ball), &ball);
     }
 }
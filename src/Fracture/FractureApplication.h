@@ -4,6 +4,7 @@
 
 #include "Block.h"
 #include "RigidBodyApplication.h"
+#include "cyclone/RigidBody/CoarseCollision/DynamicAABBTree.h"
 
 class FractureApplication : public RigidBodyApplication
 {
@@ -30,6 +31,9 @@ private:
     /** Processes the physics. */
     void Update() override;
 
+    /** Inserts the block and ball that exist into an empty broadphase. */
+    void RebuildBroadphase();
+
 private:
     /** Tracks if a block has been hit. */
     bool hit;
@@ -46,4 +50,16 @@ private:
 
     /** Holds the projectile. */
     cyclone::CollisionSphere ball;
+
+    /** Holds the broadphase proxy of each block. */
+    unsigned blockProxies[MAX_BLOCKS];
+
+    /** Holds the broadphase proxy of the ball. */
+    unsigned ballProxy;
+
+    /** Holds the tree used to find the objects that may be touching. */
+    cyclone::DynamicAABBTree broadphase;
+
+    /** Holds the pairs found by the broadphase. */
+    cyclone::PotentialContact potentialContacts[maxContacts];
 };
@@ -19,7 +19,7 @@ cyclone::CollisionSphere Bone::GetCollisionSphere() const
 
     sphere.radius = halfSize.x;
 
-    sphere.offset = cyclone::Matrix();
+    sphere.offset = cyclone::Matrix3x4();
 
     if (halfSize.y < sphere.radius)
     {
@@ -79,7 +79,7 @@ void Bone::SetState(const cyclone::Vector3& position, const cyclone::Vector3& ex
 
     body->SetMass(mass);
 
-    cyclone::Matrix tensor;
+    cyclone::Matrix3 tensor;
 
     const auto squares = halfSize * halfSize;
 
@@ -95,8 +95,6 @@ void Bone::SetState(const cyclone::Vector3& position, const cyclone::Vector3& ex
 
     tensor.M[2][2] = 0.3f * mass * (squares.x + squares.y);
 
-    tensor.M[3][3] = 1.f;
-
     body->SetInertiaTensor(tensor);
 
     body->SetLinearDamping(0.95f);
@@ -79,7 +79,7 @@ SailboatApplication::SailboatApplication(): Application(), buoyancy(cyclone::Vec
 
     sailboat.SetMass(200.f);
 
-    cyclone::Matrix inertiaTensor;
+    cyclone::Matrix3 inertiaTensor;
 
     const auto halfSizes = cyclone::Vector3(2.f, 1.f, 1.f);
 
@@ -99,8 +99,6 @@ SailboatApplication::SailboatApplication(): Application(), buoyancy(cyclone::Vec
 
     inertiaTensor.M[2][2] = 0.3f * mass * (squares.x + squares.y);
 
-    inertiaTensor.M[3][3] = 1.f;
-
     sailboat.SetInertiaTensor(inertiaTensor);
 
     sailboat.SetDamping(0.8f, 0.8f);
@@ -0,0 +1,98 @@
+#include "Tests.h"
+#include "ReferenceBoxAndBox.h"
+#include "cyclone/RigidBody/FineCollision/CollisionDetector.h"
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+    /**
+    * How far the normals and depths may differ, for the two tests
+    * rounding differently.
+    */
+    constexpr cyclone::real Tolerance = 0.0001f;
+
+    /**
+    * Checks the contacts BoxAndBox wrote for the pair against the
+    * reference test. Every contact must be along the reference normal,
+    * none deeper than the reference overlap, and an edge-edge contact
+    * exactly as deep.
+    */
+    bool CheckContacts(const cyclone::CollisionBox& one, const cyclone::Contact* contacts, const unsigned count,
+                       const unsigned best, const cyclone::Vector3& normal, const cyclone::real penetration)
+    {
+        for (auto contact = contacts; contact < contacts + count; ++contact)
+        {
+            // The contact normal faces the first of its bodies.
+            const auto expected = contact->body[0] == one.body ? normal : normal * -1.f;
+
+            if ((contact->contactNormal - expected).Size() > Tolerance)
+            {
+                return false;
+            }
+
+            if (contact->penetration > penetration + Tolerance || contact->penetration < -Tolerance)
+            {
+                return false;
+            }
+
+            if (best >= 6 && real_abs(contact->penetration - penetration) > Tolerance)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+}
+
+bool RunBoxAndBoxFuzz()
+{
+    std::vector<cyclone::RigidBody> bodies;
+
+    std::vector<cyclone::CollisionBox> boxes;
+
+    MakeBoxPairs(BoxPairs, &bodies, &boxes);
+
+    cyclone::Contact contacts[4];
+
+    cyclone::CollisionData data;
+
+    data.contactHead = contacts;
+
+    auto touching = 0u;
+
+    auto mismatches = 0u;
+
+    for (auto i = 0u; i < BoxPairs; ++i)
+    {
+        const auto& one = boxes[i * 2];
+
+        const auto& two = boxes[i * 2 + 1];
+
+        data.Reset(4);
+
+        const auto count = cyclone::CollisionDetector::BoxAndBox(one, two, &data);
+
+        unsigned best;
+
+        cyclone::Vector3 normal;
+
+        cyclone::real penetration;
+
+        const auto bTouching = ReferenceBoxAndBox(one, two, &best, &normal, &penetration);
+
+        if (bTouching != (count > 0) ||
+            (bTouching && !CheckContacts(one, contacts, count, best, normal, penetration)))
+        {
+            ++mismatches;
+        }
+
+        touching += bTouching ? 1 : 0;
+    }
+
+    printf("BoxAndBox fuzz: %u pairs, %u touching, %u mismatches %s\n", BoxPairs, touching, mismatches,
+           mismatches == 0 ? "ok" : "FAILED");
+
+    return mismatches == 0;
+}
@@ -0,0 +1,313 @@
+#include "Tests.h"
+#include "cyclone/Core/Random.h"
+#include "cyclone/Core/ThreadPool.h"
+#include "cyclone/RigidBody/World.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+
+namespace
+{
+    /**
+    * The number of boxes, and of balls, thrown into the Explosion scene.
+    * The demo has five of each, far too few to be split over threads.
+    */
+    constexpr unsigned ExplosionObjects = 256;
+
+    /**
+    * The number of fractured blocks along each side of the Fracture scene.
+    */
+    constexpr unsigned FractureBlocks = 8;
+
+    /**
+    * The number of steps each scene is run for, and the step at which
+    * the Explosion scene's blast goes off.
+    */
+    constexpr unsigned Steps = 240;
+
+    constexpr unsigned BlastStep = 60;
+
+    constexpr cyclone::real StepTime = 1.f / 60.f;
+
+    /**
+    * The thread counts each scene is run with. The first run is the one
+    * the others are checked against.
+    */
+    const unsigned ThreadCounts[] = {1, 2, 4, 8};
+
+    /**
+    * Holds a scene to run: how to build it in a fresh world, and what to
+    * do to it before each step.
+    */
+    struct Scene
+    {
+        const char* name;
+
+        unsigned maxBodies;
+
+        void (*build)(cyclone::World& world);
+
+        void (*update)(cyclone::World& world, unsigned step);
+    };
+
+    /**
+    * Sets the given body up as a solid box, the way the demos do.
+    */
+    void SetBox(cyclone::World& world, cyclone::RigidBody* body, const cyclone::Vector3& position,
+                const cyclone::Quaternion& orientation, const cyclone::Vector3& halfSize, const cyclone::real mass)
+    {
+        body->SetPosition(position);
+
+        body->SetOrientation(orientation);
+
+        body->SetMass(mass);
+
+        cyclone::Matrix3 tensor;
+
+        const auto squares = halfSize * halfSize;
+
+        tensor.M[0][0] = 0.3f * mass * (squares.y + squares.z);
+
+        tensor.M[0][1] = tensor.M[1][0] = 0.f;
+
+        tensor.M[0][2] = tensor.M[2][0] = 0.f;
+
+        tensor.M[1][1] = 0.3f * mass * (squares.x + squares.z);
+
+        tensor.M[1][2] = tensor.M[2][1] = 0.f;
+
+        tensor.M[2][2] = 0.3f * mass * (squares.x + squares.y);
+
+        body->SetInertiaTensor(tensor);
+
+        body->SetAcceleration(cyclone::Vector3::Gravity);
+
+        body->SetAwake();
+
+        body->CalculateDerivedData();
+
+        world.AddBox(body, halfSize);
+    }
+
+    /**
+    * Sets the given body up as a solid ball, the way the demos do.
+    */
+    void SetBall(cyclone::World& world, cyclone::RigidBody* body, const cyclone::Vector3& position,
+                 const cyclone::real radius, const cyclone::real mass)
+    {
+        body->SetPosition(position);
+
+        body->SetOrientation(cyclone::Quaternion());
+
+        body->SetMass(mass);
+
+        const auto coefficient = 0.4f * mass * radius * radius;
+
+        body->SetInertiaTensor(cyclone::Matrix3(coefficient, 0.f, 0.f, 0.f, coefficient, 0.f, 0.f, 0.f,
+                                                coefficient));
+
+        body->SetAcceleration(cyclone::Vector3::Gravity);
+
+        body->SetAwake();
+
+        body->CalculateDerivedData();
+
+        world.AddSphere(body, radius);
+    }
+
+    /**
+    * Builds the Explosion demo's pile of random boxes and balls, spread
+    * over a wider area to hold more of them.
+    */
+    void BuildExplosion(cyclone::World& world)
+    {
+        world.AddPlane(cyclone::Vector3(0.f, 1.f, 0.f), 0.f);
+
+        world.SetContactProperties(0.9f, 0.6f);
+
+        cyclone::Random random(1);
+
+        const cyclone::Vector3 minPosition(-20.f, 5.f, -20.f);
+
+        const cyclone::Vector3 maxPosition(20.f, 40.f, 20.f);
+
+        for (auto i = 0u; i < ExplosionObjects; ++i)
+        {
+            const auto halfSize = random.RandomVector(cyclone::Vector3(0.5f, 0.5f, 0.5f),
+                                                      cyclone::Vector3(4.5f, 1.5f, 1.5f));
+
+            const auto body = world.AddBody();
+
+            SetBox(world, body, random.RandomVector(minPosition, maxPosition), random.RandomQuaternion(), halfSize,
+                   halfSize.x * halfSize.y * halfSize.z * 8.f);
+
+            body->SetDamping(0.95f, 0.8f);
+        }
+
+        for (auto i = 0u; i < ExplosionObjects; ++i)
+        {
+            const auto radius = random.RandomReal(0.5f, 1.5f);
+
+            const auto body = world.AddBody();
+
+            SetBall(world, body, random.RandomVector(minPosition, maxPosition), radius,
+                    4.f * 0.3333f * R_PI * radius * radius * radius);
+
+            body->SetDamping(0.95f, 0.8f);
+        }
+    }
+
+    /**
+    * Sets off the Explosion demo's blast under the first ball, pushing
+    * the bodies it reaches away from it.
+    */
+    void UpdateExplosion(cyclone::World& world, const unsigned step)
+    {
+        if (step != BlastStep)
+        {
+            return;
+        }
+
+        constexpr cyclone::real blastRadius = 10.f;
+
+        constexpr cyclone::real blastSpeed = 20.f;
+
+        auto centre = world.GetSpheres().front().body->GetPosition();
+
+        centre.y = 0.f;
+
+        cyclone::CollisionSphere blast;
+
+        blast.offset = cyclone::Matrix3x4(cyclone::Matrix3(1.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 1.f), centre);
+
+        blast.radius = blastRadius;
+
+        blast.CalculateInternals();
+
+        cyclone::RigidBody* bodies[ExplosionObjects * 2];
+
+        const auto found = world.Overlap(blast, bodies, ExplosionObjects * 2);
+
+        for (auto body = bodies; body < bodies + found; ++body)
+        {
+            auto direction = (*body)->GetPosition() - centre;
+
+            const auto distance = direction.Size();
+
+            direction.Normalize();
+
+            const auto falloff = std::max<cyclone::real>(0.f, 1.f - distance / blastRadius);
+
+            (*body)->AddVelocity(direction * (blastSpeed * falloff));
+
+            (*body)->SetAwake();
+        }
+    }
+
+    /**
+    * Builds a grid of the Fracture demo's block, each already split into
+    * its eight pieces, with a ball fired at each the way the demo fires
+    * its ball. The splitting itself is done by the demo, not the world.
+    */
+    void BuildFracture(cyclone::World& world)
+    {
+        world.AddPlane(cyclone::Vector3(0.f, 1.f, 0.f), 0.f);
+
+        world.SetContactProperties(0.9f, 0.2f);
+
+        cyclone::Random random(1);
+
+        const cyclone::Vector3 halfSize(2.f, 2.f, 2.f);
+
+        for (auto x = 0u; x < FractureBlocks; ++x)
+        {
+            for (auto z = 0u; z < FractureBlocks; ++z)
+            {
+                const cyclone::Vector3 centre(x * 30.f, 7.f, z * 30.f);
+
+                for (auto piece = 0u; piece < 8; ++piece)
+                {
+                    const cyclone::Vector3 offset(piece & 1 ? 2.f : -2.f, piece & 2 ? 2.f : -2.f,
+                                                  piece & 4 ? 2.f : -2.f);
+
+                    const auto body = world.AddBody();
+
+                    SetBox(world, body, centre + offset, cyclone::Quaternion(), halfSize, 100.f / 8.f);
+
+                    body->SetDamping(0.9f, 0.9f);
+                }
+
+                const auto ball = world.AddBody();
+
+                SetBall(world, ball, centre + cyclone::Vector3(0.f, -2.f, 20.f), 0.25f, 5.f);
+
+                ball->SetDamping(0.9f, 0.9f);
+
+                ball->SetVelocity(random.RandomBinomial(4.f), random.RandomReal(1.f, 6.f), -20.f);
+
+                ball->SetCanSleep(false);
+
+                world.SetBullet(ball);
+            }
+        }
+    }
+
+    void UpdateFracture(cyclone::World&, unsigned)
+    {
+    }
+
+    /**
+    * Runs the scene on a fresh world spread over the given number of
+    * threads, and returns the hash of the state it ends in.
+    */
+    std::uint64_t RunScene(const Scene& scene, const unsigned threadCount)
+    {
+        cyclone::ThreadPool threadPool(threadCount);
+
+        cyclone::World world(scene.maxBodies, scene.maxBodies * 16);
+
+        world.SetThreadPool(&threadPool);
+
+        scene.build(world);
+
+        for (auto step = 0u; step < Steps; ++step)
+        {
+            world.StartFrame();
+
+            scene.update(world, step);
+
+            world.Step(StepTime);
+        }
+
+        return world.GetStateHash();
+    }
+}
+
+bool RunDeterminismTest()
+{
+    const Scene scenes[] = {
+        {"Explosion", ExplosionObjects * 2, BuildExplosion, UpdateExplosion},
+        {"Fracture", FractureBlocks * FractureBlocks * 9, BuildFracture, UpdateFracture}
+    };
+
+    auto bPassed = true;
+
+    for (const auto& scene : scenes)
+    {
+        const auto reference = RunScene(scene, ThreadCounts[0]);
+
+        for (const auto threadCount : ThreadCounts)
+        {
+            const auto hash = threadCount == ThreadCounts[0] ? reference : RunScene(scene, threadCount);
+
+            const auto bMatches = hash == reference;
+
+            printf("Determinism: %s scene on %u threads: %016llx %s\n", scene.name, threadCount,
+                   static_cast<unsigned long long>(hash), bMatches ? "ok" : "MISMATCH");
+
+            bPassed &= bMatches;
+        }
+    }
+
+    return bPassed;
+}
@@ -0,0 +1,158 @@
+#include "ReferenceBoxAndBox.h"
+#include "cyclone/Core/Random.h"
+
+using namespace cyclone;
+
+namespace
+{
+    real TransformToAxis(const CollisionBox& box, const Vector3& axis)
+    {
+        return box.halfSize.x * real_abs(axis | box.GetAxis(0)) + box.halfSize.y * real_abs(axis | box.GetAxis(1)) +
+            box.halfSize.z * real_abs(axis | box.GetAxis(2));
+    }
+
+    /*
+    * This function checks if the two boxes overlap
+    * along the given axis, returning the amount of overlap.
+    * The final parameter toCentre
+    * is used to pass in the vector between the boxes centre
+    * points, to avoid having to recalculate it each time.
+    */
+    real PenetrationOnAxis(const CollisionBox& one, const CollisionBox& two, const Vector3& axis,
+                           const Vector3& toCentre)
+    {
+        // Project the half-size of one onto axis
+        const auto oneProject = TransformToAxis(one, axis);
+
+        const auto twoProject = TransformToAxis(two, axis);
+
+        // Project this onto the axis
+        const auto distance = real_abs(toCentre | axis);
+
+        // Return the overlap (i.e. positive indicates
+        // overlap, negative indicates separation).
+        return oneProject + twoProject - distance;
+    }
+
+    bool TryAxis(const CollisionBox& one, const CollisionBox& two, Vector3 axis, const Vector3& toCentre,
+                 const unsigned index, real& smallestPenetration, unsigned& smallestCase)
+    {
+        // Make sure we have a normalized axis, and don't check almost parallel axes
+        if (axis.SizeSquared() < 0.0001f)
+        {
+            return true;
+        }
+
+        axis.Normalize();
+
+        const auto penetration = PenetrationOnAxis(one, two, axis, toCentre);
+
+        if (penetration < 0.f)
+        {
+            return false;
+        }
+
+        if (penetration < smallestPenetration)
+        {
+            smallestPenetration = penetration;
+
+            smallestCase = index;
+        }
+
+        return true;
+    }
+}
+
+bool ReferenceBoxAndBox(const CollisionBox& one, const CollisionBox& two, unsigned* best, Vector3* normal,
+                        real* penetration)
+{
+    // Find the vector between the two centres
+    const auto toCentre = two.GetAxis(3) - one.GetAxis(3);
+
+    auto pen = REAL_MAX;
+
+    auto index = 0xffffffu;
+
+    Vector3 axes[15];
+
+    for (auto i = 0u; i < 3; ++i)
+    {
+        axes[i] = one.GetAxis(i);
+
+        axes[3 + i] = two.GetAxis(i);
+
+        for (auto j = 0u; j < 3; ++j)
+        {
+            axes[6 + i * 3 + j] = one.GetAxis(i) ^ two.GetAxis(j);
+        }
+    }
+
+    for (auto i = 0u; i < 15; ++i)
+    {
+        if (!TryAxis(one, two, axes[i], toCentre, i, pen, index))
+        {
+            return false;
+        }
+    }
+
+    auto axis = axes[index];
+
+    axis.Normalize();
+
+    // Face box two away from box one.
+    if ((axis | toCentre) > 0)
+    {
+        axis *= -1.f;
+    }
+
+    *best = index;
+
+    *normal = axis;
+
+    *penetration = pen;
+
+    return true;
+}
+
+void MakeBoxPairs(const unsigned pairs, std::vector<RigidBody>* bodies, std::vector<CollisionBox>* boxes)
+{
+    Random random(123);
+
+    bodies->assign(pairs * 2, RigidBody());
+
+    boxes->assign(pairs * 2, CollisionBox());
+
+    for (auto i = 0u; i < pairs * 2; ++i)
+    {
+        auto& body = (*bodies)[i];
+
+        body.SetPosition(random.RandomVector(Vector3(-2.f, -2.f, -2.f), Vector3(2.f, 2.f, 2.f)));
+
+        // Boxes lined up, and nearly lined up, are where the faces and
+        // edges tie, so plenty of both are mixed in.
+        auto orientation = random.RandomQuaternion();
+
+        if (i % 7 == 0)
+        {
+            orientation = Quaternion();
+        }
+        else if (i % 11 == 0)
+        {
+            orientation = Quaternion(0.f, 0.f, random.RandomReal(-0.1f, 0.1f), 1.f);
+
+            orientation.Normalize();
+        }
+
+        body.SetOrientation(orientation);
+
+        body.CalculateDerivedData();
+
+        auto& box = (*boxes)[i];
+
+        box.body = &body;
+
+        box.halfSize = random.RandomVector(Vector3(0.2f, 0.2f, 0.2f), Vector3(1.5f, 1.5f, 1.5f));
+
+        box.CalculateInternals();
+    }
+}
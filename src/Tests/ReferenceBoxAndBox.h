@@ -0,0 +1,31 @@
+#pragma once
+
+#include "cyclone/RigidBody/FineCollision/CollisionBox.h"
+#include <vector>
+
+/**
+ * The number of random pairs of boxes the box checks are run over.
+ */
+constexpr unsigned BoxPairs = 100000;
+
+/**
+ * The separating axis test CollisionDetector::BoxAndBox used before its
+ * axes were worked out with SIMD, kept as the reference the current one
+ * is checked against. It tries the 15 axes one at a time, and keeps the
+ * first with the least overlap.
+ *
+ * Returns false if the boxes are apart. Otherwise writes the index of
+ * the axis it picked, numbered as in BoxAndBox, the normal along it,
+ * facing from box two towards box one, and how far the boxes overlap
+ * along it, and returns true.
+ */
+bool ReferenceBoxAndBox(const cyclone::CollisionBox& one, const cyclone::CollisionBox& two, unsigned* best,
+                        cyclone::Vector3* normal, cyclone::real* penetration);
+
+/**
+ * Sets up the given number of random pairs of boxes, the two of each
+ * pair next to each other, and each box with a body of its own. The
+ * boxes are the same on every run, so each check that uses them sees
+ * the same pairs.
+ */
+void MakeBoxPairs(unsigned pairs, std::vector<cyclone::RigidBody>* bodies, std::vector<cyclone::CollisionBox>* boxes);
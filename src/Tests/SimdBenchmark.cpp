@@ -0,0 +1,314 @@
+#include "Tests.h"
+#include "ReferenceBoxAndBox.h"
+#include "cyclone/Core/Matrix.h"
+#include "cyclone/Core/Matrix3x4.h"
+#include "cyclone/Core/Quaternion.h"
+#include "cyclone/Core/Random.h"
+#include "cyclone/RigidBody/FineCollision/CollisionDetector.h"
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+using namespace cyclone;
+
+namespace
+{
+    /**
+    * The number of inputs each operation is run over per pass.
+    */
+    constexpr unsigned Inputs = 1024;
+
+    /**
+    * The number of passes timed over the inputs in each round.
+    */
+    constexpr unsigned Passes = 400;
+
+    /**
+    * The number of rounds timed. The fastest is kept, so a round slowed
+    * by the rest of the machine doesn't count against either side.
+    */
+    constexpr unsigned Rounds = 10;
+
+#if defined(CYCLONE_SIMD_SCALAR)
+    /**
+    * Whether the matrix products and the box axes use SIMD on this
+    * build.
+    */
+    constexpr bool bMatrixKernels = false;
+#else
+    constexpr bool bMatrixKernels = true;
+#endif
+
+#if defined(CYCLONE_SIMD_SCALAR_VECTOR3)
+    /**
+    * Whether the kernels on a single Vector3 use SIMD on this build.
+    */
+    constexpr bool bVectorKernels = false;
+#else
+    constexpr bool bVectorKernels = true;
+#endif
+
+    /*
+    * The scalar code the SIMD versions replaced, kept to time them
+    * against. Each works in the same order, so the results must match
+    * to the bit.
+    */
+    Matrix ScalarProduct(const Matrix& one, const Matrix& two)
+    {
+        // The old code started from the default matrix, whose last
+        // element is one, so it is started from zero here instead.
+        Matrix result(0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f);
+
+        for (auto k = 0; k < 4; ++k)
+        {
+            for (auto i = 0; i < 4; ++i)
+            {
+                for (auto j = 0; j < 4; ++j)
+                {
+                    result.M[i][k] += one.M[i][j] * two.M[j][k];
+                }
+            }
+        }
+
+        return result;
+    }
+
+    Vector3 ScalarInverseTransformVector(const Matrix3x4& m, const Vector3& v)
+    {
+        return Vector3(v.x * m.M[0][0] + v.y * m.M[1][0] + v.z * m.M[2][0],
+                       v.x * m.M[0][1] + v.y * m.M[1][1] + v.z * m.M[2][1],
+                       v.x * m.M[0][2] + v.y * m.M[1][2] + v.z * m.M[2][2]);
+    }
+
+    Vector3 ScalarRotateVector(const Quaternion& q, const Vector3& v)
+    {
+        const Vector3 u(q.i, q.j, q.k);
+
+        const auto t = 2.f * Vector3::CrossProduct(u, v);
+
+        return v + q.a * t + Vector3::CrossProduct(u, t);
+    }
+
+    /**
+    * Runs the calls the given number of times, and returns the time
+    * taken per call in nanoseconds, in the fastest round.
+    */
+    template <typename Calls>
+    double Fastest(const unsigned long long count, const Calls& calls)
+    {
+        auto fastest = 0.0;
+
+        for (auto round = 0u; round < Rounds; ++round)
+        {
+            const auto start = std::chrono::steady_clock::now();
+
+            calls();
+
+            const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+            if (round == 0 || elapsed.count() < fastest)
+            {
+                fastest = elapsed.count();
+            }
+        }
+
+        return fastest / static_cast<double>(count);
+    }
+
+    /**
+    * Runs the operation over every input for each pass, and returns the
+    * time taken per call in nanoseconds, in the fastest round. Each pass
+    * pairs the inputs up differently, so no pass can be skipped as a
+    * repeat of the last.
+    */
+    template <typename Operation>
+    double Time(const Operation& operation)
+    {
+        return Fastest(static_cast<unsigned long long>(Passes) * Inputs, [&]()
+        {
+            for (auto pass = 0u; pass < Passes; ++pass)
+            {
+                for (auto i = 0u; i < Inputs; ++i)
+                {
+                    operation(i, (i + pass) % Inputs);
+                }
+            }
+        });
+    }
+
+    bool Same(const Matrix& one, const Matrix& two)
+    {
+        for (auto row = 0; row < 4; ++row)
+        {
+            for (auto column = 0; column < 4; ++column)
+            {
+                if (one.M[row][column] != two.M[row][column])
+                {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    bool Same(const Vector3& one, const Vector3& two)
+    {
+        return one.x == two.x && one.y == two.y && one.z == two.z;
+    }
+
+    bool Same(const unsigned one, const unsigned two)
+    {
+        return one == two;
+    }
+
+    /**
+    * Prints the two timings, and returns whether both gave the same
+    * results and, where the library's code must be the faster on this
+    * build, whether it was.
+    */
+    template <typename Result>
+    bool Report(const char* name, const bool bSimd, const bool bFaster, const double scalar, const double simd,
+                const std::vector<Result>& one, const std::vector<Result>& two)
+    {
+        auto bSame = true;
+
+        for (auto i = 0u; i < one.size(); ++i)
+        {
+            bSame &= Same(one[i], two[i]);
+        }
+
+        const auto bPassed = bSame && (!bFaster || simd < scalar);
+
+        printf("SIMD benchmark: %s: %.2f ns old scalar, %.2f ns %s %s\n", name, scalar, simd,
+               bSimd ? "SIMD" : "library, no SIMD on this build,", bPassed ? "ok" : "FAILED");
+
+        return bPassed;
+    }
+}
+
+bool RunSimdBenchmark()
+{
+    Random random(456);
+
+    std::vector<Matrix> matrices(Inputs);
+
+    std::vector<Matrix3x4> transforms(Inputs);
+
+    std::vector<Quaternion> rotations(Inputs);
+
+    std::vector<Vector3> vectors(Inputs);
+
+    for (auto i = 0u; i < Inputs; ++i)
+    {
+        for (auto row = 0; row < 4; ++row)
+        {
+            for (auto column = 0; column < 4; ++column)
+            {
+                matrices[i].M[row][column] = random.RandomReal(-1.f, 1.f);
+
+                if (row < 3)
+                {
+                    transforms[i].M[row][column] = random.RandomReal(-1.f, 1.f);
+                }
+            }
+        }
+
+        rotations[i] = random.RandomQuaternion();
+
+        vectors[i] = random.RandomVector(10.f);
+    }
+
+    auto bPassed = true;
+
+    std::vector<Matrix> scalarProducts(Inputs), simdProducts(Inputs);
+
+    const auto scalarProduct = Time([&](const unsigned i, const unsigned j)
+    {
+        scalarProducts[i] = ScalarProduct(matrices[i], matrices[j]);
+    });
+
+    const auto simdProduct = Time([&](const unsigned i, const unsigned j)
+    {
+        simdProducts[i] = matrices[i] * matrices[j];
+    });
+
+    bPassed &= Report("Matrix product", bMatrixKernels, bMatrixKernels, scalarProduct, simdProduct, scalarProducts,
+                      simdProducts);
+
+    std::vector<Vector3> scalarVectors(Inputs), simdVectors(Inputs);
+
+    const auto scalarInverse = Time([&](const unsigned i, const unsigned j)
+    {
+        scalarVectors[i] = ScalarInverseTransformVector(transforms[i], vectors[j]);
+    });
+
+    const auto simdInverse = Time([&](const unsigned i, const unsigned j)
+    {
+        simdVectors[i] = transforms[i].InverseTransformVector(vectors[j]);
+    });
+
+    bPassed &= Report("Matrix3x4 InverseTransformVector", bVectorKernels, bVectorKernels, scalarInverse, simdInverse,
+                      scalarVectors, simdVectors);
+
+    const auto scalarRotate = Time([&](const unsigned i, const unsigned j)
+    {
+        scalarVectors[i] = ScalarRotateVector(rotations[i], vectors[j]);
+    });
+
+    const auto simdRotate = Time([&](const unsigned i, const unsigned j)
+    {
+        simdVectors[i] = rotations[i].RotateVector(vectors[j]);
+    });
+
+    bPassed &= Report("Quaternion RotateVector", bVectorKernels, bVectorKernels, scalarRotate, simdRotate,
+                      scalarVectors, simdVectors);
+
+    // The box test is timed over the pairs of the fuzz test. The old one
+    // only finds the axis while the new one writes the contacts as well,
+    // so the new one has to win with that against it. Working out all
+    // the axes together wins even without SIMD, so it must be the faster
+    // on every build.
+    std::vector<RigidBody> bodies;
+
+    std::vector<CollisionBox> boxes;
+
+    MakeBoxPairs(BoxPairs, &bodies, &boxes);
+
+    std::vector<unsigned> scalarTouching(BoxPairs), simdTouching(BoxPairs);
+
+    const auto scalarBoxes = Fastest(BoxPairs, [&]()
+    {
+        unsigned best;
+
+        Vector3 normal;
+
+        real penetration;
+
+        for (auto i = 0u; i < BoxPairs; ++i)
+        {
+            scalarTouching[i] = ReferenceBoxAndBox(boxes[i * 2], boxes[i * 2 + 1], &best, &normal, &penetration);
+        }
+    });
+
+    const auto simdBoxes = Fastest(BoxPairs, [&]()
+    {
+        Contact contacts[4];
+
+        CollisionData data;
+
+        data.contactHead = contacts;
+
+        for (auto i = 0u; i < BoxPairs; ++i)
+        {
+            data.Reset(4);
+
+            simdTouching[i] = CollisionDetector::BoxAndBox(boxes[i * 2], boxes[i * 2 + 1], &data) > 0;
+        }
+    });
+
+    bPassed &= Report("CollisionDetector BoxAndBox", bMatrixKernels, true, scalarBoxes, simdBoxes, scalarTouching,
+                      simdTouching);
+
+    return bPassed;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+/**
+ * @file
+ *
+ * Holds the checks run by the console test target. Each check prints
+ * what it found and returns whether it passed.
+ */
+
+/**
+ * Runs the Explosion and Fracture scenes on a world at one, two, four
+ * and eight threads, and checks that every run ends in the same state.
+ */
+bool RunDeterminismTest();
+
+/**
+ * Runs BoxAndBox on random pairs of boxes, and checks that it finds the
+ * same contact normal and depth as the reference separating axis test.
+ */
+bool RunBoxAndBoxFuzz();
+
+/**
+ * Times the SIMD matrix and quaternion operations against the scalar
+ * code they replaced, and checks that both give the same results and
+ * that the SIMD code is the faster wherever this build uses it. Also
+ * times BoxAndBox against the reference test on the pairs of the fuzz
+ * test, and checks that it finds the same pairs touching and is the
+ * faster on every build.
+ */
+bool RunSimdBenchmark();
@@ -0,0 +1,20 @@
+#include "Tests.h"
+#include <cstdio>
+
+/**
+ * Runs every check in turn, and returns zero only if they all pass.
+ */
+int main()
+{
+    auto bPassed = true;
+
+    bPassed &= RunDeterminismTest();
+
+    bPassed &= RunBoxAndBoxFuzz();
+
+    bPassed &= RunSimdBenchmark();
+
+    printf(bPassed ? "All tests passed.\n" : "Some tests failed.\n");
+
+    return bPassed ? 0 : 1;
+}
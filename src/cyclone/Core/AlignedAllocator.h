@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+namespace cyclone
+{
+    /**
+    * An allocator for the standard containers that places every
+    * allocation on the given alignment, so arrays of reals start on a
+    * cache line and can be loaded with aligned vector instructions.
+    */
+    template <class T, std::size_t Alignment>
+    class AlignedAllocator
+    {
+    public:
+        typedef T value_type;
+
+        template <class U>
+        struct rebind
+        {
+            typedef AlignedAllocator<U, Alignment> other;
+        };
+
+    public:
+        AlignedAllocator() = default;
+
+        template <class U>
+        AlignedAllocator(const AlignedAllocator<U, Alignment>&)
+        {
+        }
+
+        /**
+        * Allocates room for the given number of objects. The block is
+        * over-allocated and the pointer rounded up to the alignment by
+        * hand, with the start of the block kept just before it, since
+        * aligned operator new needs C++17.
+        */
+        T* allocate(std::size_t count)
+        {
+            const auto block = static_cast<char*>(::operator new(count * sizeof(T) + sizeof(void*) + Alignment - 1));
+
+            const auto address = reinterpret_cast<std::uintptr_t>(block + sizeof(void*));
+
+            const auto aligned = reinterpret_cast<void**>((address + Alignment - 1) & ~std::uintptr_t(Alignment - 1));
+
+            aligned[-1] = block;
+
+            return reinterpret_cast<T*>(aligned);
+        }
+
+        /**
+        * Releases memory returned by allocate.
+        */
+        void deallocate(T* pointer, std::size_t)
+        {
+            ::operator delete(reinterpret_cast<void**>(pointer)[-1]);
+        }
+
+        template <class U>
+        bool operator==(const AlignedAllocator<U, Alignment>&) const
+        {
+            return true;
+        }
+
+        template <class U>
+        bool operator!=(const AlignedAllocator<U, Alignment>&) const
+        {
+            return false;
+        }
+    };
+}
@@ -1,8 +1,14 @@
 #pragma once
 
 #include "Precision.h"
+#include "AlignedAllocator.h"
+#include "Simd.h"
 #include "Vector3.h"
 #include "Vector4.h"
 #include "Matrix.h"
+#include "Matrix3.h"
+#include "Matrix3x4.h"
 #include "Quaternion.h"
 #include "Random.h"
+#include "ThreadPool.h"
+#include "TaskGraph.h"
@@ -0,0 +1,165 @@
+#pragma once
+
+#include "Precision.h"
+#include "Matrix3.h"
+#include "Vector3.h"
+
+namespace cyclone
+{
+    /**
+    * 3x4 matrix of floating point values, holding a rotation and a
+    * translation. It is a 4x4 transform whose last row is implicitly
+    * (0, 0, 0, 1), so the row isn't stored.
+    * Matrix elements are accessed with M[RowIndex][ColumnIndex], and
+    * the translation is held in the last column.
+    *
+    * Each row is four contiguous reals, so the inverse transforms below
+    * are carried out on whole rows at a time in SIMD lanes.
+    */
+    class Matrix3x4
+    {
+    public:
+        /**
+        * Holds the transform matrix data in array form.
+        */
+        real M[3][4];
+
+    public:
+        /**
+        * The default constructor creates the identity transform.
+        */
+        Matrix3x4();
+
+        /**
+        * Constructors.
+        */
+        Matrix3x4(real x0, real x1, real x2, real x3,
+                  real y0, real y1, real y2, real y3,
+                  real z0, real z1, real z2, real z3);
+
+        /**
+        * Constructs a transform from a rotation and a translation.
+        */
+        Matrix3x4(const Matrix3& rotation, const Vector3& translation);
+
+        /**
+        * Set this to the identity matrix
+        */
+        void SetIdentity();
+
+        /**
+        * Gets the result of applying a transform, then this one.
+        */
+        Matrix3x4 operator*(const Matrix3x4& m) const;
+
+        /**
+        * Multiply this by a matrix.
+        */
+        void operator*=(const Matrix3x4& m);
+
+        /**
+        * Checks whether two matrix are identical.
+        */
+        bool operator==(const Matrix3x4& m) const;
+
+        /**
+        * Checks whether another Matrix3x4 is not equal to this.
+        */
+        bool operator!=(const Matrix3x4& m) const;
+
+        /**
+        * Transform the given vector by this matrix.
+        */
+        Vector3 operator*(const Vector3& v) const;
+
+        /**
+        * Transform a direction vector.
+        */
+        Vector3 TransformVector(const Vector3& v) const;
+
+        /**
+        * Transform a direction vector by the inverse of this matrix,
+        * assuming the rotation is orthonormal.
+        */
+        Vector3 InverseTransformVector(const Vector3& v) const;
+
+        /**
+        * Transform a location - will take into
+        * account translation part of the Matrix.
+        */
+        Vector3 TransformPosition(const Vector3& v) const;
+
+        /**
+        * Transform a location by the inverse of this matrix,
+        * assuming the rotation is orthonormal.
+        */
+        Vector3 InverseTransformPosition(const Vector3& v) const;
+
+        /**
+        * Gets the rotation part of the transform.
+        */
+        Matrix3 GetRotation() const;
+
+        /**
+        * Gets the translation part of the transform.
+        */
+        Vector3 GetTranslation() const;
+
+        /**
+        * Return determinant of the rotation part of this matrix.
+        */
+        real Determinant() const;
+
+        /**
+        * Returns a new matrix containing the inverse of this matrix,
+        * or the identity if it has none.
+        */
+        Matrix3x4 Inverse() const;
+    };
+
+    inline Vector3 Matrix3x4::operator*(const Vector3& v) const
+    {
+        return TransformPosition(v);
+    }
+
+    inline Vector3 Matrix3x4::TransformVector(const Vector3& v) const
+    {
+        // Each component is a dot product with a row, and summing the
+        // lanes across costs what multiplying them together saves, so the
+        // forward transforms stay scalar.
+        return Vector3(v.x * M[0][0] + v.y * M[0][1] + v.z * M[0][2],
+                       v.x * M[1][0] + v.y * M[1][1] + v.z * M[1][2],
+                       v.x * M[2][0] + v.y * M[2][1] + v.z * M[2][2]);
+    }
+
+    inline Vector3 Matrix3x4::InverseTransformVector(const Vector3& v) const
+    {
+#if defined(CYCLONE_SIMD_SCALAR_VECTOR3)
+        return Vector3(v.x * M[0][0] + v.y * M[1][0] + v.z * M[2][0],
+                       v.x * M[0][1] + v.y * M[1][1] + v.z * M[2][1],
+                       v.x * M[0][2] + v.y * M[1][2] + v.z * M[2][2]);
+#else
+        // The transpose of the rotation is applied by weighting its rows.
+        auto result = simd::Mul(simd::Splat(v.x), simd::Load(M[0]));
+
+        result = simd::Add(result, simd::Mul(simd::Splat(v.y), simd::Load(M[1])));
+
+        result = simd::Add(result, simd::Mul(simd::Splat(v.z), simd::Load(M[2])));
+
+        return Vector3::Store(result);
+#endif
+    }
+
+    inline Vector3 Matrix3x4::TransformPosition(const Vector3& v) const
+    {
+        return Vector3(v.x * M[0][0] + v.y * M[0][1] + v.z * M[0][2] + M[0][3],
+                       v.x * M[1][0] + v.y * M[1][1] + v.z * M[1][2] + M[1][3],
+                       v.x * M[2][0] + v.y * M[2][1] + v.z * M[2][2] + M[2][3]);
+    }
+
+    inline Vector3 Matrix3x4::InverseTransformPosition(const Vector3& v) const
+    {
+        // Remove the translation, then apply the transpose of the rotation.
+        return InverseTransformVector(Vector3(v.x - M[0][3], v.y - M[1][3], v.z - M[2][3]));
+    }
+}
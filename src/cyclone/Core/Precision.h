@@ -8,13 +8,19 @@
 * in the source code or headers. This file provides defines for
 * the real number type and mathematical formulae that work on it.
 *
-* @note All the contents of this file need to be changed to compile
-* Cyclone at a different precision.
+* Cyclone is built in double precision by default. Defining
+* CYCLONE_SINGLE_PRECISION for every translation unit (the project's
+* CyclonePrecision=Single property does this) builds it in single
+* precision instead. Code and clients must agree on the choice, as it
+* changes the layout of every class.
 */
 
+#include <cfloat>
+#include <cmath>
+
 namespace cyclone
 {
-#if false
+#if defined(CYCLONE_SINGLE_PRECISION)
     /**
     * Defines we're in single precision mode, for any code
     * that needs to be conditionally compiled.
@@ -23,7 +29,7 @@ namespace cyclone
 
     /**
     * Defines a real number precision. Cyclone can be compiled in
-    * single or double precision versions. By default single precision is
+    * single or double precision versions. By default double precision is
     * provided.
     */
     typedef float real;
@@ -32,25 +38,31 @@ namespace cyclone
     #define REAL_MAX FLT_MAX
 
     /** Defines the precision of the square root operator. */
-    #define real_sqrt std::sqrtf
+    #define real_sqrt std::sqrt
 
     /** Defines the precision of the absolute magnitude operator. */
-    #define real_abs std::fabsf
+    #define real_abs std::fabs
 
     /** Defines the precision of the sine operator. */
-    #define real_sin std::sinf
+    #define real_sin std::sin
 
     /** Defines the precision of the cosine operator. */
-    #define real_cos std::cosf
-    
+    #define real_cos std::cos
+
+    /** Defines the precision of the arc sine operator. */
+    #define real_asin std::asin
+
+    /** Defines the precision of the two argument arc tangent operator. */
+    #define real_atan2 std::atan2
+
     /** Defines the precision of the exponent operator. */
-    #define real_exp std::expf
+    #define real_exp std::exp
 
     /** Defines the precision of the power operator. */
-    #define real_pow std::powf
+    #define real_pow std::pow
 
     /** Defines the precision of the floating point modulo operator. */
-    #define real_fmod std::fmodf
+    #define real_fmod std::fmod
 
     /** Defines the number e on which 1+e == 1 **/
     #define real_epsilon FLT_EPSILON
@@ -65,7 +77,7 @@ namespace cyclone
 
     /**
     * Defines a real number precision. Cyclone can be compiled in
-    * single or double precision versions. By default single precision is
+    * single or double precision versions. By default double precision is
     * provided.
     */
     typedef double real;
@@ -85,6 +97,12 @@ namespace cyclone
     /** Defines the precision of the cosine operator. */
 #define real_cos std::cos
 
+    /** Defines the precision of the arc sine operator. */
+#define real_asin std::asin
+
+    /** Defines the precision of the two argument arc tangent operator. */
+#define real_atan2 std::atan2
+
     /** Defines the precision of the exponent operator. */
 #define real_exp std::exp
 
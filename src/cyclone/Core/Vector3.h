@@ -1,12 +1,17 @@
 #pragma once
 
 #include "Precision.h"
+#include "Simd.h"
 
 namespace cyclone
 {
     /**
     * Holds a vector in 3 dimensions. Four data members are allocated
-    * to ensure alignment in an array.
+    * to ensure alignment in an array, and so the vector can be loaded
+    * into a single set of SIMD lanes.
+    *
+    * The constructors and the arithmetic used in the inner loops are
+    * defined inline at the end of this file.
     */
     class Vector3
     {
@@ -237,5 +242,131 @@ namespace cyclone
         * component by a value).
         */
         friend Vector3 operator*(real s, const Vector3& u);
+
+        /**
+        * Loads the vector into a set of SIMD lanes, with zero in the last.
+        */
+        simd::Lanes Load() const;
+
+        /**
+        * Creates a vector from the first three of a set of SIMD lanes.
+        */
+        static Vector3 Store(const simd::Lanes& lanes);
     };
-};
+
+    inline Vector3::Vector3(): x(0.f), y(0.f), z(0.f), pad(0.f)
+    {
+    }
+
+    inline Vector3::Vector3(const real v) : x(v), y(v), z(v), pad(0.f)
+    {
+    }
+
+    inline Vector3::Vector3(const real x, const real y, const real z) : x(x), y(y), z(z), pad(0.f)
+    {
+    }
+
+    inline Vector3::Vector3(const Vector3& v): x(v.x), y(v.y), z(v.z), pad(0.f)
+    {
+    }
+
+    inline simd::Lanes Vector3::Load() const
+    {
+        // The padding is always zero, so it can be loaded along with the
+        // components.
+        return simd::Load(&x);
+    }
+
+    inline Vector3 Vector3::Store(const simd::Lanes& lanes)
+    {
+        alignas(32) real values[4];
+
+        simd::Store(values, lanes);
+
+        return Vector3(values[0], values[1], values[2]);
+    }
+
+    inline Vector3 Vector3::operator^(const Vector3& v) const
+    {
+        return Vector3(y * v.z - z * v.y,
+                       z * v.x - x * v.z,
+                       x * v.y - y * v.x);
+    }
+
+    inline Vector3 Vector3::CrossProduct(const Vector3& a, const Vector3& b)
+    {
+        return a ^ b;
+    }
+
+    inline real Vector3::operator|(const Vector3& v) const
+    {
+        return x * v.x + y * v.y + z * v.z;
+    }
+
+    inline real Vector3::DotProduct(const Vector3& a, const Vector3& b)
+    {
+        return a | b;
+    }
+
+    inline Vector3 Vector3::operator+(const Vector3& v) const
+    {
+        return Vector3(x + v.x, y + v.y, z + v.z);
+    }
+
+    inline Vector3 Vector3::operator-(const Vector3& v) const
+    {
+        return Vector3(x - v.x, y - v.y, z - v.z);
+    }
+
+    inline Vector3 Vector3::operator*(const real scale) const
+    {
+        return Vector3(x * scale, y * scale, z * scale);
+    }
+
+    inline Vector3 Vector3::operator*(const Vector3& v) const
+    {
+        return Vector3(x * v.x, y * v.y, z * v.z);
+    }
+
+    inline Vector3 Vector3::operator-() const
+    {
+        return Vector3(-x, -y, -z);
+    }
+
+    inline void Vector3::operator+=(const Vector3& v)
+    {
+        x += v.x;
+
+        y += v.y;
+
+        z += v.z;
+    }
+
+    inline void Vector3::operator-=(const Vector3& v)
+    {
+        x -= v.x;
+
+        y -= v.y;
+
+        z -= v.z;
+    }
+
+    inline void Vector3::operator*=(const real scale)
+    {
+        x *= scale;
+
+        y *= scale;
+
+        z *= scale;
+    }
+
+    inline real Vector3::SizeSquared() const
+    {
+        return x * x + y * y + z * z;
+    }
+
+    inline Vector3 operator*(const real s, const Vector3& u)
+    {
+        return Vector3(u.x * s, u.y * s, u.z * s);
+    }
+}
@@ -17,6 +17,9 @@ namespace cyclone
         /** Applies the buoyancy force to the given particle. */
         void UpdateForce(Particle* particle, real deltaTime) override;
 
+        /** Applies the buoyancy force to each of the given particles. */
+        void UpdateForces(Particle* const* particles, unsigned count, real deltaTime) override;
+
     protected:
         /**
         * The maximum submersion depth of the object before
@@ -22,5 +22,15 @@ namespace cyclone
         * and update the force applied to the given particle.
         */
         virtual void UpdateForce(Particle* particle, real deltaTime) = 0;
+
+        /**
+        * Calculates and updates the forces applied to a run of
+        * particles. By default this calls UpdateForce for each of them.
+        * Generators applying the same force to many particles can
+        * override it with a tight loop. The registry may call it for
+        * different runs of particles on different threads at the same
+        * time.
+        */
+        virtual void UpdateForces(Particle* const* particles, unsigned count, real deltaTime);
     };
 }
@@ -17,6 +17,9 @@ namespace cyclone
         /** Applies the gravitational force to the given particle. */
         void UpdateForce(Particle* particle, real deltaTime) override;
 
+        /** Applies the gravitational force to each of the given particles. */
+        void UpdateForces(Particle* const* particles, unsigned count, real deltaTime) override;
+
     protected:
         /** Holds the acceleration due to gravity. */
         Vector3 gravity;
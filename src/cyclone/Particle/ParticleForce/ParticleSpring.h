@@ -17,6 +17,9 @@ namespace cyclone
         /** Applies the spring force to the given particle. */
         void UpdateForce(Particle* particle, real duration) override;
 
+        /** Applies the spring force to each of the given particles. */
+        void UpdateForces(Particle* const* particles, unsigned count, real duration) override;
+
     protected:
         /** The particle at the other end of the spring. */
         Particle* other;
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <vector>
+#include "Core/AlignedAllocator.h"
+#include "Core/ThreadPool.h"
+#include "Particle.h"
+
+namespace cyclone
+{
+    /**
+    * Holds the state of many particles as a structure of arrays: one
+    * array per component, each starting on a 64 byte boundary. Integrating
+    * the set walks each array in order with no branches, which lets the
+    * compiler vectorize the loop.
+    *
+    * The set is the storage for its particles: they are added to it and
+    * read back from it, rather than copied in and out of Particle objects
+    * each frame.
+    */
+    class ParticleSet
+    {
+    public:
+        typedef std::vector<real, AlignedAllocator<real, 64>> Reals;
+
+        /**
+        * The number of particles integrated as one job when the set is
+        * integrated on a thread pool. A multiple of the alignment keeps
+        * each job's arrays aligned.
+        */
+        static constexpr unsigned ParticlesPerJob = 1024;
+
+    public:
+        /**
+        * Adds a particle with the state of the given one and returns
+        * its index.
+        */
+        unsigned Add(const Particle& particle);
+
+        /**
+        * Sets the number of particles. New particles are immovable and
+        * at rest at the origin.
+        */
+        void Resize(unsigned count);
+
+        /**
+        * Removes every particle.
+        */
+        void Clear();
+
+        /**
+        * Returns the number of particles.
+        */
+        unsigned Size() const;
+
+        /**
+        * Copies the state of the given particle into the given index.
+        */
+        void Load(unsigned index, const Particle& particle);
+
+        /**
+        * Integrates every particle forward in time by the given amount,
+        * in the same way as Particle::Integrate. Runs of particles are
+        * spread over the thread pool if one is given, giving the same
+        * result as integrating them in one go.
+        */
+        void Integrate(real deltaTime, ThreadPool* threadPool = nullptr);
+
+        /**
+        * Adds the given force to the particle at the given index.
+        */
+        void AddForce(unsigned index, const Vector3& force);
+
+        /**
+        * Clears the forces applied to every particle.
+        */
+        void ClearAccumulators();
+
+        /**
+        * Returns the position of the particle at the given index.
+        */
+        Vector3 GetPosition(unsigned index) const;
+
+        /**
+        * Returns the velocity of the particle at the given index.
+        */
+        Vector3 GetVelocity(unsigned index) const;
+
+    public:
+        /**
+        * @name Component Arrays
+        *
+        * Each component of the particles' state, indexed by particle.
+        */
+        /*@{*/
+
+        Reals positionX;
+
+        Reals positionY;
+
+        Reals positionZ;
+
+        Reals velocityX;
+
+        Reals velocityY;
+
+        Reals velocityZ;
+
+        Reals accelerationX;
+
+        Reals accelerationY;
+
+        Reals accelerationZ;
+
+        Reals forceX;
+
+        Reals forceY;
+
+        Reals forceZ;
+
+        Reals inverseMass;
+
+        Reals damping;
+
+        /*@}*/
+
+    protected:
+        /**
+        * Integrates the particles from the first index up to, but not
+        * including, the last.
+        */
+        void IntegrateRange(unsigned first, unsigned last, real deltaTime);
+
+    protected:
+        /**
+        * Holds one for each particle that can move and zero for the
+        * immovable ones.
+        */
+        Reals moving;
+
+        /**
+        * Holds the damping of each particle raised to the power of the
+        * duration being integrated, or one if it can't move.
+        */
+        Reals dampingFactor;
+    };
+}
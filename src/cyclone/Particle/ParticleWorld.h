@@ -11,6 +11,7 @@
 #include "Particle.h"
 #include "ParticleContact/ParticleContactGenerator.h"
 #include "ParticleContact/ParticleContactResolver.h"
+#include "ParticleContact/ParticleGrid.h"
 #include "ParticleForce/ParticleForceRegistry.h"
 
 namespace cyclone
@@ -26,6 +27,12 @@ namespace cyclone
 
         typedef std::vector<ParticleContactGenerator*> ContactGenerators;
 
+        /**
+        * The number of particles integrated as one job when the world
+        * is integrated on a thread pool.
+        */
+        static constexpr unsigned ParticlesPerJob = 256;
+
     public:
         /**
         * Creates a new particle simulator that can handle up to the
@@ -42,14 +49,24 @@ namespace cyclone
         ~ParticleWorld();
 
         /**
-        * Calls each of the registered contact generators to report
-        * their contacts. Returns the number of generated contacts.
+        * Sets the thread pool the forces are updated and the particles
+        * integrated on, or NULL to run on the calling thread. The pool is
+        * not owned by the world.
+        */
+        void SetThreadPool(ThreadPool* threadPool);
+
+        /**
+        * Collides the particles with each other using the particle grid,
+        * if it has been initialized, then calls each of the registered
+        * contact generators to report their contacts. Returns the number
+        * of generated contacts.
         */
         unsigned GenerateContacts();
 
         /**
         * Integrates all the particles in this world forward in time
-        * by the given deltaTime.
+        * by the given deltaTime, spread over the thread pool if there
+        * is one.
         */
         void Integrate(real deltaTime);
 
@@ -81,6 +98,12 @@ namespace cyclone
         */
         ParticleForceRegistry& GetForceRegistry();
 
+        /**
+        * Returns the grid used to collide the particles with each other.
+        * It does nothing until it is initialized.
+        */
+        ParticleGrid& GetGrid();
+
     protected:
         /**
         * Holds the particles
@@ -108,6 +131,11 @@ namespace cyclone
         */
         ContactGenerators contactGenerators;
 
+        /**
+        * Holds the built in generator for contacts between particles.
+        */
+        ParticleGrid grid;
+
         /**
         * Holds the list of contacts.
         */
@@ -118,5 +146,11 @@ namespace cyclone
         * size of the contacts array).
         */
         unsigned maxContacts;
+
+        /**
+        * Holds the thread pool the forces are updated and the particles
+        * integrated on, or NULL.
+        */
+        ThreadPool* threadPool;
     };
 }
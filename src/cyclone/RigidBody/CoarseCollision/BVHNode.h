@@ -1,9 +1,15 @@
 #pragma once
 
+#include <vector>
 #include "RigidBody/RigidBody.h"
 
 namespace cyclone
 {
+    /*
+    * Forward declaration, the primitives are only referred to here.
+    */
+    class CollisionPrimitive;
+
     /**
     * Stores a potential contact to check later.
     */
@@ -13,12 +19,18 @@ namespace cyclone
         * Holds the bodies that might be in contact.
         */
         RigidBody* body[2];
+
+        /**
+        * Holds the primitives that might be in contact, so the fine
+        * collision detector can be run on them directly. These are
+        * NULL when the coarse phase only knows about the bodies.
+        */
+        CollisionPrimitive* primitive[2];
     };
 
     /**
-    * A base class for nodes in a bounding volume hierarchy.
-    *
-    * This class uses a binary tree to store the bounding volumes.
+    * A node in a bounding volume hierarchy. Nodes are stored in the
+    * array of a BVHTree and refer to each other by index.
     */
     template <class BoundingVolumeClass>
     class BVHNode
@@ -27,96 +39,152 @@ namespace cyclone
         /**
         * Creates a new node in the hierarchy with the given parameters.
         */
-        BVHNode(BVHNode* parent, const BoundingVolumeClass& volume, RigidBody* body = nullptr);
+        BVHNode(unsigned parent, const BoundingVolumeClass& volume, RigidBody* body = nullptr);
 
         /**
         * Checks if this node is at the bottom of the hierarchy.
         */
         bool IsLeaf() const;
 
+    public:
         /**
-        * Checks the potential contacts from this node downwards in
-        * the hierarchy, writing them to the given array (up to the
-        * given limit). Returns the number of potential contacts it
-        * found.
+        * Holds the child nodes of this node.
         */
-        unsigned GetPotentialContacts(PotentialContact* contacts, unsigned limit) const;
+        unsigned children[2];
+
+        /**
+        * Holds a single bounding volume encompassing all the
+        * descendents of this node.
+        */
+        BoundingVolumeClass volume;
+
+        /**
+        * Holds the rigid body at this node of the hierarchy.
+        * Only leaf nodes can have a rigid body defined (see isLeaf).
+        */
+        RigidBody* body;
+
+        /**
+        * Holds the node immediately above us in the tree, or the next
+        * free node while this node is unused.
+        */
+        unsigned parent;
+    };
+
+    /**
+    * A bounding volume hierarchy, using a binary tree to store the
+    * bounding volumes.
+    *
+    * The nodes are allocated from a single array and linked by index,
+    * so inserting and removing bodies reuses the array instead of going
+    * to the heap. The index of a leaf stays the same until it is removed.
+    */
+    template <class BoundingVolumeClass>
+    class BVHTree
+    {
+    public:
+        typedef BVHNode<BoundingVolumeClass> Node;
+
+        /**
+        * Marks a missing node.
+        */
+        static constexpr unsigned NullNode = 0xffffffff;
+
+    public:
+        /**
+        * Creates an empty hierarchy.
+        */
+        BVHTree();
 
         /**
         * Inserts the given rigid body, with the given bounding volume,
-        * into the hierarchy. This may involve the creation of
-        * further bounding volume nodes.
+        * into the hierarchy. Returns the index of the new leaf.
         */
-        void Insert(RigidBody* newBody, const BoundingVolumeClass& newVolume);
+        unsigned Insert(RigidBody* newBody, const BoundingVolumeClass& newVolume);
 
         /**
-        * Deletes this node, removing it first from the hierarchy, along with its
-        * associated rigid body and child nodes. This method deletes the node
-        * and all its children (but obviously not the rigid bodies). This
-        * also has the effect of deleting the sibling of this node, and
-        * changing the parent node so that it contains the data currently
-        * in that sibling. Finally it forces the hierarchy above the
-        * current node to reconsider its bounding volume.
+        * Removes the given leaf from the hierarchy. Its sibling takes the
+        * place of their parent, and the hierarchy above reconsiders its
+        * bounding volume.
         */
-        ~BVHNode();
+        void Remove(unsigned leaf);
+
+        /**
+        * Checks the potential contacts between all the bodies in the
+        * hierarchy, writing them to the given array (up to the given
+        * limit). Returns the number of potential contacts it found.
+        */
+        unsigned GetPotentialContacts(PotentialContact* contacts, unsigned limit) const;
+
+        /**
+        * Removes every body from the hierarchy, keeping the storage.
+        */
+        void Clear();
+
+        /**
+        * Returns the root of the hierarchy, NullNode when it is empty.
+        */
+        unsigned GetRoot() const;
+
+        /**
+        * Returns the node with the given index.
+        */
+        const Node& GetNode(unsigned index) const;
 
     protected:
+        /**
+        * Takes a node from the free list, or adds one to the array.
+        */
+        unsigned AllocateNode(unsigned parent, const BoundingVolumeClass& volume, RigidBody* body = nullptr);
+
+        /**
+        * Returns a node to the free list.
+        */
+        void FreeNode(unsigned index);
+
         /**
         * Checks for overlapping between nodes in the hierarchy. Note
         * that any bounding volume should have an overlaps method implemented
         * that checks for overlapping with another object of its own type.
         */
-        bool Overlay(const BVHNode<BoundingVolumeClass>* other) const;
+        bool Overlay(unsigned one, unsigned other) const;
 
         /**
-        * Checks the potential contacts between this node and the given
-        * other node, writing them to the given array (up to the
-        * given limit). Returns the number of potential contacts it
-        * found.
+        * Checks the potential contacts between the two given nodes,
+        * writing them to the given array (up to the given limit).
+        * Returns the number of potential contacts it found.
         */
-        unsigned GetPotentialContactsWith(const BVHNode<BoundingVolumeClass>* other, PotentialContact* contacts,
+        unsigned GetPotentialContactsWith(unsigned one, unsigned other, PotentialContact* contacts,
                                           unsigned limit) const;
 
         /**
-        * For non-leaf nodes, this method recalculates the bounding volume
-        * based on the bounding volumes of its children.
-        */
-        void RecalculateBoundingVolume(bool recurse = true);
-
-    public:
-        /**
-        * Holds the child nodes of this node.
+        * Recalculates the bounding volume of the given node and of every
+        * node above it, based on the bounding volumes of their children.
         */
-        BVHNode* children[2];
+        void RecalculateBoundingVolume(unsigned index);
 
+    protected:
         /**
-        * Holds a single bounding volume encompassing all the
-        * descendents of this node.
+        * Holds every node, in use or free.
         */
-        BoundingVolumeClass volume;
+        std::vector<Node> nodes;
 
         /**
-        * Holds the rigid body at this node of the hierarchy.
-        * Only leaf nodes can have a rigid body defined (see isLeaf).
-        * Note that it is possible to rewrite the algorithms in this
-        * class to handle objects at all levels of the hierarchy,
-        * but the code provided ignores this vector unless firstChild
-        * is NULL.
+        * Holds the top of the hierarchy.
         */
-        RigidBody* body;
+        unsigned root;
 
         /**
-        * Holds the node immediately above us in the tree.
+        * Holds the first node of the free list.
         */
-        BVHNode* parent;
+        unsigned freeList;
     };
 
     template <class BoundingVolumeClass>
-    BVHNode<BoundingVolumeClass
-    >::BVHNode(BVHNode* parent, const BoundingVolumeClass& volume, RigidBody* body): volume(volume), body(body),
-        parent(parent)
+    BVHNode<BoundingVolumeClass>::BVHNode(const unsigned parent, const BoundingVolumeClass& volume, RigidBody* body):
+        volume(volume), body(body), parent(parent)
     {
-        children[0] = children[1] = nullptr;
+        children[0] = children[1] = BVHTree<BoundingVolumeClass>::NullNode;
     }
 
     template <class BoundingVolumeClass>
@@ -126,137 +194,226 @@ namespace cyclone
     }
 
     template <class BoundingVolumeClass>
-    unsigned BVHNode<BoundingVolumeClass>::GetPotentialContacts(PotentialContact* contacts, unsigned limit) const
+    BVHTree<BoundingVolumeClass>::BVHTree(): root(NullNode), freeList(NullNode)
     {
-        // Early out if we don't have the room for contacts, or if we're a leaf node.
-        if (IsLeaf() || limit == 0)
-        {
-            return 0;
-        }
-
-        // Get the potential contacts of one of our children with the other
-        return children[0]->GetPotentialContactsWith(children[1], contacts, limit);
     }
 
     template <class BoundingVolumeClass>
-    void BVHNode<BoundingVolumeClass>::Insert(RigidBody* newBody, const BoundingVolumeClass& newVolume)
+    unsigned BVHTree<BoundingVolumeClass>::Insert(RigidBody* newBody, const BoundingVolumeClass& newVolume)
     {
-        // If we are a leaf, then the only option is to spawn two
-        // new children and place the new body in one.
-        if (IsLeaf())
+        if (root == NullNode)
         {
-            // Child one is a copy of us.
-            children[0] = new BVHNode<BoundingVolumeClass>(this, volume, body);
+            root = AllocateNode(NullNode, newVolume, newBody);
 
-            // Child two holds the new body
-            children[1] = new BVHNode<BoundingVolumeClass>(this, newVolume, newBody);
+            return root;
+        }
 
-            // And we now loose the body (we're no longer a leaf)
-            this->body = nullptr;
+        // Work out which leaf gets to share its place with the inserted
+        // body. At each branch we give it to whoever would grow the least
+        // to incorporate it.
+        auto sibling = root;
 
-            // We need to recalculate our bounding volume
-            RecalculateBoundingVolume();
-        }
-        else
+        while (!nodes[sibling].IsLeaf())
         {
-            // Otherwise we need to work out which child gets to keep
-            // the inserted body. We give it to whoever would grow the
-            // least to incorporate it.
-            if (children[0]->volume.GetGrowth(newVolume) < children[1]->volume.GetGrowth(newVolume))
+            const auto& node = nodes[sibling];
+
+            if (nodes[node.children[0]].volume.GetGrowth(newVolume) <
+                nodes[node.children[1]].volume.GetGrowth(newVolume))
             {
-                children[0]->Insert(newBody, newVolume);
+                sibling = node.children[0];
             }
             else
             {
-                children[1]->Insert(newBody, newVolume);
+                sibling = node.children[1];
             }
         }
+
+        // Spawn a branch in the place of the sibling, holding the sibling
+        // as its first child and the new body as its second.
+        const auto parent = nodes[sibling].parent;
+
+        const auto branch = AllocateNode(parent, BoundingVolumeClass(nodes[sibling].volume, newVolume));
+
+        const auto leaf = AllocateNode(branch, newVolume, newBody);
+
+        nodes[branch].children[0] = sibling;
+
+        nodes[branch].children[1] = leaf;
+
+        nodes[sibling].parent = branch;
+
+        if (parent == NullNode)
+        {
+            root = branch;
+        }
+        else
+        {
+            auto& node = nodes[parent];
+
+            node.children[node.children[0] == sibling ? 0 : 1] = branch;
+
+            RecalculateBoundingVolume(parent);
+        }
+
+        return leaf;
     }
 
     template <class BoundingVolumeClass>
-    BVHNode<BoundingVolumeClass>::~BVHNode()
+    void BVHTree<BoundingVolumeClass>::Remove(const unsigned leaf)
     {
+        const auto parent = nodes[leaf].parent;
+
+        FreeNode(leaf);
+
         // If we don't have a parent, then we ignore the sibling processing
-        if (parent)
+        if (parent == NullNode)
         {
-            // Find our sibling
-            BVHNode<BoundingVolumeClass>* sibling;
+            root = NullNode;
 
-            if (parent->children[0] == this)
-            {
-                sibling = parent->children[1];
-            }
-            else
-            {
-                sibling = parent->children[0];
-            }
+            return;
+        }
 
-            // Write its data to our parent
-            parent->volume = sibling->volume;
+        // Our sibling moves up to take the place of our parent
+        const auto sibling = nodes[parent].children[nodes[parent].children[0] == leaf ? 1 : 0];
 
-            parent->body = sibling->body;
+        const auto grandParent = nodes[parent].parent;
 
-            parent->children[0] = sibling->children[0];
+        nodes[sibling].parent = grandParent;
 
-            parent->children[1] = sibling->children[1];
+        FreeNode(parent);
 
-            // Delete the sibling (we blank its parent and
-            // children to avoid processing/deleting them)
-            sibling->parent = nullptr;
+        if (grandParent == NullNode)
+        {
+            root = sibling;
 
-            sibling->body = nullptr;
+            return;
+        }
 
-            sibling->children[0] = nullptr;
+        auto& node = nodes[grandParent];
 
-            sibling->children[1] = nullptr;
+        node.children[node.children[0] == parent ? 0 : 1] = sibling;
 
-            delete sibling;
+        // Recalculate the bounding volumes above the sibling
+        RecalculateBoundingVolume(grandParent);
+    }
 
-            // Recalculate the parent's bounding volume
-            parent->RecalculateBoundingVolume();
+    template <class BoundingVolumeClass>
+    unsigned BVHTree<BoundingVolumeClass>::GetPotentialContacts(PotentialContact* contacts, const unsigned limit) const
+    {
+        if (contacts == nullptr)
+        {
+            return 0;
         }
 
-        // Delete our children (again we remove their
-        // parent data so we don't try to process their siblings
-        // as they are deleted).
-        if (children[0])
+        auto count = 0u;
+
+        // Every pair of bodies meets at exactly one branch, so checking
+        // the children of each branch against each other finds them all.
+        for (const auto& node : nodes)
         {
-            children[0]->parent = nullptr;
+            if (count >= limit)
+            {
+                break;
+            }
 
-            delete children[0];
+            if (node.IsLeaf() || node.children[0] == NullNode)
+            {
+                continue;
+            }
+
+            count += GetPotentialContactsWith(node.children[0], node.children[1], contacts + count, limit - count);
         }
 
-        if (children[1])
+        return count;
+    }
+
+    template <class BoundingVolumeClass>
+    void BVHTree<BoundingVolumeClass>::Clear()
+    {
+        nodes.clear();
+
+        root = NullNode;
+
+        freeList = NullNode;
+    }
+
+    template <class BoundingVolumeClass>
+    unsigned BVHTree<BoundingVolumeClass>::GetRoot() const
+    {
+        return root;
+    }
+
+    template <class BoundingVolumeClass>
+    const BVHNode<BoundingVolumeClass>& BVHTree<BoundingVolumeClass>::GetNode(const unsigned index) const
+    {
+        return nodes[index];
+    }
+
+    template <class BoundingVolumeClass>
+    unsigned BVHTree<BoundingVolumeClass>::AllocateNode(const unsigned parent, const BoundingVolumeClass& volume,
+                                                        RigidBody* body)
+    {
+        if (freeList == NullNode)
         {
-            children[1]->parent = nullptr;
+            nodes.emplace_back(parent, volume, body);
 
-            delete children[1];
+            return static_cast<unsigned>(nodes.size() - 1);
         }
+
+        const auto index = freeList;
+
+        freeList = nodes[index].parent;
+
+        nodes[index] = Node(parent, volume, body);
+
+        return index;
+    }
+
+    template <class BoundingVolumeClass>
+    void BVHTree<BoundingVolumeClass>::FreeNode(const unsigned index)
+    {
+        auto& node = nodes[index];
+
+        // Free nodes are neither leaves nor branches
+        node.body = nullptr;
+
+        node.children[0] = node.children[1] = NullNode;
+
+        node.parent = freeList;
+
+        freeList = index;
     }
 
     template <class BoundingVolumeClass>
-    bool BVHNode<BoundingVolumeClass>::Overlay(const BVHNode<BoundingVolumeClass>* other) const
+    bool BVHTree<BoundingVolumeClass>::Overlay(const unsigned one, const unsigned other) const
     {
-        return other != nullptr && volume->Overlay(other->volume);
+        return nodes[one].volume.Overlaps(nodes[other].volume);
     }
 
     template <class BoundingVolumeClass>
-    unsigned BVHNode<BoundingVolumeClass>::GetPotentialContactsWith(const BVHNode<BoundingVolumeClass>* other,
-                                                                    PotentialContact* contacts, unsigned limit) const
+    unsigned BVHTree<BoundingVolumeClass>::GetPotentialContactsWith(const unsigned one, const unsigned other,
+                                                                    PotentialContact* contacts,
+                                                                    const unsigned limit) const
     {
         // Early out if we don't overlap or if we have no room
         // to report contacts
-        if (other == nullptr || contacts == nullptr || !Overlay(other) || limit == 0)
+        if (limit == 0 || !Overlay(one, other))
         {
             return 0;
         }
 
+        const auto& first = nodes[one];
+
+        const auto& second = nodes[other];
+
         // If we're both at leaf nodes, then we have a potential contact
-        if (IsLeaf() && other->IsLeaf())
+        if (first.IsLeaf() && second.IsLeaf())
         {
-            contacts->body[0] = body;
+            contacts->body[0] = first.body;
+
+            contacts->body[1] = second.body;
 
-            contacts->body[1] = other->body;
+            contacts->primitive[0] = contacts->primitive[1] = nullptr;
 
             return 1;
         }
@@ -264,53 +421,31 @@ namespace cyclone
         // Determine which node to descend into. If either is
         // a leaf, then we descend the other. If both are branches,
         // then we use the one with the largest size.
-        if (other->IsLeaf() || !IsLeaf() && volume->Size() >= other->volume->Size())
+        if (second.IsLeaf() || (!first.IsLeaf() && first.volume.Size() >= second.volume.Size()))
         {
-            // Recurse into ourself
-            auto count = children[0]->GetPotentialContactsWith(other, contacts, limit);
+            // Recurse into the first node
+            const auto count = GetPotentialContactsWith(first.children[0], other, contacts, limit);
 
-            // Check we have enough slots to do the other side too
-            if (limit > count)
-            {
-                return count + children[1]->GetPotentialContactsWith(other, contacts + count, limit - count);
-            }
-            else
-            {
-                return count;
-            }
+            return count + GetPotentialContactsWith(first.children[1], other, contacts + count, limit - count);
         }
-        else
-        {
-            // Recurse into the other node
-            auto count = GetPotentialContactsWith(other->children[0], contacts, limit);
 
-            // Check we have enough slots to do the other side too
-            if (limit > count)
-            {
-                return count + GetPotentialContactsWith(other->children[1], contacts + count, limit - count);
-            }
-            else
-            {
-                return count;
-            }
-        }
+        // Recurse into the other node
+        const auto count = GetPotentialContactsWith(one, second.children[0], contacts, limit);
+
+        return count + GetPotentialContactsWith(one, second.children[1], contacts + count, limit - count);
     }
 
     template <class BoundingVolumeClass>
-    void BVHNode<BoundingVolumeClass>::RecalculateBoundingVolume(bool recurse)
+    void BVHTree<BoundingVolumeClass>::RecalculateBoundingVolume(unsigned index)
     {
-        if (IsLeaf())
+        // Walk up the tree using the bounding volume combining constructor.
+        while (index != NullNode)
         {
-            return;
-        }
+            auto& node = nodes[index];
 
-        // Use the bounding volume combining constructor.
-        volume = BoundingVolumeClass(children[0]->volume, children[1]->volume);
+            node.volume = BoundingVolumeClass(nodes[node.children[0]].volume, nodes[node.children[1]].volume);
 
-        // Recurse up the tree
-        if (parent != nullptr)
-        {
-            parent->RecalculateBoundingVolume(true);
+            index = node.parent;
         }
     }
 }
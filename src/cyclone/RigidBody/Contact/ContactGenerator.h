@@ -10,6 +10,9 @@ namespace cyclone
     */
     class ContactGenerator
     {
+    public:
+        virtual ~ContactGenerator() = default;
+
         /**
         * Fills the given contact structure with the generated
         * contact. The contact pointer should point to the first
@@ -11,6 +11,12 @@ namespace cyclone
     */
     class CollisionPlane : public CollisionPrimitive
     {
+    public:
+        /**
+        * Creates a new plane.
+        */
+        CollisionPlane();
+
     public:
         /**
         * The plane normal
@@ -4,6 +4,17 @@
 
 namespace cyclone
 {
+    /**
+    * Identifies the concrete class of a collision primitive, so code
+    * holding a CollisionPrimitive pointer can pick the right detector.
+    */
+    enum class PrimitiveType : unsigned char
+    {
+        Box,
+        Sphere,
+        Plane
+    };
+
     /**
     * Represents a primitive to detect collisions against.
     */
@@ -11,7 +22,19 @@ namespace cyclone
     {
     public:
         /**
-        * Calculates the internals for the primitive.
+        * Creates a primitive of the given concrete type.
+        */
+        explicit CollisionPrimitive(PrimitiveType type);
+
+        /**
+        * Returns the concrete type of this primitive.
+        */
+        PrimitiveType GetType() const;
+
+        /**
+        * Calculates the internals for the primitive. A primitive without
+        * a body is placed by its offset alone, so it can be set up on its
+        * own as the shape of a query.
         */
         void CalculateInternals();
 
@@ -27,7 +50,7 @@ namespace cyclone
         * (orientation + position) of the rigid body to which it is
         * attached.
         */
-        const Matrix& GetTransform() const;
+        const Matrix3x4& GetTransform() const;
 
     public:
         /**
@@ -38,7 +61,7 @@ namespace cyclone
         /**
         * The offset of this primitive from the given rigid body.
         */
-        Matrix offset;
+        Matrix3x4 offset;
 
     protected:
         /**
@@ -46,7 +69,12 @@ namespace cyclone
         * calculated by combining the offset of the primitive
         * with the transform of the rigid body.
         */
-        Matrix transform;
+        Matrix3x4 transform;
+
+        /**
+        * The concrete type of this primitive.
+        */
+        PrimitiveType type;
 
     private:
         /**
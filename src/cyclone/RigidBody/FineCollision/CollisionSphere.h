@@ -10,6 +10,12 @@ namespace cyclone
     */
     class CollisionSphere : public CollisionPrimitive
     {
+    public:
+        /**
+        * Creates a new sphere.
+        */
+        CollisionSphere();
+
     public:
         /**
         * The radius of the sphere.
@@ -22,5 +22,14 @@ namespace cyclone
         * and update the force applied to the given rigid body.
         */
         virtual void UpdateForce(RigidBody* body, real deltaTime) = 0;
+
+        /**
+        * Calculates and updates the forces applied to a run of bodies.
+        * By default this calls UpdateForce for each of them. Generators
+        * applying the same force to many bodies can override it with a
+        * tight loop. The registry may call it for different runs of
+        * bodies on different threads at the same time.
+        */
+        virtual void UpdateForces(RigidBody* const* bodies, unsigned count, real deltaTime);
     };
 }
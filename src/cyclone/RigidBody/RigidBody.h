@@ -75,6 +75,15 @@ namespace cyclone
         */
         void Integrate(real deltaTime);
 
+        /**
+        * Integrates the awake bodies among the given bodies, picked out
+        * by the given indices, forward in time by the given amount. The
+        * damping factors are worked out once for each distinct damping
+        * the bodies use, rather than once per body, and each body is
+        * then brought up to date in a single pass.
+        */
+        static void IntegrateBodies(RigidBody* bodies, const unsigned* indices, unsigned count, real deltaTime);
+
         /*@}*/
 
         /**
@@ -150,7 +159,7 @@ namespace cyclone
         * function should be called before trying to get any settings
         * from the rigid body.
         */
-        void SetInertiaTensor(const Matrix& inertiaTensor);
+        void SetInertiaTensor(const Matrix3& inertiaTensor);
 
         /**
         * Copies the current inertia tensor of the rigid body into
@@ -160,7 +169,7 @@ namespace cyclone
         * current inertia tensor of the rigid body. The inertia
         * tensor is expressed in the rigid body's local space.
         */
-        void GetInertiaTensor(Matrix* inertiaTensor) const;
+        void GetInertiaTensor(Matrix3* inertiaTensor) const;
 
         /**
         * Gets a copy of the current inertia tensor of the rigid body.
@@ -169,7 +178,7 @@ namespace cyclone
         * tensor. The inertia tensor is expressed in the rigid body's
         * local space.
         */
-        Matrix GetInertiaTensor() const;
+        Matrix3 GetInertiaTensor() const;
 
         /**
         * Copies the current inertia tensor of the rigid body into
@@ -179,7 +188,7 @@ namespace cyclone
         * current inertia tensor of the rigid body. The inertia
         * tensor is expressed in world space.
         */
-        void GetInertiaTensorWorld(Matrix* inertiaTensor) const;
+        void GetInertiaTensorWorld(Matrix3* inertiaTensor) const;
 
         /**
         * Gets a copy of the current inertia tensor of the rigid body.
@@ -187,7 +196,7 @@ namespace cyclone
         * @return A new matrix containing the current inertia
         * tensor. The inertia tensor is expressed in world space.
         */
-        Matrix GetInertiaTensorWorld() const;
+        Matrix3 GetInertiaTensorWorld() const;
 
         /**
         * Sets the inverse inertia tensor for the rigid body.
@@ -201,7 +210,7 @@ namespace cyclone
         * function should be called before trying to get any settings
         * from the rigid body.
         */
-        void SetInverseInertiaTensor(const Matrix& inverseInertiaTensor);
+        void SetInverseInertiaTensor(const Matrix3& inverseInertiaTensor);
 
         /**
         * Copies the current inverse inertia tensor of the rigid body
@@ -212,7 +221,7 @@ namespace cyclone
         * inertia tensor is expressed in the rigid body's local
         * space.
         */
-        void GetInverseInertiaTensor(Matrix* inverseInertiaTensor) const;
+        void GetInverseInertiaTensor(Matrix3* inverseInertiaTensor) const;
 
         /**
         * Gets a copy of the current inverse inertia tensor of the
@@ -222,7 +231,7 @@ namespace cyclone
         * inertia tensor. The inertia tensor is expressed in the
         * rigid body's local space.
         */
-        Matrix GetInverseInertiaTensor() const;
+        Matrix3 GetInverseInertiaTensor() const;
 
         /**
         * Copies the current inverse inertia tensor of the rigid body
@@ -232,7 +241,7 @@ namespace cyclone
         * the current inverse inertia tensor of the rigid body. The
         * inertia tensor is expressed in world space.
         */
-        void GetInverseInertiaTensorWorld(Matrix* inverseInertiaTensor) const;
+        void GetInverseInertiaTensorWorld(Matrix3* inverseInertiaTensor) const;
 
         /**
         * Gets a copy of the current inverse inertia tensor of the
@@ -242,7 +251,7 @@ namespace cyclone
         * inertia tensor. The inertia tensor is expressed in world
         * space.
         */
-        Matrix GetInverseInertiaTensorWorld() const;
+        Matrix3 GetInverseInertiaTensorWorld() const;
 
         /**
         * Sets both linear and angular damping in one function call.
@@ -387,7 +396,7 @@ namespace cyclone
          *
          * @param matrix A pointer to the matrix to fill.
          */
-        void GetOrientation(Matrix* matrix) const;
+        void GetOrientation(Matrix3* matrix) const;
 
         /**
         * Fills the given matrix with a transformation representing
@@ -398,7 +407,7 @@ namespace cyclone
         *
         * @param transform A pointer to the matrix to fill.
         */
-        void GetTransform(Matrix* transform) const;
+        void GetTransform(Matrix3x4* transform) const;
 
         /**
         * Fills the given matrix data structure with a
@@ -423,7 +432,7 @@ namespace cyclone
         *
         * @return The transform matrix for the rigid body.
         */
-        Matrix GetTransform() const;
+        Matrix3x4 GetTransform() const;
 
         /**
         * Converts the given point from world space into the body's
@@ -595,6 +604,17 @@ namespace cyclone
         */
         void SetCanSleep(bool canSleep = true);
 
+        /**
+        * Returns the recency weighted mean of the body's motion, which
+        * puts it to sleep once it falls below the sleep epsilon.
+        */
+        real GetMotion() const;
+
+        /**
+        * Returns the motion below which bodies are put to sleep.
+        */
+        static real GetSleepEpsilon();
+
         /*@}*/
 
         /**
@@ -733,17 +753,27 @@ namespace cyclone
         /*@}*/
 
     private:
+        /**
+        * Integrates the body with the given damping factors, already
+        * raised to the power of the time step, and the given weight of
+        * the old motion in the recency weighted mean. The orientation
+        * is updated, normalized and turned into the transform matrix and
+        * world inertia tensor in one go, without building quaternions
+        * along the way.
+        */
+        void Integrate(real deltaTime, real linearDampingFactor, real angularDampingFactor, real motionBias);
+
         /**
         * Creates a transform matrix from a position and orientation.
         */
-        static void CalculateTransformMatrix(Matrix& transformMatrix, const Vector3& position,
+        static void CalculateTransformMatrix(Matrix3x4& transformMatrix, const Vector3& position,
                                              const Quaternion& orientation);
 
         /**
         * Creates an inertia tensor transform.
         */
-        static void TransformInertiaTensor(Matrix& inverseInertiaTensorWorld, const Matrix& inverseInertiaTensorLocal,
-                                           const Matrix& transformMatrix);
+        static void TransformInertiaTensor(Matrix3& inverseInertiaTensorWorld, const Matrix3& inverseInertiaTensorLocal,
+                                           const Matrix3x4& transformMatrix);
 
     protected:
         /**
@@ -804,7 +834,7 @@ namespace cyclone
         *
         * @see inverseMass
         */
-        Matrix inverseInertiaTensor;
+        Matrix3 inverseInertiaTensor;
 
         /**
         * Holds the amount of damping applied to linear
@@ -861,7 +891,7 @@ namespace cyclone
         *
         * @see inverseInertiaTensor
         */
-        Matrix inverseInertiaTensorWorld;
+        Matrix3 inverseInertiaTensorWorld;
 
         /**
         * Holds the amount of motion of the body. This is a recency
@@ -892,7 +922,7 @@ namespace cyclone
         * @see getPointInWorldSpace
         * @see getTransform
         */
-        Matrix transformMatrix;
+        Matrix3x4 transformMatrix;
 
         /*@}*/
 